@@ -0,0 +1,283 @@
+#include "BondedPort.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <iostream>
+
+BondedPort::BondedPort() {
+}
+
+BondedPort::~BondedPort() {
+    close();
+}
+
+void BondedPort::addPort(SerialPort& port, const std::string& portName, int weight) {
+    auto member = std::make_unique<Member>();
+    member->port = &port;
+    member->name = portName;
+    member->weight = std::max(0, weight);
+    m_members.push_back(std::move(member));
+}
+
+bool BondedPort::open(const std::string& portName, int baudRate) {
+    if (m_isOpen) {
+        close();
+    }
+
+    m_portName = portName;
+    bool anyOpen = false;
+
+    for (auto& member : m_members) {
+        member->healthy = member->port->open(member->name, baudRate);
+        // не открывшийся порт не пробуется: запись в закрытый порт всегда неудачна
+        member->retryAt = Clock::time_point::max();
+        member->currentWeight = 0;
+        member->queue.clear();
+        member->partial.clear();
+        anyOpen = anyOpen || member->healthy;
+    }
+
+    if (!anyOpen) {
+        std::cerr << "Ни один порт объединения " << portName << " не открыт" << std::endl;
+        return false;
+    }
+
+    m_metrics = MetricsRegistry::getInstance().getPort(portName);
+    m_keepWriting = true;
+    for (auto& member : m_members) {
+        member->writer = std::thread(&BondedPort::writerThreadFunc, this, std::ref(*member));
+    }
+
+    m_isOpen = true;
+    return true;
+}
+
+void BondedPort::close() {
+    stopAsyncReading();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keepWriting = false;
+    }
+    m_unitQueued.notify_all();
+    m_spaceFreed.notify_all();
+
+    // потоки записи сначала передают то, что уже стоит в очередях
+    for (auto& member : m_members) {
+        if (member->writer.joinable()) {
+            member->writer.join();
+        }
+        member->port->close();
+        member->healthy = false;
+    }
+
+    m_isOpen = false;
+}
+
+BondedPort::Member* BondedPort::pickMember(Clock::time_point now) {
+    // плавный взвешенный перебор (как в nginx) среди портов, у которых есть место в очереди
+    Member* best = nullptr;
+    int totalWeight = 0;
+
+    for (auto& member : m_members) {
+        bool probe = !member->healthy && member->retryAt <= now && member->queue.empty();
+        if (!(member->healthy && member->queue.size() < BOND_MEMBER_QUEUE_UNITS) && !probe) {
+            continue;
+        }
+
+        int weight = member->weight ? member->weight : member->port->getBaudRate();
+        member->currentWeight += weight;
+        totalWeight += weight;
+        if (!best || member->currentWeight > best->currentWeight) {
+            best = member.get();
+        }
+    }
+
+    if (best) {
+        best->currentWeight -= totalWeight;
+        if (!best->healthy) {
+            best->retryAt = now + std::chrono::milliseconds(BOND_RETRY_INTERVAL_MS);
+        }
+    }
+    return best;
+}
+
+bool BondedPort::writeData(const char* data, size_t length) {
+    if (!m_isOpen) return false;
+
+    TRACE_SCOPE_ARG("bondWrite", length);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_keepWriting) {
+        Member* member = pickMember(Clock::now());
+        if (member) {
+            member->queue.emplace_back(data, length);
+            m_unitQueued.notify_all();
+            return true;
+        }
+
+        bool anyHealthy = std::any_of(m_members.begin(), m_members.end(),
+                                      [](const std::unique_ptr<Member>& m) { return m->healthy; });
+        if (!anyHealthy) {
+            return false;
+        }
+        m_spaceFreed.wait(lock);
+    }
+    return false;
+}
+
+// вызывается под m_mutex
+void BondedPort::markFailed(Member& member, std::string&& unit) {
+    member.failures++;
+    member.retryAt = Clock::now() + std::chrono::milliseconds(BOND_RETRY_INTERVAL_MS);
+    if (member.healthy) {
+        member.healthy = false;
+        std::cerr << "Порт " << member.name << " исключён из объединения " << m_portName << std::endl;
+    }
+
+    // неотправленное уходит в остальные порты, сверх их очередей - повтор важнее ожидания
+    member.queue.push_front(std::move(unit));
+    while (!member.queue.empty()) {
+        Member* target = nullptr;
+        for (auto& other : m_members) {
+            if (other->healthy && (!target || other->queue.size() < target->queue.size())) {
+                target = other.get();
+            }
+        }
+        if (!target) {
+            member.queue.clear();   // работающих портов не осталось
+            break;
+        }
+        target->queue.push_back(std::move(member.queue.front()));
+        member.queue.pop_front();
+    }
+
+    m_unitQueued.notify_all();
+    m_spaceFreed.notify_all();
+}
+
+void BondedPort::writerThreadFunc(Member& member) {
+    Tracer::setThreadName("bondWriter");
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        m_unitQueued.wait(lock, [&]() { return !member.queue.empty() || !m_keepWriting; });
+        if (member.queue.empty()) {
+            return;
+        }
+
+        std::string unit = std::move(member.queue.front());
+        member.queue.pop_front();
+        m_spaceFreed.notify_all();
+
+        lock.unlock();
+        bool success = member.port->writeData(unit);
+        lock.lock();
+
+        if (!success) {
+            markFailed(member, std::move(unit));
+            continue;
+        }
+
+        member.unitsWritten++;
+        if (!member.healthy) {
+            member.healthy = true;
+            std::cerr << "Порт " << member.name << " возвращён в объединение " << m_portName << std::endl;
+        }
+    }
+}
+
+bool BondedPort::startAsyncReading(const DataReadyCallback& callback) {
+    if (!m_isOpen) {
+        return false;
+    }
+
+    m_notifyPending = false;
+    m_dataCallback = callback;
+
+    bool started = false;
+    for (auto& member : m_members) {
+        if (!member->port->isOpen()) {
+            continue;
+        }
+        started = member->port->startAsyncReading([this]() {
+            if (!m_notifyPending.exchange(true) && m_dataCallback) {
+                m_dataCallback();
+            }
+        }) || started;
+    }
+    return started;
+}
+
+void BondedPort::stopAsyncReading() {
+    for (auto& member : m_members) {
+        member->port->stopAsyncReading();
+    }
+    m_dataCallback = nullptr;
+}
+
+size_t BondedPort::readReceived(std::string& out) {
+    m_notifyPending = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    const char delimiter = static_cast<char>(m_framing == FramingMode::Cobs ? COBS_DELIMITER : END_FLAG_BYTE);
+    size_t total = 0;
+
+    for (auto& member : m_members) {
+        std::string& partial = member->partial;
+        if (member->port->readReceived(partial) == 0) {
+            continue;
+        }
+
+        // кадры разных портов не перемешиваются: отдаём только до последнего разделителя
+        size_t last = partial.rfind(delimiter);
+        size_t length = last == std::string::npos ? 0 : last + 1;
+        if (length == 0 && partial.size() > BOND_MAX_PARTIAL_BYTES) {
+            length = partial.size();
+        }
+
+        out.append(partial, 0, length);
+        partial.erase(0, length);
+        total += length;
+    }
+
+    return total;
+}
+
+bool BondedPort::setBaudRate(int baudRate) {
+    if (!isOpen()) return false;
+
+    bool success = true;
+    for (auto& member : m_members) {
+        if (member->port->isOpen()) {
+            success = member->port->setBaudRate(baudRate) && success;
+        }
+    }
+    return success;
+}
+
+void BondedPort::setCaptureWriter(CaptureWriter* writer) {
+    for (auto& member : m_members) {
+        member->port->setCaptureWriter(writer);
+    }
+}
+
+int BondedPort::getBaudRate() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int total = 0;
+    for (const auto& member : m_members) {
+        if (member->healthy) {
+            total += member->port->getBaudRate();
+        }
+    }
+    return total;
+}
+
+std::vector<BondMemberStatus> BondedPort::getStatus() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<BondMemberStatus> status;
+    for (const auto& member : m_members) {
+        status.push_back({member->name, member->weight ? member->weight : member->port->getBaudRate(),
+                          member->healthy, member->unitsWritten, member->failures});
+    }
+    return status;
+}
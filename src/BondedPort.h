@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameManager.h"
+#include "Metrics.h"
+#include "SerialPort.h"
+
+#define BOND_MEMBER_QUEUE_UNITS 4       // записей в очереди одного порта; дальше writeData ждёт
+#define BOND_RETRY_INTERVAL_MS 1000     // через столько отказавший порт снова получает запись на пробу
+#define BOND_MAX_PARTIAL_BYTES (64 * 1024) // незавершённый кадр порта, после которого он отдаётся как есть
+
+struct BondMemberStatus {
+    std::string name;
+    int weight;
+    bool healthy;
+    uint64_t unitsWritten;
+    uint64_t failures;
+};
+
+// Объединение нескольких последовательных портов в один канал. Каждая запись
+// (кадр или группа кадров от TransmitWorker) целиком уходит в один порт:
+// порты выбираются взвешенным циклическим перебором (вес по умолчанию - скорость порта),
+// у каждого порта свой поток записи, поэтому линии передают одновременно.
+// Порт, запись в который не удалась, исключается из перебора, его записи уходят
+// в остальные порты, а через BOND_RETRY_INTERVAL_MS он получает запись на пробу.
+// На приёме байты каждого порта отдаются только целыми кадрами (до разделителя кадров),
+// а порядок кадров восстанавливает сборка сообщений в ReceivePipeline по sequence/total.
+// writeData возвращает, когда запись поставлена в очередь порта, поэтому эмуляция
+// CSMA/CD побайтно через объединение не работает.
+class BondedPort : public SerialPort {
+public:
+    BondedPort();
+    ~BondedPort() override;
+
+    // добавляется до open; weight 0 - по скорости порта
+    void addPort(SerialPort& port, const std::string& portName, int weight = 0);
+
+    // разделитель кадров на приёме; задаётся до startAsyncReading, как у ReceivePipeline
+    void setFramingMode(FramingMode framing) { m_framing = framing; }
+
+    // открывает все порты на baudRate; успешно, если открылся хотя бы один
+    bool open(const std::string& portName, int baudRate = 9600) override;
+    void close() override;
+    bool isOpen() const override { return m_isOpen; }
+
+    using SerialPort::writeData;
+    bool writeData(const char* data, size_t length) override;
+
+    bool startAsyncReading(const DataReadyCallback& callback = nullptr) override;
+    void stopAsyncReading() override;
+
+    size_t readReceived(std::string& out) override;
+
+    bool setBaudRate(int baudRate) override;
+
+    void setCaptureWriter(CaptureWriter* writer) override;
+    PortMetrics* getMetrics() const override { return m_metrics; }
+
+    std::string getPortName() const override { return m_portName; }
+    // суммарная скорость работающих портов
+    int getBaudRate() const override;
+
+    std::vector<BondMemberStatus> getStatus();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Member {
+        SerialPort* port;
+        std::string name;
+        int weight;
+        int currentWeight = 0;
+        bool healthy = false;
+        Clock::time_point retryAt;
+        std::deque<std::string> queue;
+        std::string partial;    // принятое после последнего разделителя (только потребитель)
+        std::thread writer;
+        uint64_t unitsWritten = 0;
+        uint64_t failures = 0;
+    };
+
+    Member* pickMember(Clock::time_point now);
+    void markFailed(Member& member, std::string&& unit);
+    void writerThreadFunc(Member& member);
+
+    std::vector<std::unique_ptr<Member>> m_members;
+    std::string m_portName;
+    FramingMode m_framing = FramingMode::Escaped;
+    std::atomic<bool> m_isOpen{false};
+
+    mutable std::mutex m_mutex;             // очереди, веса и состояние портов
+    std::condition_variable m_unitQueued;
+    std::condition_variable m_spaceFreed;
+    bool m_keepWriting = false;
+
+    std::atomic<bool> m_notifyPending{false};
+    DataReadyCallback m_dataCallback;
+    PortMetrics* m_metrics = nullptr;
+};
@@ -0,0 +1,47 @@
+#include "ByteRingBuffer.h"
+#include <algorithm>
+
+ByteRingBuffer::ByteRingBuffer(size_t capacity)
+    : m_buffer(new char[capacity])
+    , m_capacity(capacity)
+    , m_mask(capacity - 1) {
+}
+
+size_t ByteRingBuffer::writableRegion(char*& region) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t tail = m_tail.load(std::memory_order_acquire);
+
+    size_t freeSpace = m_capacity - (head - tail);
+    size_t offset = head & m_mask;
+
+    region = m_buffer.get() + offset;
+    return std::min(freeSpace, m_capacity - offset);
+}
+
+void ByteRingBuffer::commitWrite(size_t length) {
+    m_head.store(m_head.load(std::memory_order_relaxed) + length, std::memory_order_release);
+}
+
+size_t ByteRingBuffer::readableRegion(const char*& region) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t head = m_head.load(std::memory_order_acquire);
+
+    size_t used = head - tail;
+    size_t offset = tail & m_mask;
+
+    region = m_buffer.get() + offset;
+    return std::min(used, m_capacity - offset);
+}
+
+void ByteRingBuffer::commitRead(size_t length) {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + length, std::memory_order_release);
+}
+
+bool ByteRingBuffer::empty() const {
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+}
+
+void ByteRingBuffer::reset() {
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Кольцевой буфер байтов без блокировок для одного производителя и одного потребителя.
+// Производитель пишет прямо в свободную область буфера, потребитель читает прямо из занятой.
+class ByteRingBuffer {
+public:
+    explicit ByteRingBuffer(size_t capacity); // capacity - степень двойки
+
+    // сторона производителя
+    size_t writableRegion(char*& region);
+    void commitWrite(size_t length);
+
+    // сторона потребителя
+    size_t readableRegion(const char*& region);
+    void commitRead(size_t length);
+
+    size_t capacity() const { return m_capacity; }
+    bool empty() const;
+
+    // только когда ни производитель, ни потребитель не работают
+    void reset();
+
+private:
+    std::unique_ptr<char[]> m_buffer;
+    size_t m_capacity;
+    size_t m_mask;
+
+    alignas(64) std::atomic<size_t> m_head{0}; // позиция записи
+    alignas(64) std::atomic<size_t> m_tail{0}; // позиция чтения
+};
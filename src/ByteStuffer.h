@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Байт-стаффинг с таблицей классификации байтов, построенной при компиляции из констант
+// протокола. Запись без ветвлений: в выход всегда пишутся два байта (ESCAPE или сам байт,
+// затем байт ^ Mask), а позиция сдвигается на 1 или 2 - поэтому выходному буферу нужен
+// один байт запаса.
+template <uint8_t Start, uint8_t End, uint8_t Escape, uint8_t Mask, uint8_t... Extra>
+class ByteStuffer {
+public:
+    static constexpr bool needsEscape(uint8_t byte) { return ESCAPE_TABLE[byte] != 0; }
+
+    // максимальный размер выхода stuff для length входных байтов, с запасом
+    static constexpr size_t maxStuffedSize(size_t length) { return 2 * length + 1; }
+
+    static size_t stuff(const uint8_t* in, size_t length, char* out) {
+        size_t written = 0;
+        for (size_t i = 0; i < length; i++) {
+            written += stuffByte(in[i], out + written);
+        }
+        return written;
+    }
+
+    // для данных известной длины: цикл разворачивается полностью
+    template <size_t N>
+    static size_t stuffFixed(const uint8_t* in, char* out) {
+        return stuffUnrolled(in, out, std::make_index_sequence<N>());
+    }
+
+    static size_t stuffedSize(const uint8_t* in, size_t length) {
+        size_t size = length;
+        for (size_t i = 0; i < length; i++) {
+            size += ESCAPE_TABLE[in[i]];
+        }
+        return size;
+    }
+
+    // снятие стаффинга; out вмещает length байтов. Висящий в конце ESCAPE отбрасывается.
+    static size_t unstuff(const char* in, size_t length, uint8_t* out) {
+        size_t written = 0;
+        for (size_t i = 0; i < length; i++) {
+            uint8_t byte = static_cast<uint8_t>(in[i]);
+            if (byte == Escape) {
+                if (++i == length) {
+                    break;
+                }
+                byte = static_cast<uint8_t>(in[i]) ^ Mask;
+            }
+            out[written++] = byte;
+        }
+        return written;
+    }
+
+private:
+    static constexpr std::array<uint8_t, 256> makeEscapeTable() {
+        std::array<uint8_t, 256> table{};
+        for (uint8_t byte : {Start, End, Escape, Extra...}) {
+            table[byte] = 1;
+        }
+        return table;
+    }
+
+    static constexpr std::array<uint8_t, 256> ESCAPE_TABLE = makeEscapeTable();
+
+    static size_t stuffByte(uint8_t byte, char* out) {
+        size_t escaped = ESCAPE_TABLE[byte];
+        out[0] = static_cast<char>(escaped ? Escape : byte);
+        out[1] = static_cast<char>(byte ^ Mask);
+        return 1 + escaped;
+    }
+
+    template <size_t... I>
+    static size_t stuffUnrolled(const uint8_t* in, char* out, std::index_sequence<I...>) {
+        size_t written = 0;
+        ((written += stuffByte(in[I], out + written)), ...);
+        return written;
+    }
+};
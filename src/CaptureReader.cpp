@@ -0,0 +1,119 @@
+#include "CaptureReader.h"
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+bool CaptureReader::open(const std::string& fileName) {
+    close();
+
+#ifdef _WIN32
+    m_file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Ошибка открытия файла записи " << fileName << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart < CAPTURE_MAGIC_SIZE) {
+        std::cerr << "Файл записи пуст или повреждён: " << fileName << std::endl;
+        close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+
+    m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mapping != NULL) {
+        m_view = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    m_file = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_file < 0) {
+        std::cerr << "Ошибка открытия файла записи " << fileName << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(m_file, &info) != 0 || info.st_size < CAPTURE_MAGIC_SIZE) {
+        std::cerr << "Файл записи пуст или повреждён: " << fileName << std::endl;
+        close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(info.st_size);
+
+    void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+    if (view != MAP_FAILED) {
+        // записи читаются подряд от начала до конца
+        madvise(view, m_size, MADV_SEQUENTIAL);
+        m_view = static_cast<const char*>(view);
+    }
+#endif
+
+    if (m_view == nullptr || std::memcmp(m_view, CAPTURE_MAGIC, CAPTURE_MAGIC_SIZE) != 0) {
+        std::cerr << "Неверный формат файла записи: " << fileName << std::endl;
+        close();
+        return false;
+    }
+
+    m_position = CAPTURE_MAGIC_SIZE;
+    return true;
+}
+
+void CaptureReader::close() {
+#ifdef _WIN32
+    if (m_view) {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+    if (m_mapping != NULL) {
+        CloseHandle(m_mapping);
+        m_mapping = NULL;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (m_view) {
+        munmap(const_cast<char*>(m_view), m_size);
+        m_view = nullptr;
+    }
+    if (m_file >= 0) {
+        ::close(m_file);
+        m_file = -1;
+    }
+#endif
+    m_size = 0;
+    m_position = 0;
+}
+
+bool CaptureReader::next(CaptureRecord& record) {
+    if (!m_view || m_position + sizeof(CaptureRecordHeader) > m_size) {
+        return false;
+    }
+
+    CaptureRecordHeader header;
+    std::memcpy(&header, m_view + m_position, sizeof(header));
+
+    if (m_position + sizeof(header) + header.length > m_size) {
+        return false;
+    }
+
+    record.timestampNs = header.timestampNs;
+    record.direction = static_cast<CaptureDirection>(header.direction);
+    record.length = header.length;
+    record.data = m_view + m_position + sizeof(header);
+
+    m_position += sizeof(header) + header.length;
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <cstdint>
+#include <string>
+
+#include "CaptureWriter.h"
+
+struct CaptureRecord {
+    uint64_t timestampNs;
+    CaptureDirection direction;
+    const char* data;
+    uint32_t length;
+};
+
+// Чтение файла записи трафика через отображение в память, без копирования данных.
+class CaptureReader {
+public:
+    CaptureReader() {};
+    ~CaptureReader();
+
+    bool open(const std::string& fileName);
+    void close();
+
+    // false - записи закончились или файл повреждён
+    bool next(CaptureRecord& record);
+    void rewind() { m_position = CAPTURE_MAGIC_SIZE; }
+
+    uint64_t getFileSize() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = NULL;
+#else
+    int m_file = -1;
+#endif
+    const char* m_view = nullptr;
+    uint64_t m_size = 0;
+    uint64_t m_position = 0;
+};
@@ -0,0 +1,97 @@
+#include "CaptureWriter.h"
+#include <cstring>
+#include <iostream>
+
+CaptureWriter::CaptureWriter() {
+}
+
+CaptureWriter::~CaptureWriter() {
+    close();
+}
+
+bool CaptureWriter::open(const std::string& fileName) {
+    close();
+
+    m_file = std::fopen(fileName.c_str(), "wb");
+    if (!m_file) {
+        std::cerr << "Ошибка открытия файла записи " << fileName << std::endl;
+        return false;
+    }
+
+    std::fwrite(CAPTURE_MAGIC, 1, CAPTURE_MAGIC_SIZE, m_file);
+
+    m_startTime = std::chrono::steady_clock::now();
+    m_droppedBytes = 0;
+    m_activeBuffer.clear();
+    m_activeBuffer.reserve(CAPTURE_MAX_BUFFERED / 8);
+    m_keepWriting = true;
+    m_writerThread = std::thread(&CaptureWriter::writerThreadFunc, this);
+
+    m_isOpen = true;
+    return true;
+}
+
+void CaptureWriter::close() {
+    m_isOpen = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keepWriting = false;
+    }
+    m_condition.notify_one();
+
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void CaptureWriter::record(CaptureDirection direction, const char* data, size_t length) {
+    if (!m_isOpen || length == 0) {
+        return;
+    }
+
+    CaptureRecordHeader header = {};
+    header.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - m_startTime).count();
+    header.length = static_cast<uint32_t>(length);
+    header.direction = static_cast<uint8_t>(direction);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_activeBuffer.size() + sizeof(header) + length > CAPTURE_MAX_BUFFERED) {
+        // диск не успевает - не задерживаем приём и передачу, а считаем потери
+        m_droppedBytes += length;
+        return;
+    }
+
+    const char* headerBytes = reinterpret_cast<const char*>(&header);
+    m_activeBuffer.insert(m_activeBuffer.end(), headerBytes, headerBytes + sizeof(header));
+    m_activeBuffer.insert(m_activeBuffer.end(), data, data + length);
+}
+
+void CaptureWriter::writerThreadFunc() {
+    while (true) {
+        bool keepWriting;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait_for(lock, std::chrono::milliseconds(CAPTURE_FLUSH_INTERVAL_MS),
+                                 [this]() { return !m_keepWriting; });
+            keepWriting = m_keepWriting;
+            std::swap(m_activeBuffer, m_writeBuffer);
+        }
+
+        if (!m_writeBuffer.empty()) {
+            std::fwrite(m_writeBuffer.data(), 1, m_writeBuffer.size(), m_file);
+            std::fflush(m_file);
+            m_writeBuffer.clear();
+        }
+
+        if (!keepWriting) {
+            return;
+        }
+    }
+}
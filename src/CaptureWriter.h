@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CAPTURE_MAGIC "SLCAP001"
+#define CAPTURE_MAGIC_SIZE 8
+#define CAPTURE_FLUSH_INTERVAL_MS 100
+#define CAPTURE_MAX_BUFFERED (8 * 1024 * 1024)
+
+enum class CaptureDirection : uint8_t {
+    Received,
+    Transmitted
+};
+
+#pragma pack(push, 1)
+struct CaptureRecordHeader {
+    uint64_t timestampNs;   // от начала записи, монотонные часы
+    uint32_t length;
+    uint8_t direction;
+    uint8_t reserved[3];
+};
+#pragma pack(pop)
+
+// Запись сырого трафика в файл: вызывающие потоки только дописывают запись в буфер,
+// а в файл её выгружает фоновый поток. Файл: CAPTURE_MAGIC, затем записи
+// CaptureRecordHeader + данные.
+class CaptureWriter {
+public:
+    CaptureWriter();
+    ~CaptureWriter();
+
+    bool open(const std::string& fileName);
+    void close();
+    bool isOpen() const { return m_isOpen; }
+
+    void record(CaptureDirection direction, const char* data, size_t length);
+
+    uint64_t getDroppedBytes() const { return m_droppedBytes; }
+
+private:
+    void writerThreadFunc();
+
+    std::FILE* m_file = nullptr;
+    std::atomic<bool> m_isOpen{false};
+    std::chrono::steady_clock::time_point m_startTime;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<char> m_activeBuffer;
+    std::vector<char> m_writeBuffer;
+    bool m_keepWriting = false;
+    std::thread m_writerThread;
+
+    std::atomic<uint64_t> m_droppedBytes{0};
+};
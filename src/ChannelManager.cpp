@@ -1,33 +1,197 @@
 #include "ChannelManager.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// опция "имя:N": true, если имя совпало с key; valid - N целое из [minValue, maxValue]
+bool parseIntOption(const std::string& option, const char* key, int minValue, int maxValue, int& value, bool& valid) {
+    size_t keyLength = std::strlen(key);
+    if (option.compare(0, keyLength, key) != 0 || option.size() <= keyLength) {
+        return false;
+    }
+    char* end = nullptr;
+    long parsed = std::strtol(option.c_str() + keyLength, &end, 10);
+    valid = *end == '\0' && parsed >= minValue && parsed <= maxValue;
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+} // namespace
+
+bool MacProfile::parse(const std::string& text, MacProfile& out) {
+    MacProfile profile;
+    std::string mode = text;
+    std::string policy;
+
+    size_t comma = text.find(',');
+    if (comma != std::string::npos) {
+        mode = text.substr(0, comma);
+        policy = text.substr(comma + 1);
+    }
+
+    if (mode == "1-persistent") {
+        profile.persistence = PersistenceMode::OnePersistent;
+    } else if (mode == "non-persistent") {
+        profile.persistence = PersistenceMode::NonPersistent;
+    } else if (mode.compare(0, 12, "p-persistent") == 0) {
+        profile.persistence = PersistenceMode::PPersistent;
+        profile.probability = 0.5;
+        if (mode.size() > 13 && mode[12] == ':') {
+            profile.probability = std::atof(mode.c_str() + 13);
+        } else if (mode.size() != 12) {
+            return false;
+        }
+        if (profile.probability <= 0.0 || profile.probability > 1.0) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    while (!policy.empty()) {
+        comma = policy.find(',');
+        std::string option = policy.substr(0, comma);
+        policy = comma == std::string::npos ? std::string() : policy.substr(comma + 1);
+
+        bool valid = true;
+        if (parseIntOption(option, "slot:", 1, MAC_MAX_SLOT_TIME_BITS, profile.slotTimeBits, valid) ||
+            parseIntOption(option, "attempts:", 1, MAC_MAX_ATTEMPTS, profile.maxAttempts, valid) ||
+            parseIntOption(option, "limit:", 0, MAC_MAX_BACKOFF_LIMIT, profile.backoffLimit, valid)) {
+            if (!valid) {
+                return false;
+            }
+        } else if (option == "linear") {
+            profile.backoff = BackoffPolicy::Linear;
+        } else if (option == "constant") {
+            profile.backoff = BackoffPolicy::Constant;
+        } else if (option == "exponential") {
+            profile.backoff = BackoffPolicy::BinaryExponential;
+        } else if (option.compare(0, 10, "collision:") == 0 && option.size() > 10) {
+            char* end = nullptr;
+            profile.collisionProbability = std::strtod(option.c_str() + 10, &end);
+            if (*end != '\0' || profile.collisionProbability < 0.0 || profile.collisionProbability >= 1.0) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    out = profile;
+    return true;
+}
+
+std::string MacProfile::name() const {
+    std::string result;
+    switch (persistence) {
+        case PersistenceMode::OnePersistent: result = "1-persistent"; break;
+        case PersistenceMode::NonPersistent: result = "non-persistent"; break;
+        case PersistenceMode::PPersistent: {
+            std::string p = std::to_string(probability);
+            p.erase(p.find_last_not_of('0') + 1);
+            result = "p-persistent:" + p;
+            break;
+        }
+    }
+    switch (backoff) {
+        case BackoffPolicy::BinaryExponential: break;
+        case BackoffPolicy::Linear: result += ",linear"; break;
+        case BackoffPolicy::Constant: result += ",constant"; break;
+    }
+    if (collisionProbability != COLLISION_PROBABILITY) {
+        std::string p = std::to_string(collisionProbability);
+        p.erase(p.find_last_not_of('0') + 1);
+        if (p.back() == '.') {
+            p.pop_back();
+        }
+        result += ",collision:" + p;
+    }
+    if (slotTimeBits != SLOT_TIME_BITS) {
+        result += ",slot:" + std::to_string(slotTimeBits);
+    }
+    if (maxAttempts != MAX_ATTEMPTS) {
+        result += ",attempts:" + std::to_string(maxAttempts);
+    }
+    if (backoffLimit != BACKOFF_LIMIT) {
+        result += ",limit:" + std::to_string(backoffLimit);
+    }
+    return result;
+}
 
 ChannelManager& ChannelManager::getInstance() {
     static ChannelManager instance;
     return instance;
 }
 
-ChannelManager::ChannelManager()
-    : m_generator(std::random_device{}())
-    , m_probDist(0.0, 1.0) {
+ChannelManager::ChannelManager() {
+}
+
+std::mt19937& ChannelManager::getRandomGenerator() {
+    thread_local std::mt19937 generator(std::random_device{}());
+    return generator;
+}
+
+double ChannelManager::uniform() {
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    return dist(getRandomGenerator());
+}
+
+void ChannelManager::setProfile(const MacProfile& profile) {
+    std::lock_guard<std::mutex> lock(m_profileMutex);
+    m_profile = profile;
+}
+
+MacProfile ChannelManager::getProfile() const {
+    std::lock_guard<std::mutex> lock(m_profileMutex);
+    return m_profile;
 }
 
 bool ChannelManager::isChannelBusy() {
     if (!m_emulationEnabled) {
         return false;
     }
-    return m_probDist(m_generator) < 0.75;
+    return uniform() < 0.75;
 }
 
-bool ChannelManager::isCollisionOccurred() {
-    if (!m_emulationEnabled) {
-        return false;
+size_t ChannelManager::rollCollision(const MacProfile& profile, size_t length) {
+    if (!m_emulationEnabled || length == 0 || uniform() >= profile.collisionProbability) {
+        return length;
     }
-    return m_probDist(m_generator) < 0.25;
+    size_t slotBytes = static_cast<size_t>(std::max(1, profile.slotTimeBits / UART_BITS_PER_BYTE));
+    std::uniform_int_distribution<size_t> byteDist(0, std::min(length, slotBytes) - 1);
+    return byteDist(getRandomGenerator());
+}
+
+CarrierDecision ChannelManager::senseCarrier(const MacProfile& profile, bool channelBusy) {
+    return decide(profile, channelBusy, uniform());
+}
+
+int ChannelManager::calculateBackoffDelay(const MacProfile& profile, int attempt) {
+    return backoffSlots(profile, attempt, getRandomGenerator());
 }
 
-int ChannelManager::calculateBackoffDelay(int attempt) {
-    // Стандартная формула: случайное число от 0 до 2^k - 1
-    int k = std::min(attempt, 10);
-    int maxDelay = (1 << k) - 1;
-    std::uniform_int_distribution<int> delayDist(0, maxDelay);
-    return delayDist(m_generator);
+CarrierDecision ChannelManager::decide(const MacProfile& profile, bool channelBusy, double uniform) {
+    if (channelBusy) {
+        return profile.persistence == PersistenceMode::NonPersistent ? CarrierDecision::RandomWait
+                                                                     : CarrierDecision::KeepSensing;
+    }
+    if (profile.persistence == PersistenceMode::PPersistent && uniform >= profile.probability) {
+        return CarrierDecision::DeferSlot;
+    }
+    return CarrierDecision::Transmit;
+}
+
+int ChannelManager::backoffSlots(const MacProfile& profile, int attempt, std::mt19937& generator) {
+    int k = std::max(0, std::min(attempt, std::min(profile.backoffLimit, 30)));
+    int window = 1;
+    switch (profile.backoff) {
+        case BackoffPolicy::BinaryExponential: window = 1 << k; break;
+        case BackoffPolicy::Linear: window = k + 1; break;
+        case BackoffPolicy::Constant: window = 1 << std::max(0, std::min(profile.backoffLimit, 30)); break;
+    }
+    // Стандартная формула: случайное число от 0 до окна - 1
+    std::uniform_int_distribution<int> delayDist(0, window - 1);
+    return delayDist(generator);
 }
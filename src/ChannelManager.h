@@ -2,11 +2,64 @@
 #include <random>
 #include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
 
 // CSMA/CD константы
-#define SLOT_TIME_MS 10  // 512 бит при 10 Мбит/с = 51.2 мс
+#define SLOT_TIME_BITS 512 // слот - время передачи 512 бит на скорости порта, как в Ethernet
+#define UART_BITS_PER_BYTE 10 // старт, 8 бит данных, стоп
 #define MAX_ATTEMPTS 16    // Максимальное число попыток
+#define BACKOFF_LIMIT 10   // показатель окна отсрочки перестаёт расти после стольких попыток
+#define INTER_FRAME_GAP_BITS 96 // межкадровый интервал, в битах (как в Ethernet)
 #define JAM_SIGNAL_SIZE 32 // 32 бита jam-сигнала
+#define JAM_SIGNAL_BYTE 0xFF // из этих байтов состоит jam-сигнал; внутри кадра всегда экранируется
+#define COLLISION_PROBABILITY 0.25 // вероятность коллизии на одну попытку передачи кадра
+#define MAX_SENSE_ROUNDS 4096 // проверок занятого канала и отложенных слотов на один кадр
+#define MAC_MAX_SLOT_TIME_BITS 1000000 // пределы параметров профиля в MacProfile::parse
+#define MAC_MAX_ATTEMPTS 1000
+#define MAC_MAX_BACKOFF_LIMIT 30 // окно отсрочки 2^30 слотов - больше не помещается в int
+
+// Поведение станции, заставшей канал занятым
+enum class PersistenceMode : uint8_t {
+    OnePersistent,  // слушает канал непрерывно и передаёт, как только он освободится
+    NonPersistent,  // уходит на случайное время и слушает заново
+    PPersistent     // слушает непрерывно; в свободном слоте передаёт с вероятностью p, иначе ждёт слот
+};
+
+// Окно отсрочки после k-й коллизии, в слотах: случайное число из [0, окно)
+enum class BackoffPolicy : uint8_t {
+    BinaryExponential,  // 2^min(k, backoffLimit)
+    Linear,             // min(k, backoffLimit) + 1
+    Constant            // 2^backoffLimit при любом k
+};
+
+// Решение станции после прослушивания канала
+enum class CarrierDecision : uint8_t {
+    Transmit,
+    KeepSensing,    // канал занят - слушать дальше
+    DeferSlot,      // p-persistent: канал свободен, но передача отложена на слот
+    RandomWait      // non-persistent: канал занят - ждать случайное время
+};
+
+// Параметры MAC; меняются во время работы через ChannelManager::setProfile
+struct MacProfile {
+    PersistenceMode persistence = PersistenceMode::OnePersistent;
+    double probability = 1.0;   // p для PPersistent
+    BackoffPolicy backoff = BackoffPolicy::BinaryExponential;
+    int backoffLimit = BACKOFF_LIMIT;
+    int slotTimeBits = SLOT_TIME_BITS;
+    int maxAttempts = MAX_ATTEMPTS;
+    int maxSenseRounds = MAX_SENSE_ROUNDS;
+    double collisionProbability = COLLISION_PROBABILITY; // эмуляция: коллизия в первом слоте попытки
+
+    // "1-persistent", "non-persistent", "p-persistent:0.3", к имени можно добавить
+    // ",linear" или ",constant", ",collision:0.1", ",slot:N" (бит), ",attempts:N" и ",limit:N"
+    // (backoffLimit); false - имя не распознано или параметр вне допустимых пределов
+    static bool parse(const std::string& text, MacProfile& out);
+    // имя в том же виде; параметры со значениями по умолчанию опускаются
+    std::string name() const;
+};
 
 class ChannelManager {
 public:
@@ -14,14 +67,34 @@ public:
 
     void setEmulationEnabled(bool enabled) { m_emulationEnabled = enabled; }
 
+    void setProfile(const MacProfile& profile);
+    MacProfile getProfile() const;
+
     bool isChannelBusy();
-    bool isCollisionOccurred();
+    // разыгрывает коллизию один раз на попытку: номер байта кадра, на котором она обнаружена,
+    // или length, если коллизии нет. Коллизия возможна только в первом слоте - пока сигнал
+    // станции не дошёл до остальных
+    size_t rollCollision(const MacProfile& profile, size_t length);
 
-    int calculateBackoffDelay(int attempt);
+    // решение по профилю для текущего состояния канала
+    CarrierDecision senseCarrier(const MacProfile& profile, bool channelBusy);
+
+    int calculateBackoffDelay(const MacProfile& profile, int attempt);
     void setJamSignal(bool jam) { m_jamSignal = jam; }
     bool getJamSignal() const { return m_jamSignal; }
-    double getSlotTime() const { return SLOT_TIME_MS; }
-    int getMaxAttempts() const { return MAX_ATTEMPTS; }
+
+    // общие правила профиля; их же использует MacSimulator
+    static CarrierDecision decide(const MacProfile& profile, bool channelBusy, double uniform);
+    static int backoffSlots(const MacProfile& profile, int attempt, std::mt19937& generator);
+
+    // длительности при заданной скорости порта, бод
+    static std::chrono::nanoseconds getSlotDuration(const MacProfile& profile, int baudRate) {
+        return bitsDuration(profile.slotTimeBits, baudRate);
+    }
+    static std::chrono::nanoseconds getByteDuration(int baudRate) { return bitsDuration(UART_BITS_PER_BYTE, baudRate); }
+    static std::chrono::nanoseconds bitsDuration(int64_t bits, int baudRate) {
+        return std::chrono::nanoseconds(baudRate > 0 ? bits * 1000000000 / baudRate : 0);
+    }
 
     void incrementCollisions() { m_collisionCount++; }
     int getCollisionCount() const { return m_collisionCount; }
@@ -30,9 +103,15 @@ public:
 private:
     ChannelManager();
 
-    std::mt19937 m_generator;
-    std::uniform_real_distribution<double> m_probDist;
+    // канал эмулируют сразу несколько TransmitWorker (шлюз, объединение портов, каналы),
+    // поэтому генератор у каждого потока свой
+    static std::mt19937& getRandomGenerator();
+    static double uniform();
+
     std::atomic<bool> m_jamSignal{false};
     std::atomic<int> m_collisionCount{0};
-    bool m_emulationEnabled = false;
+    std::atomic<bool> m_emulationEnabled{false};
+
+    mutable std::mutex m_profileMutex;
+    MacProfile m_profile;
 };
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Consistent Overhead Byte Stuffing с произвольным исключаемым байтом Delimiter: вход режется
+// на участки без Delimiter длиной до 254 байт, каждый участок копируется как есть, а перед ним
+// пишется код (длина + 1) ^ Delimiter. Код 0xFF ^ Delimiter означает участок из 254 байт без
+// подразумеваемого Delimiter после него. Выход никогда не содержит Delimiter, поэтому кадры
+// разделяются одним этим байтом, а накладные расходы - не больше 1 байта на 254.
+// Поиск Delimiter идёт по 8 байт за раз, участки копируются memcpy.
+template <uint8_t Delimiter>
+class CobsStuffer {
+public:
+    static constexpr size_t MAX_RUN = 254;
+
+    static constexpr size_t maxStuffedSize(size_t length) { return length + length / MAX_RUN + 1; }
+
+    // позиция первого Delimiter в data или length, если его нет
+    static size_t findDelimiter(const uint8_t* data, size_t length) {
+        constexpr uint64_t ONES = 0x0101010101010101ULL;
+        constexpr uint64_t HIGHS = 0x8080808080808080ULL;
+        constexpr uint64_t PATTERN = ONES * Delimiter;
+
+        size_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            // старший бит байта результата взведён, если в слове есть байт, равный Delimiter
+            uint64_t x = word ^ PATTERN;
+            if ((x - ONES) & ~x & HIGHS) {
+                break;
+            }
+        }
+        for (; i < length; i++) {
+            if (data[i] == Delimiter) {
+                return i;
+            }
+        }
+        return length;
+    }
+
+    // out вмещает maxStuffedSize(length) байтов
+    static size_t stuff(const uint8_t* in, size_t length, char* out) {
+        size_t written = 0;
+        size_t pos = 0;
+
+        while (true) {
+            size_t limit = length - pos < MAX_RUN ? length - pos : MAX_RUN;
+            size_t run = findDelimiter(in + pos, limit);
+
+            out[written++] = static_cast<char>((run + 1) ^ Delimiter);
+            if (run > 0) {
+                std::memcpy(out + written, in + pos, run);   // пустой вход может прийти с in == nullptr
+            }
+            written += run;
+            pos += run;
+
+            if (run == MAX_RUN) {
+                continue;   // полный участок: Delimiter после него не подразумевается
+            }
+            if (pos == length) {
+                return written;
+            }
+            pos++;          // Delimiter, закрывающий участок
+        }
+    }
+
+    static size_t stuffedSize(const uint8_t* in, size_t length) {
+        size_t size = 0;
+        size_t pos = 0;
+
+        while (true) {
+            size_t limit = length - pos < MAX_RUN ? length - pos : MAX_RUN;
+            size_t run = findDelimiter(in + pos, limit);
+
+            size += 1 + run;
+            pos += run;
+
+            if (run == MAX_RUN) {
+                continue;
+            }
+            if (pos == length) {
+                return size;
+            }
+            pos++;
+        }
+    }
+
+    // out вмещает length байтов; false - код указывает за конец входа или сам равен Delimiter
+    static bool unstuff(const char* in, size_t length, uint8_t* out, size_t& written) {
+        written = 0;
+        size_t pos = 0;
+
+        while (pos < length) {
+            size_t code = static_cast<uint8_t>(in[pos++]) ^ Delimiter;
+            if (code == 0 || pos + code - 1 > length) {
+                return false;
+            }
+
+            size_t run = code - 1;
+            std::memcpy(out + written, in + pos, run);
+            written += run;
+            pos += run;
+
+            if (code != MAX_RUN + 1 && pos < length) {
+                out[written++] = Delimiter;
+            }
+        }
+        return true;
+    }
+};
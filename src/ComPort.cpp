@@ -1,5 +1,8 @@
 #include "ComPort.h"
+#include "PortDiscovery.h"
+#include "Tracer.h"
 #include <iostream>
+#include <chrono>
 
 ComPort::ComPort() {};
 
@@ -37,6 +40,7 @@ bool ComPort::open(const std::string& portName, int baudRate) {
         return false;
     }
 
+    m_metrics = MetricsRegistry::getInstance().getPort(portName);
     m_isOpen = true;
     return true;
 }
@@ -80,26 +84,37 @@ bool ComPort::configurePort() {
     return SetCommTimeouts(m_hPort, &timeouts);
 }
 
-bool ComPort::writeData(const std::string& data) {
-    if (!isOpen()) return false;
-
-    return writeData(data.c_str(), data.length());
-}
-
 bool ComPort::writeData(const char* data, size_t length) {
     if (!isOpen()) return false;
 
+    TRACE_SCOPE_ARG("writeData", length);
+
     DWORD bytesWritten;
-    BOOL success = WriteFile(m_hPort, data, length, &bytesWritten, NULL);
+    BOOL success;
+    {
+        ScopedLatency latency(m_metrics, MetricStage::Write);
+        success = WriteFile(m_hPort, data, length, &bytesWritten, NULL);
+    }
+
+    if (m_metrics && success) {
+        m_metrics->add(MetricCounter::BytesSent, bytesWritten);
+    }
+
+    CaptureWriter* capture = m_capture;
+    if (capture && success && bytesWritten > 0) {
+        capture->record(CaptureDirection::Transmitted, data, bytesWritten);
+    }
 
     return success && (bytesWritten == length);
 }
 
-bool ComPort::startAsyncReading(const DataReceivedCallback& callback) {
+bool ComPort::startAsyncReading(const DataReadyCallback& callback) {
     if (!m_isOpen || m_keepReading) {
         return false;
     }
 
+    m_rxRing.reset();
+    m_notifyPending = false;
     m_dataCallback = callback;
     m_keepReading = true;
     m_readingThread = std::thread(&ComPort::readingThreadFunc, this);
@@ -116,17 +131,33 @@ void ComPort::stopAsyncReading() {
 }
 
 void ComPort::readingThreadFunc() {
-    char buffer[1024];
+    Tracer::setThreadName("reader");
     DWORD bytesRead;
 
     while (m_keepReading) {
-        if (ReadFile(m_hPort, buffer, sizeof(buffer) - 1, &bytesRead, NULL)) {
+        char* region;
+        size_t space = m_rxRing.writableRegion(region);
+        if (space == 0) {
+            // потребитель не успевает - ждём освобождения места, данные остаются в буфере драйвера
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        if (ReadFile(m_hPort, region, static_cast<DWORD>(space), &bytesRead, NULL)) {
             if (bytesRead > 0) {
-                buffer[bytesRead] = '\0';
-                std::string receivedData(buffer, bytesRead);
+                TRACE_SCOPE_ARG("readChunk", bytesRead);
+
+                CaptureWriter* capture = m_capture;
+                if (capture) {
+                    capture->record(CaptureDirection::Received, region, bytesRead);
+                }
+                m_metrics->add(MetricCounter::BytesReceived, bytesRead);
+
+                m_rxRing.commitWrite(bytesRead);
 
-                if (m_dataCallback) {
-                    m_dataCallback(receivedData);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!m_notifyPending.exchange(true) && m_dataCallback) {
+                    m_dataCallback();
                 }
             }
         } else {
@@ -140,6 +171,23 @@ void ComPort::readingThreadFunc() {
     }
 }
 
+size_t ComPort::readReceived(std::string& out) {
+    m_notifyPending = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    size_t total = 0;
+    const char* region;
+    size_t length;
+
+    while ((length = m_rxRing.readableRegion(region)) > 0) {
+        out.append(region, length);
+        m_rxRing.commitRead(length);
+        total += length;
+    }
+
+    return total;
+}
+
 bool ComPort::setBaudRate(int baudRate) {
     if (!isOpen()) return false;
 
@@ -161,21 +209,7 @@ bool ComPort::setTimeout(int readIntervalMs, int readTotalMs, int writeTotalMs)
 }
 
 std::vector<std::string> ComPort::getAvailablePorts() {
-    std::vector<std::string> ports;
-
-    for (int i = 1; i <= 256; ++i) {
-        std::string portName = "COM" + std::to_string(i);
-        HANDLE hPort = CreateFileA(("\\\\.\\" + portName).c_str(),
-                                   GENERIC_READ | GENERIC_WRITE,
-                                   0, NULL, OPEN_EXISTING, 0, NULL);
-
-        if (hPort != INVALID_HANDLE_VALUE) {
-            ports.push_back(portName);
-            CloseHandle(hPort);
-        }
-    }
-
-    return ports;
+    return PortDiscovery::enumeratePorts();
 }
 
 bool ComPort::portExists(const std::string& portName) {
@@ -7,31 +7,41 @@
 #include <atomic>
 #include <functional>
 
-class ComPort {
-public:
-    using DataReceivedCallback = std::function<void(const std::string& data)>;
+#include "ByteRingBuffer.h"
+#include "CaptureWriter.h"
+#include "Metrics.h"
+#include "SerialPort.h"
+
+#define RX_RING_SIZE (64 * 1024)
 
+class ComPort : public SerialPort {
+public:
     ComPort();
-    ~ComPort();
+    ~ComPort() override;
 
-    bool open(const std::string& portName, int baudRate = 9600);
-    void close();
-    bool isOpen() const { return m_isOpen; };
+    bool open(const std::string& portName, int baudRate = 9600) override;
+    void close() override;
+    bool isOpen() const override { return m_isOpen; };
 
-    bool writeData(const std::string& data);
-    bool writeData(const char* data, size_t length);
+    using SerialPort::writeData;
+    bool writeData(const char* data, size_t length) override;
 
-    bool startAsyncReading(const DataReceivedCallback& callback = nullptr);
-    void stopAsyncReading();
+    bool startAsyncReading(const DataReadyCallback& callback = nullptr) override;
+    void stopAsyncReading() override;
 
-    bool setBaudRate(int baudRate);
+    size_t readReceived(std::string& out) override;
+
+    bool setBaudRate(int baudRate) override;
     bool setTimeout(int readIntervalMs = 50, int readTotalMs = 50, int writeTotalMs = 50);
 
     static std::vector<std::string> getAvailablePorts();
     static bool portExists(const std::string& portName);
 
-    std::string getPortName() const { return m_portName; };
-    int getBaudRate() const { return m_baudRate; };
+    void setCaptureWriter(CaptureWriter* writer) override { m_capture = writer; }
+    PortMetrics* getMetrics() const override { return m_metrics; }
+
+    std::string getPortName() const override { return m_portName; };
+    int getBaudRate() const override { return m_baudRate; };
 private:
     bool configurePort();
     void readingThreadFunc();
@@ -44,5 +54,9 @@ private:
     std::atomic<bool> m_keepReading{false};
     std::thread m_readingThread;
 
-    DataReceivedCallback m_dataCallback;
+    ByteRingBuffer m_rxRing{RX_RING_SIZE};
+    std::atomic<bool> m_notifyPending{false};
+    DataReadyCallback m_dataCallback;
+    std::atomic<CaptureWriter*> m_capture{nullptr};
+    PortMetrics* m_metrics = nullptr;
 };
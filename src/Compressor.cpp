@@ -0,0 +1,336 @@
+#include "Compressor.h"
+#include <cstring>
+#include <vector>
+
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+#define LZ_HASH_BITS 12
+
+#define RLE_MIN_RUN 3
+#define RLE_MAX_RUN (0x7F + RLE_MIN_RUN)
+#define RLE_MAX_LITERALS 0x80
+
+// Словарь частых фрагментов телеметрии: короткие сообщения находят в нём совпадения,
+// даже если внутри самого сообщения повторов нет. Менять только вместе с приёмной стороной.
+static const char s_dictionary[] =
+    "0123456789. , : ; = - + % / ( ) [ ] "
+    "status: OK ERROR error warning WARN timeout "
+    "temperature=temp= voltage=volt= current= pressure= speed= level= "
+    "time= date= id= seq= count= value= min= max= avg= "
+    "true false on off enabled disabled connected disconnected ";
+
+static const size_t s_dictionarySize = sizeof(s_dictionary) - 1;
+
+static void writeVarint(size_t value, std::string& output) {
+    while (value >= 0x80) {
+        output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+}
+
+static bool readVarint(const uint8_t*& pos, const uint8_t* end, size_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && pos < end; shift += 7) {
+        uint8_t byte = *pos++;
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// длина в формате LZ4: 4 бита в токене, затем байты по 255
+static void writeLength(size_t length, std::string& output) {
+    while (length >= 255) {
+        output.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    output.push_back(static_cast<char>(length));
+}
+
+static bool readLength(const uint8_t*& pos, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (pos >= end) {
+            return false;
+        }
+        byte = *pos++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+static inline uint32_t read32(const uint8_t* pos) {
+    uint32_t value;
+    std::memcpy(&value, pos, sizeof(value));
+    return value;
+}
+
+static inline size_t hash32(uint32_t value) {
+    return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static void emitSequence(const uint8_t* literals, size_t literalCount, size_t matchLength, size_t offset,
+                         std::string& output) {
+    size_t matchCode = matchLength ? matchLength - LZ_MIN_MATCH : 0;
+    uint8_t token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4) |
+                    static_cast<uint8_t>(matchCode < 15 ? matchCode : 15);
+    output.push_back(static_cast<char>(token));
+
+    if (literalCount >= 15) {
+        writeLength(literalCount - 15, output);
+    }
+    output.append(reinterpret_cast<const char*>(literals), literalCount);
+
+    if (matchLength == 0) {
+        return; // последняя последовательность - только литералы
+    }
+
+    output.push_back(static_cast<char>(offset & 0xFF));
+    output.push_back(static_cast<char>(offset >> 8));
+    if (matchCode >= 15) {
+        writeLength(matchCode - 15, output);
+    }
+}
+
+void Compressor::compressLz77(const uint8_t* dictionary, size_t dictionarySize,
+                              const uint8_t* input, size_t inputSize, std::string& output) {
+    // словарь и данные в одном окне, чтобы смещения могли указывать в словарь
+    std::vector<uint8_t> window(dictionarySize + inputSize);
+    if (dictionarySize) {
+        std::memcpy(window.data(), dictionary, dictionarySize);
+    }
+    std::memcpy(window.data() + dictionarySize, input, inputSize);
+
+    const uint8_t* base = window.data();
+    const size_t end = window.size();
+
+    std::vector<int32_t> table(static_cast<size_t>(1) << LZ_HASH_BITS, -1);
+    for (size_t i = 0; i + LZ_MIN_MATCH <= dictionarySize; i++) {
+        table[hash32(read32(base + i))] = static_cast<int32_t>(i);
+    }
+
+    size_t anchor = dictionarySize;
+    size_t pos = dictionarySize;
+
+    while (pos + LZ_MIN_MATCH <= end) {
+        uint32_t sequence = read32(base + pos);
+        size_t slot = hash32(sequence);
+        int32_t candidate = table[slot];
+        table[slot] = static_cast<int32_t>(pos);
+
+        if (candidate < 0 || pos - candidate > LZ_MAX_OFFSET || read32(base + candidate) != sequence) {
+            pos++;
+            continue;
+        }
+
+        size_t matchLength = LZ_MIN_MATCH;
+        while (pos + matchLength < end && base[candidate + matchLength] == base[pos + matchLength]) {
+            matchLength++;
+        }
+
+        emitSequence(base + anchor, pos - anchor, matchLength, pos - candidate, output);
+        pos += matchLength;
+        anchor = pos;
+    }
+
+    emitSequence(base + anchor, end - anchor, 0, 0, output);
+}
+
+bool Compressor::decompressLz77(const uint8_t* dictionary, size_t dictionarySize,
+                                const uint8_t* input, size_t inputSize, size_t outputSize, std::string& output) {
+    std::string window(reinterpret_cast<const char*>(dictionary), dictionarySize);
+    window.reserve(dictionarySize + outputSize);
+
+    const uint8_t* pos = input;
+    const uint8_t* end = input + inputSize;
+
+    while (pos < end) {
+        uint8_t token = *pos++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !readLength(pos, end, literalCount)) {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(end - pos) ||
+            window.size() + literalCount > dictionarySize + outputSize) {
+            return false;
+        }
+        window.append(reinterpret_cast<const char*>(pos), literalCount);
+        pos += literalCount;
+
+        if (pos == end) {
+            break; // последняя последовательность
+        }
+
+        if (end - pos < 2) {
+            return false;
+        }
+        size_t offset = pos[0] | (static_cast<size_t>(pos[1]) << 8);
+        pos += 2;
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(pos, end, matchLength)) {
+            return false;
+        }
+        matchLength += LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > window.size() ||
+            window.size() + matchLength > dictionarySize + outputSize) {
+            return false;
+        }
+
+        // совпадение может перекрываться с тем, что копируется, поэтому побайтно
+        size_t from = window.size() - offset;
+        for (size_t i = 0; i < matchLength; i++) {
+            window.push_back(window[from + i]);
+        }
+    }
+
+    output.assign(window, dictionarySize, std::string::npos);
+    return true;
+}
+
+// Управляющий байт: 0x00-0x7F - далее n + 1 литералов, 0x80-0xFF - следующий байт
+// повторяется (n - 0x80 + RLE_MIN_RUN) раз
+void Compressor::compressRle(const uint8_t* input, size_t inputSize, std::string& output) {
+    size_t pos = 0;
+    size_t literalStart = 0;
+
+    auto flushLiterals = [&](size_t until) {
+        while (literalStart < until) {
+            size_t count = until - literalStart;
+            if (count > RLE_MAX_LITERALS) {
+                count = RLE_MAX_LITERALS;
+            }
+            output.push_back(static_cast<char>(count - 1));
+            output.append(reinterpret_cast<const char*>(input + literalStart), count);
+            literalStart += count;
+        }
+    };
+
+    while (pos < inputSize) {
+        size_t run = 1;
+        while (pos + run < inputSize && run < RLE_MAX_RUN && input[pos + run] == input[pos]) {
+            run++;
+        }
+
+        if (run >= RLE_MIN_RUN) {
+            flushLiterals(pos);
+            output.push_back(static_cast<char>(0x80 + run - RLE_MIN_RUN));
+            output.push_back(static_cast<char>(input[pos]));
+            pos += run;
+            literalStart = pos;
+        } else {
+            pos += run;
+        }
+    }
+
+    flushLiterals(inputSize);
+}
+
+bool Compressor::decompressRle(const uint8_t* input, size_t inputSize, size_t outputSize, std::string& output) {
+    output.clear();
+    output.reserve(outputSize);
+    const uint8_t* pos = input;
+    const uint8_t* end = input + inputSize;
+
+    while (pos < end) {
+        uint8_t control = *pos++;
+
+        if (control < 0x80) {
+            size_t count = control + 1;
+            if (count > static_cast<size_t>(end - pos) || output.size() + count > outputSize) {
+                return false;
+            }
+            output.append(reinterpret_cast<const char*>(pos), count);
+            pos += count;
+        } else {
+            size_t count = control - 0x80 + RLE_MIN_RUN;
+            if (pos >= end || output.size() + count > outputSize) {
+                return false;
+            }
+            output.append(count, static_cast<char>(*pos++));
+        }
+    }
+    return true;
+}
+
+bool Compressor::compress(const std::string& input, std::string& output) {
+    if (input.size() < COMPRESSION_MIN_SIZE) {
+        return false;
+    }
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(input.data());
+
+    std::string header;
+    writeVarint(input.size(), header);
+
+    std::string candidates[3];
+    compressLz77(nullptr, 0, data, input.size(), candidates[0]);
+    compressLz77(reinterpret_cast<const uint8_t*>(s_dictionary), s_dictionarySize, data, input.size(), candidates[1]);
+    compressRle(data, input.size(), candidates[2]);
+
+    const CompressionMethod methods[3] = {CompressionMethod::Lz77, CompressionMethod::Lz77Dictionary,
+                                          CompressionMethod::Rle};
+    size_t best = 0;
+    for (size_t i = 1; i < 3; i++) {
+        if (candidates[i].size() < candidates[best].size()) {
+            best = i;
+        }
+    }
+
+    if (1 + header.size() + candidates[best].size() >= input.size()) {
+        return false;
+    }
+
+    output.clear();
+    output.reserve(1 + header.size() + candidates[best].size());
+    output.push_back(static_cast<char>(methods[best]));
+    output += header;
+    output += candidates[best];
+    return true;
+}
+
+bool Compressor::decompress(const std::string& input, std::string& output) {
+    const uint8_t* pos = reinterpret_cast<const uint8_t*>(input.data());
+    const uint8_t* end = pos + input.size();
+
+    if (pos == end) {
+        return false;
+    }
+    CompressionMethod method = static_cast<CompressionMethod>(*pos++);
+
+    size_t originalSize;
+    if (!readVarint(pos, end, originalSize) || originalSize > COMPRESSION_MAX_OUTPUT) {
+        return false;
+    }
+
+    std::string result;
+    bool success;
+
+    switch (method) {
+    case CompressionMethod::Lz77:
+        success = decompressLz77(nullptr, 0, pos, end - pos, originalSize, result);
+        break;
+    case CompressionMethod::Lz77Dictionary:
+        success = decompressLz77(reinterpret_cast<const uint8_t*>(s_dictionary), s_dictionarySize,
+                                 pos, end - pos, originalSize, result);
+        break;
+    case CompressionMethod::Rle:
+        success = decompressRle(pos, end - pos, originalSize, result);
+        break;
+    default:
+        success = false;
+        break;
+    }
+
+    if (!success || result.size() != originalSize) {
+        return false;
+    }
+
+    output = std::move(result);
+    return true;
+}
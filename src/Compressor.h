@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define COMPRESSION_MIN_SIZE 8          // короче этого сжимать бессмысленно
+#define COMPRESSION_MAX_OUTPUT (1 << 20) // защита от повреждённого заголовка при распаковке
+
+// Метод сжатия - первый байт сжатого блока
+enum class CompressionMethod : uint8_t {
+    Lz77 = 1,           // LZ77 в формате последовательностей LZ4
+    Lz77Dictionary = 2, // то же, но окно заранее заполнено словарём - для коротких сообщений
+    Rle = 3             // кодирование серий
+};
+
+// Сжатие полезной нагрузки сообщения перед разбиением на кадры.
+// Блок: метод (1 байт), исходная длина (varint), сжатые данные.
+class Compressor {
+public:
+    // пробует все методы и возвращает true, если лучший из них короче исходных данных
+    static bool compress(const std::string& input, std::string& output);
+    static bool decompress(const std::string& input, std::string& output);
+
+private:
+    static void compressLz77(const uint8_t* dictionary, size_t dictionarySize,
+                             const uint8_t* input, size_t inputSize, std::string& output);
+    static bool decompressLz77(const uint8_t* dictionary, size_t dictionarySize,
+                               const uint8_t* input, size_t inputSize, size_t outputSize, std::string& output);
+    static void compressRle(const uint8_t* input, size_t inputSize, std::string& output);
+    static bool decompressRle(const uint8_t* input, size_t inputSize, size_t outputSize, std::string& output);
+};
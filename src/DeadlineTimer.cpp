@@ -0,0 +1,95 @@
+#include "DeadlineTimer.h"
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <ctime>
+#endif
+
+DeadlineTimer::DeadlineTimer() {
+#ifdef _WIN32
+    // высокоточный таймер есть начиная с Windows 10 1803, иначе - обычный
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!m_timer) {
+        m_timer = CreateWaitableTimerW(nullptr, TRUE, nullptr);
+    }
+#elif defined(__linux__)
+    m_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+#endif
+}
+
+DeadlineTimer::~DeadlineTimer() {
+#ifdef _WIN32
+    if (m_timer) {
+        CloseHandle(m_timer);
+    }
+#else
+    if (m_timerFd >= 0) {
+        close(m_timerFd);
+    }
+#endif
+}
+
+uint64_t DeadlineTimer::sleepUntil(Clock::time_point deadline) {
+    Clock::time_point now = Clock::now();
+    if (now >= deadline) {
+        return 0;
+    }
+
+    Clock::time_point wakeAt = deadline - std::chrono::microseconds(DEADLINE_SPIN_US);
+    if (now < wakeAt) {
+        waitCoarse(wakeAt);
+    }
+
+    // остаток - активно; yield отдаёт ядро, если кто-то ждёт его
+    while ((now = Clock::now()) < deadline) {
+        std::this_thread::yield();
+    }
+
+    uint64_t lateness = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
+    if (m_metrics) {
+        m_metrics->recordLatency(MetricStage::TimerLateness, lateness);
+    }
+    return lateness;
+}
+
+void DeadlineTimer::waitCoarse(Clock::time_point wakeAt) {
+#ifdef _WIN32
+    if (m_timer) {
+        // относительный срок в единицах 100 нс, отрицательный
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeAt - Clock::now()).count();
+        if (remaining <= 0) {
+            return;
+        }
+        LARGE_INTEGER due;
+        due.QuadPart = -static_cast<LONGLONG>(remaining / 100);
+        if (SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE)) {
+            WaitForSingleObject(m_timer, INFINITE);
+            return;
+        }
+    }
+#elif defined(__linux__)
+    // steady_clock в Linux - это CLOCK_MONOTONIC, поэтому срок передаётся как есть
+    if (m_timerFd >= 0) {
+        auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeAt.time_since_epoch()).count();
+        itimerspec spec{};
+        spec.it_value.tv_sec = static_cast<time_t>(sinceEpoch / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(sinceEpoch % 1000000000);
+
+        if (timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0) {
+            uint64_t expirations;
+            while (read(m_timerFd, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {
+            }
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_until(wakeAt);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "Metrics.h"
+
+#define DEADLINE_SPIN_US 200 // последние микросекунды до срока ждём активно, а не в ядре
+
+// Ожидание до абсолютного срока по монотонным часам. Основная часть интервала
+// проходит в ядре (timerfd в Linux, высокоточный таймер ожидания в Windows),
+// а остаток до срока - в активном ожидании, поэтому точность не зависит от
+// гранулярности sleep. Сроки абсолютные: если ожидания идут цепочкой
+// (срок += интервал), опоздания не накапливаются.
+// Опоздание каждого пробуждения пишется в гистограмму MetricStage::TimerLateness.
+// Один объект - для одного потока.
+class DeadlineTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    DeadlineTimer();
+    ~DeadlineTimer();
+
+    DeadlineTimer(const DeadlineTimer&) = delete;
+    DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+
+    void setMetrics(PortMetrics* metrics) { m_metrics = metrics; }
+
+    // возвращает опоздание пробуждения относительно срока, нс; срок в прошлом - сразу 0
+    uint64_t sleepUntil(Clock::time_point deadline);
+    uint64_t sleepFor(Clock::duration duration) { return sleepUntil(Clock::now() + duration); }
+
+private:
+    void waitCoarse(Clock::time_point wakeAt);
+
+    PortMetrics* m_metrics = nullptr;
+#ifdef _WIN32
+    void* m_timer = nullptr;
+#else
+    int m_timerFd = -1;
+#endif
+};
@@ -1,4 +1,7 @@
 #include "EncodingConverter.h"
+#include <cstdint>
+
+#ifdef _WIN32
 
 std::string EncodingConverter::utf8ToWindows1251(const std::string& utf8) {
     if (utf8.empty()) return "";
@@ -39,3 +42,116 @@ std::string EncodingConverter::windows1251ToUtf8(const std::string& cp1251) {
 bool EncodingConverter::isWindows1251Available() {
     return GetACP() == 1251 || true;
 }
+
+#else
+
+// Без Windows API (виртуальный порт, консольные утилиты) - таблица Windows-1251 для 0x80..0xFF
+static const uint16_t kWindows1251High[128] = {
+    0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+    0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x0098, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+    0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7,
+    0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+    0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7,
+    0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457,
+    0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+    0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+    0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+    0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+    0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+    0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+    0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+    0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+};
+
+static void appendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+std::string EncodingConverter::utf8ToWindows1251(const std::string& utf8) {
+    std::string result;
+    result.reserve(utf8.length());
+
+    for (size_t i = 0; i < utf8.length();) {
+        uint8_t lead = static_cast<uint8_t>(utf8[i]);
+        uint32_t code;
+        size_t length;
+
+        if (lead < 0x80) {
+            code = lead;
+            length = 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+            code = lead & 0x1F;
+            length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            code = lead & 0x0F;
+            length = 3;
+        } else if ((lead & 0xF8) == 0xF0) {
+            code = lead & 0x07;
+            length = 4;
+        } else {
+            result += '?';
+            i++;
+            continue;
+        }
+
+        if (i + length > utf8.length()) {
+            result += '?';
+            break;
+        }
+        for (size_t k = 1; k < length; k++) {
+            code = (code << 6) | (static_cast<uint8_t>(utf8[i + k]) & 0x3F);
+        }
+        i += length;
+
+        if (code < 0x80) {
+            result += static_cast<char>(code);
+            continue;
+        }
+        if (code >= 0x0410 && code <= 0x044F) {
+            // А..я идут в обеих кодировках подряд
+            result += static_cast<char>(0xC0 + (code - 0x0410));
+            continue;
+        }
+
+        // символы без представления в Windows-1251 заменяются, как это делает WideCharToMultiByte
+        char replacement = '?';
+        for (int k = 0; k < 128; k++) {
+            if (kWindows1251High[k] == code) {
+                replacement = static_cast<char>(0x80 + k);
+                break;
+            }
+        }
+        result += replacement;
+    }
+
+    return result;
+}
+
+std::string EncodingConverter::windows1251ToUtf8(const std::string& cp1251) {
+    std::string result;
+    result.reserve(cp1251.length() * 2);
+
+    for (char c : cp1251) {
+        uint8_t byte = static_cast<uint8_t>(c);
+        appendUtf8(result, byte < 0x80 ? byte : kWindows1251High[byte - 0x80]);
+    }
+
+    return result;
+}
+
+bool EncodingConverter::isWindows1251Available() {
+    return true;
+}
+
+#endif
@@ -1,6 +1,9 @@
 #pragma once
 #include <string>
+
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 class EncodingConverter {
 public:
@@ -14,8 +14,8 @@ int ErrorSimulator::simulateErrors(std::vector<uint8_t>& data) {
 }
 
 std::mt19937& ErrorSimulator::getRandomGenerator() {
-    static std::random_device rd;
-    static std::mt19937 generator(rd());
+    // кадры декодируются параллельно, поэтому генератор у каждого потока свой
+    thread_local std::mt19937 generator(std::random_device{}());
     return generator;
 }
 
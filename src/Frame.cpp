@@ -19,6 +19,7 @@ std::vector<uint8_t> Frame::serialize() const {
     bytes.push_back(this->startFlag);
     bytes.push_back(this->total);
     bytes.push_back(this->sequence);
+    bytes.push_back(this->flags);
 
     bytes.insert(bytes.end(), data.begin(), data.end());
 
@@ -42,10 +43,12 @@ bool Frame::deserialize(const std::vector<uint8_t>& data) {
     this->startFlag = data[0];
     this->total = data[1];
     this->sequence = data[2];
+    this->flags = data[3];
 
     size_t dataEndPos;
 
-    if (data.size() > 20) {
+    // данные до 15 байт включительно защищены 1 байтом fcs (данные + fcs <= 16), длиннее - 2 байтами
+    if (data.size() - HEADER_SIZE - TRAILER_SIZE > 16) {
         dataEndPos = data.size() - 1 - 2; // fcs битов 9 чтобы 2^7 (от 0 до 7) было больше чем 16 * 8 + 1 плюс 1 бит secded
     }
     else {
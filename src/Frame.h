@@ -6,24 +6,35 @@
 
 #include "HammingEncoder.h"
 
+#define FRAME_DATA_SIZE 64
+#define FRAME_MAX_COUNT 255 // число кадров и номер кадра в заголовке - по одному байту
 #define START_FLAG_BYTE 0x0B
-#define HEADER_SIZE 3
+#define HEADER_SIZE 4 // флаг начала, всего кадров, номер кадра, флаги
 #define TRAILER_SIZE 1
 #define END_FLAG_BYTE 0x0C
 #define ESCAPE_BYTE 0x7D
 #define XOR_MASK 0x50
 
+#define FRAME_FLAG_COMPRESSED 0x01 // данные сообщения сжаты Compressor
+// метка сообщения (0..7, по кругу): отличает кадры соседних сообщений с одинаковым числом кадров
+#define FRAME_FLAG_TAG_SHIFT 1
+#define FRAME_FLAG_TAG_MASK 0x0E
+// логический канал (0..15): сообщения разных каналов передаются вперемежку по кадрам
+#define FRAME_FLAG_CHANNEL_SHIFT 4
+#define FRAME_FLAG_CHANNEL_MASK 0xF0
+#define FRAME_CHANNEL_COUNT 16
+
 class Frame {
 public:
-    Frame(): startFlag(0), total(0), sequence(0), data(0), fcs(0), endFlag(0) {};
+    Frame(): startFlag(0), total(0), sequence(0), flags(0), data(0), fcs(0), endFlag(0) {};
 
-    Frame(uint8_t sequence, uint8_t total, const std::vector<uint8_t>& data)
-        : startFlag(START_FLAG_BYTE), sequence(sequence), total(total), data(data), endFlag(END_FLAG_BYTE) {
+    Frame(uint8_t sequence, uint8_t total, const std::vector<uint8_t>& data, uint8_t flags = 0)
+        : startFlag(START_FLAG_BYTE), total(total), sequence(sequence), flags(flags), data(data), endFlag(END_FLAG_BYTE) {
         fcs = HammingEncoder::calculateControlBits(this->data);
     }
 
-    Frame(uint8_t sequence, uint8_t total, const std::string& data)
-        : startFlag(START_FLAG_BYTE), sequence(sequence), total(total), endFlag(END_FLAG_BYTE) {
+    Frame(uint8_t sequence, uint8_t total, const std::string& data, uint8_t flags = 0)
+        : startFlag(START_FLAG_BYTE), total(total), sequence(sequence), flags(flags), endFlag(END_FLAG_BYTE) {
         setData(data);
         fcs = HammingEncoder::calculateControlBits(this->data);
     }
@@ -34,6 +45,9 @@ public:
     uint8_t getStartFlag() const { return startFlag; }
     uint8_t getTotal() const { return total; }
     uint8_t getSequence() const { return sequence; }
+    uint8_t getFlags() const { return flags; }
+    bool isCompressed() const { return flags & FRAME_FLAG_COMPRESSED; }
+    uint8_t getChannel() const { return (flags & FRAME_FLAG_CHANNEL_MASK) >> FRAME_FLAG_CHANNEL_SHIFT; }
     const std::vector<uint8_t>& getData() const { return data; }
     const std::vector<uint8_t>& getFcs() const { return fcs; }
     uint8_t getEndFlag() const { return endFlag; }
@@ -41,6 +55,7 @@ public:
     void setStartFlag(uint8_t flag) { this->startFlag = flag; }
     void setTotal(uint8_t total) { this->total = total; }
     void setSequence(uint8_t sequence) { this->sequence = sequence; }
+    void setFlags(uint8_t flags) { this->flags = flags; }
     void setData(const std::vector<uint8_t>& data);
     void setData(const std::string& data);
     void setFcs(std::vector<uint8_t> fcs) { this->fcs = fcs; }
@@ -55,6 +70,7 @@ private:
     uint8_t startFlag;
     uint8_t total;
     uint8_t sequence;
+    uint8_t flags;
     std::vector<uint8_t> data;
     std::vector<uint8_t> fcs;
     uint8_t endFlag;
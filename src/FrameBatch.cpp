@@ -0,0 +1,205 @@
+#include "FrameBatch.h"
+#include "FrameManager.h"
+#include "HammingBatch.h"
+#include "HammingKernel.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <future>
+#include <memory>
+
+static_assert(BATCH_FCS_STRIDE >= hammingFcsSize(FRAME_DATA_SIZE), "fcs кадра не помещается в BATCH_FCS_STRIDE");
+
+void FrameBatch::clear() {
+    arena.clear();
+    frames.clear();
+    firstFrame.clear();
+    messageFlags.clear();
+    encoded.clear();
+    channel = 0;
+}
+
+bool BatchEncoder::encode(const std::vector<std::string>& messages, FrameBatch& out, bool compress) {
+    out.clear();
+
+    const size_t count = messages.size();
+    m_payloads.resize(count);
+    out.messageFlags.assign(count, 0);
+    out.encoded.assign(count, 0);
+
+    {
+        TRACE_SCOPE_ARG("batchTranscode", count);
+        parallelFor(count, BATCH_CHUNK_FRAMES, [&](size_t begin, size_t end) {
+            FrameManager frameManager;
+            for (size_t i = begin; i < end; i++) {
+                std::string& payload = m_payloads[i];
+                if (!frameManager.encodeMessage(messages[i], payload) || payload.empty()) {
+                    continue;
+                }
+                if (compress && FrameManager::compressMessage(payload)) {
+                    out.messageFlags[i] = FRAME_FLAG_COMPRESSED;
+                }
+                out.encoded[i] = FrameManager::getFrameCount(payload.size()) <= BATCH_MAX_MESSAGE_FRAMES;
+            }
+        });
+    }
+
+    return encodeTranscoded(out);
+}
+
+bool BatchEncoder::encodeLarge(const std::string& message, FrameBatch& out) {
+    out.clear();
+
+    // Windows-1251 однобайтовая, поэтому резать можно по любой границе
+    std::string encodedMessage;
+    FrameManager frameManager;
+    if (!frameManager.encodeMessage(message, encodedMessage) || encodedMessage.empty()) {
+        return false;
+    }
+
+    const size_t pieceSize = static_cast<size_t>(BATCH_MAX_MESSAGE_FRAMES) * FRAME_DATA_SIZE;
+    const size_t count = (encodedMessage.size() + pieceSize - 1) / pieceSize;
+
+    m_payloads.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_payloads[i].assign(encodedMessage, i * pieceSize, pieceSize);
+    }
+    out.messageFlags.assign(count, 0);
+    out.encoded.assign(count, 1);
+
+    return encodeTranscoded(out);
+}
+
+bool BatchEncoder::encodeTranscoded(FrameBatch& out) {
+    const size_t messageCount = out.encoded.size();
+
+    out.firstFrame.resize(messageCount + 1);
+    size_t frameCount = 0;
+    for (size_t i = 0; i < messageCount; i++) {
+        out.firstFrame[i] = static_cast<uint32_t>(frameCount);
+        if (out.encoded[i]) {
+            frameCount += FrameManager::getFrameCount(m_payloads[i].size());
+            out.messageFlags[i] |= static_cast<uint8_t>((m_nextTag++ << FRAME_FLAG_TAG_SHIFT) & FRAME_FLAG_TAG_MASK);
+            out.messageFlags[i] |= static_cast<uint8_t>(m_channel << FRAME_FLAG_CHANNEL_SHIFT);
+        }
+    }
+    out.channel = m_channel;
+    out.firstFrame[messageCount] = static_cast<uint32_t>(frameCount);
+
+    if (frameCount == 0) {
+        return false;
+    }
+
+    out.frames.resize(frameCount);
+    for (size_t i = 0; i < messageCount; i++) {
+        const uint32_t first = out.firstFrame[i];
+        const uint32_t total = out.firstFrame[i + 1] - first;
+        for (uint32_t k = 0; k < total; k++) {
+            FrameSpan& span = out.frames[first + k];
+            span.message = static_cast<uint32_t>(i);
+            span.sequence = static_cast<uint8_t>(k + 1);
+            span.total = static_cast<uint8_t>(total);
+        }
+    }
+
+    auto frameData = [&](const FrameSpan& span, size_t& length) {
+        const std::string& payload = m_payloads[span.message];
+        size_t offset = static_cast<size_t>(span.sequence - 1) * FRAME_DATA_SIZE;
+        length = std::min<size_t>(FRAME_DATA_SIZE, payload.size() - offset);
+        return reinterpret_cast<const uint8_t*>(payload.data()) + offset;
+    };
+
+    // fcs и точная длина каждого кадра
+    m_fcs.resize(frameCount * BATCH_FCS_STRIDE);
+    {
+        TRACE_SCOPE_ARG("batchHamming", frameCount);
+        parallelFor(frameCount, BATCH_CHUNK_FRAMES, [&](size_t begin, size_t end) {
+            // полные кадры порции - одним вызовом пакетного ядра, последние кадры сообщений - по одному
+            const uint8_t* fullData[BATCH_CHUNK_FRAMES];
+            uint8_t* fullFcs[BATCH_CHUNK_FRAMES];
+            size_t fullCount = 0;
+
+            for (size_t f = begin; f < end; f++) {
+                size_t length;
+                const uint8_t* data = frameData(out.frames[f], length);
+                uint8_t* fcs = &m_fcs[f * BATCH_FCS_STRIDE];
+                if (length == FRAME_DATA_SIZE) {
+                    fullData[fullCount] = data;
+                    fullFcs[fullCount] = fcs;
+                    fullCount++;
+                } else {
+                    HammingEncoder::calculateControlBits(data, length, fcs);
+                }
+            }
+            if (fullCount > 0) {
+                HammingBatch::encode(fullData, fullFcs, fullCount);
+            }
+
+            for (size_t f = begin; f < end; f++) {
+                FrameSpan& span = out.frames[f];
+                size_t length;
+                const uint8_t* data = frameData(span, length);
+                const uint8_t* fcs = &m_fcs[f * BATCH_FCS_STRIDE];
+                size_t fcsSize = HammingEncoder::fcsSize(length);
+                span.length = static_cast<uint32_t>(FrameManager::stuffedFrameSize(
+                    span.total, span.sequence, out.messageFlags[span.message], data, length, fcs, fcsSize, m_framing));
+            }
+        });
+    }
+
+    size_t arenaSize = 0;
+    for (FrameSpan& span : out.frames) {
+        span.offset = static_cast<uint32_t>(arenaSize);
+        arenaSize += span.length;
+    }
+    out.arena.resize(arenaSize);
+
+    // каждая порция пишет свои кадры на заранее известное место
+    {
+        TRACE_SCOPE_ARG("batchStuff", arenaSize);
+        parallelFor(frameCount, BATCH_CHUNK_FRAMES, [&](size_t begin, size_t end) {
+            for (size_t f = begin; f < end; f++) {
+                const FrameSpan& span = out.frames[f];
+                size_t length;
+                const uint8_t* data = frameData(span, length);
+
+                FrameManager::stuffFrame(span.total, span.sequence, out.messageFlags[span.message], data, length,
+                                         &m_fcs[f * BATCH_FCS_STRIDE], HammingEncoder::fcsSize(length),
+                                         &out.arena[span.offset], m_framing);
+            }
+        });
+    }
+
+    return true;
+}
+
+void BatchEncoder::parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)>& task) {
+    const size_t chunks = (count + chunk - 1) / chunk;
+    if (chunks <= 1) {
+        if (count > 0) {
+            task(0, count);
+        }
+        return;
+    }
+
+    std::vector<std::future<void>> done;
+    done.reserve(chunks - 1);
+
+    for (size_t c = 1; c < chunks; c++) {
+        auto promise = std::make_shared<std::promise<void>>();
+        done.push_back(promise->get_future());
+
+        size_t begin = c * chunk;
+        size_t end = std::min(count, begin + chunk);
+        m_pool.submit([&task, begin, end, promise]() {
+            task(begin, end);
+            promise->set_value();
+        });
+    }
+
+    // первая порция - в вызывающем потоке
+    task(0, std::min(count, chunk));
+
+    for (std::future<void>& future : done) {
+        future.wait();
+    }
+}
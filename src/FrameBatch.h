@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "FrameManager.h"
+#include "ThreadPool.h"
+
+#define BATCH_CHUNK_FRAMES 64 // кадров в одной задаче пула
+#define BATCH_MAX_MESSAGE_FRAMES FRAME_MAX_COUNT
+#define BATCH_FCS_STRIDE 2 // fcs полного кадра (64 байта данных) - 2 байта
+
+struct FrameSpan {
+    uint32_t offset;    // начало кадра в FrameBatch::arena
+    uint32_t length;    // длина со стаффингом
+    uint32_t message;   // номер сообщения в пакете
+    uint8_t sequence;
+    uint8_t total;
+};
+
+// Закодированный пакет: кадры со стаффингом лежат в arena подряд, без промежутков,
+// поэтому весь пакет можно записать в порт одним вызовом, а отдельный кадр - по frames.
+struct FrameBatch {
+    std::string arena;
+    std::vector<FrameSpan> frames;
+    std::vector<uint32_t> firstFrame;   // первый кадр каждого сообщения; последний элемент - frames.size()
+    std::vector<uint8_t> messageFlags;  // флаги кадров сообщения (FRAME_FLAG_COMPRESSED, метка, канал)
+    std::vector<uint8_t> encoded;       // 0 - сообщение не закодировано (ошибка кодировки или больше 255 кадров)
+    uint8_t channel = 0;                // логический канал всех сообщений пакета
+
+    size_t messageCount() const { return encoded.size(); }
+    size_t frameCount(size_t message) const { return firstFrame[message + 1] - firstFrame[message]; }
+
+    void clear();
+};
+
+// Пакетное кодирование: перекодировка (и сжатие) сообщений, Хэмминг и байт-стаффинг
+// идут в пуле порциями по BATCH_CHUNK_FRAMES кадров. Сначала считаются fcs и точная
+// длина каждого кадра, затем по префиксным суммам все порции пишут кадры прямо на их
+// место в общем буфере. Вызывающий поток ждёт пул, поэтому из задач того же пула не вызывать.
+class BatchEncoder {
+public:
+    explicit BatchEncoder(ThreadPool& pool) : m_pool(pool) {}
+
+    void setFramingMode(FramingMode framing) { m_framing = framing; }
+
+    // логический канал следующих пакетов (0..FRAME_CHANNEL_COUNT-1)
+    void setChannel(uint8_t channel) { m_channel = channel % FRAME_CHANNEL_COUNT; }
+
+    // сообщения в UTF-8; false - ни одно сообщение не закодировано
+    bool encode(const std::vector<std::string>& messages, FrameBatch& out, bool compress = false);
+
+    // одно большое сообщение: режется на сообщения по BATCH_MAX_MESSAGE_FRAMES кадров
+    bool encodeLarge(const std::string& message, FrameBatch& out);
+
+private:
+    bool encodeTranscoded(FrameBatch& out);
+
+    // вызывает task(begin, end) для порций [0, count) в пуле и ждёт завершения всех
+    void parallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)>& task);
+
+    ThreadPool& m_pool;
+    uint8_t m_nextTag = 0;  // метка следующего сообщения (FRAME_FLAG_TAG_MASK)
+    uint8_t m_channel = 0;
+    FramingMode m_framing = FramingMode::Escaped;
+
+    // рабочие буферы между вызовами
+    std::vector<std::string> m_payloads;       // Windows-1251 (или сжатые) данные сообщений
+    std::vector<uint8_t> m_fcs;                // fcs кадров, по BATCH_FCS_STRIDE байтов на кадр
+};
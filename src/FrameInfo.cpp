@@ -2,16 +2,21 @@
 #include "Frame.h"
 #include "FrameManager.h"
 #include <QDateTime>
+#include <QHeaderView>
 #include <QScrollBar>
 
 FrameInfoDialog::FrameInfoDialog(QWidget *parent)
     : QDialog()
+    , m_model(new FrameTableModel(m_store, this))
 {
     setupUI();
     setWindowTitle("Структура переданных кадров");
-    setFixedSize(780, 400);
+    resize(900, 600);
 
     setModal(false);
+
+    connect(&m_syncTimer, &QTimer::timeout, this, &FrameInfoDialog::onSyncView);
+    m_syncTimer.start(FRAME_VIEW_SYNC_INTERVAL_MS);
 }
 
 FrameInfoDialog::~FrameInfoDialog()
@@ -22,11 +27,56 @@ void FrameInfoDialog::setupUI()
 {
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
 
+    m_sequenceFilter = new QSpinBox(this);
+    m_sequenceFilter->setRange(0, 255);
+    m_sequenceFilter->setSpecialValueText("любой");
+
+    m_fcsFilter = new QComboBox(this);
+    m_fcsFilter->addItem("любая", 0);
+    m_fcsFilter->addItem("1 байт", 1);
+    m_fcsFilter->addItem("2 байта", 2);
+
+    m_outcomeFilter = new QComboBox(this);
+    m_outcomeFilter->addItem("любой", -1);
+    for (FrameOutcome outcome : {FrameOutcome::Sent, FrameOutcome::NoErrors, FrameOutcome::Corrected,
+                                 FrameOutcome::DoubleError, FrameOutcome::Empty}) {
+        m_outcomeFilter->addItem(FrameTableModel::outcomeName(outcome), static_cast<int>(outcome));
+    }
+
+    connect(m_sequenceFilter, QOverload<int>::of(&QSpinBox::valueChanged), this, &FrameInfoDialog::onFilterChanged);
+    connect(m_fcsFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FrameInfoDialog::onFilterChanged);
+    connect(m_outcomeFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &FrameInfoDialog::onFilterChanged);
+
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(new QLabel("Номер кадра:"));
+    filterLayout->addWidget(m_sequenceFilter);
+    filterLayout->addWidget(new QLabel("Контрольная сумма:"));
+    filterLayout->addWidget(m_fcsFilter);
+    filterLayout->addWidget(new QLabel("Результат:"));
+    filterLayout->addWidget(m_outcomeFilter);
+    filterLayout->addStretch();
+
+    m_tableView = new QTableView(this);
+    m_tableView->setModel(m_model);
+    m_tableView->setFont(QFont("Courier New", 9));
+    m_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_tableView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_tableView->setWordWrap(false);
+    m_tableView->verticalHeader()->setVisible(false);
+    // фиксированная высота строк, чтобы представление не измеряло каждую строку
+    m_tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_tableView->verticalHeader()->setDefaultSectionSize(20);
+    m_tableView->horizontalHeader()->setStretchLastSection(true);
+    connect(m_tableView->selectionModel(), &QItemSelectionModel::currentRowChanged,
+            this, &FrameInfoDialog::onCurrentRowChanged);
+
     m_textEdit = new QTextEdit(this);
     m_textEdit->setFont(QFont("Courier New", 9));
     m_textEdit->setReadOnly(true);
+    m_textEdit->setMaximumHeight(150);
 
-    m_textEdit->setPlaceholderText("Здесь будет выведена структура переданных кадров...");
+    m_textEdit->setPlaceholderText("Выберите кадр, чтобы увидеть его структуру...");
 
     m_clearButton = new QPushButton("Очистить", this);
     connect(m_clearButton, &QPushButton::clicked, this, &FrameInfoDialog::onClearText);
@@ -37,19 +87,80 @@ void FrameInfoDialog::setupUI()
     buttonLayout->addStretch();
 
     mainLayout->addWidget(new QLabel("Структура переданных кадров:"));
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(m_tableView);
     mainLayout->addWidget(m_textEdit);
     mainLayout->addLayout(buttonLayout);
 }
 
-void FrameInfoDialog::addTransmittedFrame(int current, int total, size_t stuffedFcsSize, const std::string& stuffedFrame)
+void FrameInfoDialog::addTransmittedFrame(int current, int total, size_t fcsSize, size_t stuffedFcsSize, const std::string& stuffedFrame)
+{
+    m_store.append(FrameDirection::Transmitted, FrameOutcome::Sent, current, total,
+                   fcsSize, stuffedFcsSize, stuffedFrame);
+}
+
+void FrameInfoDialog::addReceivedFrame(int sequence, int total, size_t fcsSize, size_t stuffedFcsSize,
+                                       int correctionResult, const std::string& stuffedFrame)
+{
+    m_store.append(FrameDirection::Received, FrameStore::outcomeFromCorrection(correctionResult),
+                   sequence, total, fcsSize, stuffedFcsSize, stuffedFrame);
+}
+
+void FrameInfoDialog::onSyncView()
+{
+    if (!isVisible()) {
+        return;
+    }
+
+    QScrollBar *scrollBar = m_tableView->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    m_model->syncWithStore();
+
+    if (atBottom) {
+        m_tableView->scrollToBottom();
+    }
+}
+
+void FrameInfoDialog::onFilterChanged()
+{
+    FrameFilter filter;
+    filter.sequence = m_sequenceFilter->value();
+    filter.fcsSize = m_fcsFilter->currentData().toInt();
+    filter.outcome = m_outcomeFilter->currentData().toInt();
+
+    m_textEdit->clear();
+    m_model->setFilter(filter);
+}
+
+void FrameInfoDialog::onCurrentRowChanged(const QModelIndex &current)
+{
+    if (!current.isValid()) {
+        m_textEdit->clear();
+        return;
+    }
+
+    size_t storeRow = m_model->storeIndex(current.row());
+    const FrameRecordInfo &info = m_store.info(storeRow);
+    const uint8_t *bytes = m_store.bytes(storeRow);
+
+    m_textEdit->setPlainText(formatFrameStructure(info, std::string(bytes, bytes + info.length)));
+}
+
+QString FrameInfoDialog::formatFrameStructure(const FrameRecordInfo &info, const std::string& stuffedFrame) const
 {
     QString frameStructure;
     frameStructure += QString("[%1] Кадр %2/%3\n")
-                          .arg(QDateTime::currentDateTime().toString("hh:mm:ss"))
-                          .arg(current)
-                          .arg(total);
+                          .arg(QDateTime::fromMSecsSinceEpoch(info.timestampMs).toString("hh:mm:ss"))
+                          .arg(info.sequence)
+                          .arg(info.total);
+
+    if (stuffedFrame.size() < HEADER_SIZE + TRAILER_SIZE + info.stuffedFcsSize) {
+        return frameStructure;
+    }
 
     std::vector<uint8_t> stuffedBytes(stuffedFrame.begin(), stuffedFrame.end());
+    size_t stuffedFcsSize = info.stuffedFcsSize;
 
     size_t counter = 0;
 
@@ -68,6 +179,13 @@ void FrameInfoDialog::addTransmittedFrame(int current, int total, size_t stuffed
         frameStructure += QString("  Номер кадра:        0x%1 0x%2\n").arg(static_cast<uint8_t>(stuffedBytes[counter++]), 2, 16, QLatin1Char('0'))
                                                               .arg(static_cast<uint8_t>(stuffedBytes[counter++]), 2, 16, QLatin1Char('0'));
     }
+    if(stuffedBytes[counter] != ESCAPE_BYTE) {
+        frameStructure += QString("  Флаги:              0x%1\n").arg(static_cast<uint8_t>(stuffedBytes[counter++]), 2, 16, QLatin1Char('0'));
+    }
+    else {
+        frameStructure += QString("  Флаги:              0x%1 0x%2\n").arg(static_cast<uint8_t>(stuffedBytes[counter++]), 2, 16, QLatin1Char('0'))
+                                                              .arg(static_cast<uint8_t>(stuffedBytes[counter++]), 2, 16, QLatin1Char('0'));
+    }
 
     frameStructure += "  Данные:             ";
     for (size_t i = 0; i + counter < stuffedFrame.size() - 1 - stuffedFcsSize; i++) {
@@ -87,20 +205,14 @@ void FrameInfoDialog::addTransmittedFrame(int current, int total, size_t stuffed
     frameStructure += "\n";
 
     frameStructure += QString("  Флаг конца:         0x%1\n").arg(static_cast<uint8_t>(stuffedFrame.back()), 2, 16, QLatin1Char('0'));
+    frameStructure += QString("  Результат:          %1\n").arg(FrameTableModel::outcomeName(info.outcome));
 
-    frameStructure += "─────────────────────────────────────────────────────────────────────────────────────────────────────\n";
-
-    QScrollBar *scrollBar = m_textEdit->verticalScrollBar();
-    bool atBottom = scrollBar->value() == scrollBar->maximum();
-
-    m_textEdit->append(frameStructure);
-
-    if (atBottom) {
-        scrollBar->setValue(scrollBar->maximum());
-    }
+    return frameStructure;
 }
 
 void FrameInfoDialog::onClearText()
 {
     m_textEdit->clear();
+    m_store.clear();
+    m_model->reset();
 }
@@ -2,11 +2,20 @@
 
 #include <QDialog>
 #include <QTextEdit>
+#include <QTableView>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QComboBox>
+#include <QSpinBox>
 #include <QLabel>
 #include <QScrollBar>
+#include <QTimer>
+
+#include "FrameStore.h"
+#include "FrameTableModel.h"
+
+#define FRAME_VIEW_SYNC_INTERVAL_MS 200
 
 class FrameInfoDialog : public QDialog
 {
@@ -16,14 +25,28 @@ public:
     explicit FrameInfoDialog(QWidget *parent = nullptr);
     ~FrameInfoDialog();
 
-    void addTransmittedFrame(int current, int total, size_t stuffedFcsSize, const std::string& stuffedFrame);
+    void addTransmittedFrame(int current, int total, size_t fcsSize, size_t stuffedFcsSize, const std::string& stuffedFrame);
+    void addReceivedFrame(int sequence, int total, size_t fcsSize, size_t stuffedFcsSize,
+                          int correctionResult, const std::string& stuffedFrame);
 
 private slots:
     void onClearText();
+    void onFilterChanged();
+    void onSyncView();
+    void onCurrentRowChanged(const QModelIndex &current);
 
 private:
     void setupUI();
+    QString formatFrameStructure(const FrameRecordInfo &info, const std::string& stuffedFrame) const;
+
+    FrameStore m_store;
+    FrameTableModel *m_model;
 
+    QTableView *m_tableView;
     QTextEdit *m_textEdit;
+    QSpinBox *m_sequenceFilter;
+    QComboBox *m_fcsFilter;
+    QComboBox *m_outcomeFilter;
     QPushButton *m_clearButton;
+    QTimer m_syncTimer;
 };
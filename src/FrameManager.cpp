@@ -1,31 +1,69 @@
 #include "FrameManager.h"
+#include "ByteStuffer.h"
+#include "CobsStuffer.h"
 #include "EncodingConverter.h"
+#include "Compressor.h"
+#include "ChannelManager.h"
+#include <cstring>
 #include <iostream>
 
 std::vector<Frame> FrameManager::packMessage(const std::string& message) {
     std::vector<Frame> result;
-    int frameNum = 0;
 
-    std::string encodedMessage = EncodingConverter::utf8ToWindows1251(message);
-    if (encodedMessage.empty() && !message.empty()) {
-        std::cerr << "Ошибка кодировки при конвертации в Windows-1251" << std::endl;
+    std::string encodedMessage;
+    if (!encodeMessage(message, encodedMessage)) {
         return {};
     }
 
-    if(encodedMessage.length() % 64 == 0) {
-        frameNum = encodedMessage.length() / 64;
-    }
-    else {
-        frameNum = encodedMessage.length() / 64 + 1;
-    }
+    int frameNum = getFrameCount(encodedMessage.length());
+    result.reserve(frameNum);
 
     for(int i = 0; i < frameNum; i++) {
-        result.push_back(Frame(i + 1, frameNum, encodedMessage.substr(i * 64, 64)));
+        result.push_back(packFrame(encodedMessage, i, frameNum));
     }
 
     return result;
 }
 
+bool FrameManager::encodeMessage(const std::string& message, std::string& encodedMessage) {
+    encodedMessage = EncodingConverter::utf8ToWindows1251(message);
+    if (encodedMessage.empty() && !message.empty()) {
+        std::cerr << "Ошибка кодировки при конвертации в Windows-1251" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+Frame FrameManager::packFrame(const std::string& encodedMessage, int index, int total, uint8_t flags) {
+    return Frame(index + 1, total, encodedMessage.substr(index * FRAME_DATA_SIZE, FRAME_DATA_SIZE), flags);
+}
+
+int FrameManager::getFrameCount(size_t encodedLength) {
+    return static_cast<int>((encodedLength + FRAME_DATA_SIZE - 1) / FRAME_DATA_SIZE);
+}
+
+bool FrameManager::compressMessage(std::string& encodedMessage) {
+    std::string compressed;
+    if (!Compressor::compress(encodedMessage, compressed)) {
+        return false;
+    }
+    // номер кадра - один байт, поэтому сообщение не может занять больше FRAME_MAX_COUNT кадров
+    if (getFrameCount(compressed.size()) > FRAME_MAX_COUNT) {
+        return false;
+    }
+    encodedMessage = std::move(compressed);
+    return true;
+}
+
+bool FrameManager::decompressMessage(const std::string& payload, std::string& utf8Message) {
+    std::string encodedMessage;
+    if (!Compressor::decompress(payload, encodedMessage)) {
+        return false;
+    }
+    utf8Message = EncodingConverter::windows1251ToUtf8(encodedMessage);
+    return true;
+}
+
 std::string FrameManager::unpackMessage(const Frame& frame) {
     std::string receivedData = frame.dataToString();
 
@@ -40,74 +78,173 @@ std::string FrameManager::unpackMessage(const Frame& frame) {
 }
 
 std::vector<std::string> FrameManager::byteStuff(const std::vector<Frame>& frames) {
-    std::vector<std::string> result;
-
-    for(int i = 0; i < frames.size(); i++) {
-        std::vector<uint8_t> frameInBytes = frames[i].serialize();
-
-        std::vector<uint8_t> stuffedFrame;
-
-        stuffedFrame.push_back(frameInBytes.front());
-        for(int j = 1; j < frameInBytes.size() - 1; j++) {
-            if(frameInBytes[j] == START_FLAG_BYTE) {
-                stuffedFrame.push_back(ESCAPE_BYTE);
-                stuffedFrame.push_back(START_FLAG_BYTE ^ XOR_MASK);
-            }
-            else if (frameInBytes[j] == ESCAPE_BYTE) {
-                stuffedFrame.push_back(ESCAPE_BYTE);
-                stuffedFrame.push_back(ESCAPE_BYTE ^ XOR_MASK);
-            }
-            else {
-                stuffedFrame.push_back(frameInBytes[j]);
-            }
-        }
-        stuffedFrame.push_back(frameInBytes.back());
+    std::vector<std::string> result(frames.size());
 
-        result.push_back(std::string(stuffedFrame.begin(), stuffedFrame.end()));
+    for(size_t i = 0; i < frames.size(); i++) {
+        stuffFrame(frames[i], result[i]);
     }
 
     return result;
 }
 
-Frame FrameManager::byteUnstuff(const std::string& bytes) {
-    std::vector<uint8_t> stuffedBytes(bytes.begin(), bytes.end());
+// Флаг конца тоже экранируется: сжатые данные и fcs могут содержать любой байт,
+// а приёмник ищет конец кадра по первому END_FLAG_BYTE. Байт jam-сигнала - чтобы
+// серия 0xFF в данных (например, "яяяя" в Windows-1251) не была принята за jam.
+using FrameStuffer = ByteStuffer<START_FLAG_BYTE, END_FLAG_BYTE, ESCAPE_BYTE, XOR_MASK, JAM_SIGNAL_BYTE>;
 
-    std::vector<uint8_t> unstuffedBytes;
+// Исключая из кадра байт jam-сигнала, COBS сохраняет то же свойство: jam внутри кадра
+// не появится, а на приёме это просто несколько пустых кадров подряд.
+using FrameCobs = CobsStuffer<COBS_DELIMITER>;
+static_assert(COBS_DELIMITER == JAM_SIGNAL_BYTE, "разделитель COBS должен совпадать с байтом jam-сигнала");
 
-    unstuffedBytes.push_back(stuffedBytes.front());
+// COBS считается по всему кадру сразу, поэтому кадр без флагов начала и конца собирается подряд;
+// для кадров до FRAME_DATA_SIZE байт данных - на стеке
+namespace {
 
-    for(int i = 1; i < stuffedBytes.size() - 1; i++) {
-        if(stuffedBytes[i] == ESCAPE_BYTE) {
-            unstuffedBytes.push_back(stuffedBytes[++i] ^ XOR_MASK);
-        }
-        else {
-            unstuffedBytes.push_back(stuffedBytes[i]);
+class CobsFrameBuffer {
+public:
+    CobsFrameBuffer(uint8_t total, uint8_t sequence, uint8_t flags,
+                    const uint8_t* data, size_t dataSize, const uint8_t* fcs, size_t fcsSize)
+        : m_size(HEADER_SIZE - 1 + dataSize + fcsSize) {
+        if (m_size > sizeof(m_local)) {
+            m_heap.resize(m_size);
         }
+        uint8_t* frame = bytes();
+        frame[0] = total;
+        frame[1] = sequence;
+        frame[2] = flags;
+        std::memcpy(frame + HEADER_SIZE - 1, data, dataSize);
+        std::memcpy(frame + HEADER_SIZE - 1 + dataSize, fcs, fcsSize);
+    }
+
+    uint8_t* bytes() { return m_heap.empty() ? m_local : m_heap.data(); }
+    size_t size() const { return m_size; }
+
+private:
+    uint8_t m_local[HEADER_SIZE - 1 + FRAME_DATA_SIZE + sizeof(uint32_t)];
+    std::vector<uint8_t> m_heap;
+    size_t m_size;
+};
+
+} // namespace
+
+void FrameManager::stuffFrame(const Frame& frame, std::string& stuffedFrame) {
+    const std::vector<uint8_t>& data = frame.getData();
+    const std::vector<uint8_t>& fcs = frame.getFcs();
+
+    stuffedFrame.resize(maxStuffedFrameSize(data.size(), fcs.size(), m_framing));
+    size_t written = stuffFrame(frame.getTotal(), frame.getSequence(), frame.getFlags(),
+                                data.data(), data.size(), fcs.data(), fcs.size(), &stuffedFrame[0], m_framing);
+    stuffedFrame.resize(written);
+}
+
+size_t FrameManager::stuffFrame(uint8_t total, uint8_t sequence, uint8_t flags,
+                                const uint8_t* data, size_t dataSize,
+                                const uint8_t* fcs, size_t fcsSize, char* out, FramingMode framing) {
+    if (framing == FramingMode::Cobs) {
+        return cobsStuffFrame(total, sequence, flags, data, dataSize, fcs, fcsSize, out);
+    }
+
+    const uint8_t header[HEADER_SIZE - 1] = {total, sequence, flags};
+    size_t written = 0;
+
+    out[written++] = static_cast<char>(START_FLAG_BYTE);
+    written += FrameStuffer::stuffFixed<sizeof(header)>(header, out + written);
+    if (dataSize == FRAME_DATA_SIZE) {
+        written += FrameStuffer::stuffFixed<FRAME_DATA_SIZE>(data, out + written);
+    } else {
+        written += FrameStuffer::stuff(data, dataSize, out + written);
+    }
+    written += FrameStuffer::stuff(fcs, fcsSize, out + written);
+    out[written++] = static_cast<char>(END_FLAG_BYTE);
+
+    return written;
+}
+
+size_t FrameManager::maxStuffedFrameSize(size_t dataSize, size_t fcsSize, FramingMode framing) {
+    if (framing == FramingMode::Cobs) {
+        return FrameCobs::maxStuffedSize(HEADER_SIZE - 1 + dataSize + fcsSize) + 1;
+    }
+    return 1 + FrameStuffer::maxStuffedSize(HEADER_SIZE - 1 + dataSize + fcsSize) + TRAILER_SIZE;
+}
+
+size_t FrameManager::stuffedFrameSize(uint8_t total, uint8_t sequence, uint8_t flags,
+                                      const uint8_t* data, size_t dataSize,
+                                      const uint8_t* fcs, size_t fcsSize, FramingMode framing) {
+    if (framing == FramingMode::Cobs) {
+        CobsFrameBuffer frame(total, sequence, flags, data, dataSize, fcs, fcsSize);
+        return FrameCobs::stuffedSize(frame.bytes(), frame.size()) + 1;
+    }
+
+    const uint8_t header[HEADER_SIZE - 1] = {total, sequence, flags};
+    return 1 + FrameStuffer::stuffedSize(header, sizeof(header)) + FrameStuffer::stuffedSize(data, dataSize) +
+           FrameStuffer::stuffedSize(fcs, fcsSize) + TRAILER_SIZE;
+}
+
+Frame FrameManager::byteUnstuff(const std::string& bytes) {
+    if (m_framing == FramingMode::Cobs) {
+        return cobsUnstuff(bytes);
     }
-    unstuffedBytes.push_back(stuffedBytes.back());
 
     Frame result = Frame();
+    if (bytes.size() < 2) {
+        return result;
+    }
+
+    std::vector<uint8_t> unstuffedBytes(bytes.size());
+    size_t written = 0;
+
+    unstuffedBytes[written++] = static_cast<uint8_t>(bytes.front());
+    written += FrameStuffer::unstuff(bytes.data() + 1, bytes.size() - 2, unstuffedBytes.data() + written);
+    unstuffedBytes[written++] = static_cast<uint8_t>(bytes.back());
+    unstuffedBytes.resize(written);
+
     result.deserialize(unstuffedBytes);
 
     return result;
 }
 
 size_t FrameManager::getStuffedFcsSize(const std::vector<uint8_t>& fcs) {
-    std::vector<uint8_t> stuffedFcs;
-
-    for (uint8_t byte : fcs) {
-        if (byte == START_FLAG_BYTE) {
-            stuffedFcs.push_back(ESCAPE_BYTE);
-            stuffedFcs.push_back(START_FLAG_BYTE ^ XOR_MASK);
-        } else if (byte == ESCAPE_BYTE) {
-            stuffedFcs.push_back(ESCAPE_BYTE);
-            stuffedFcs.push_back(ESCAPE_BYTE ^ XOR_MASK);
-        } else {
-            stuffedFcs.push_back(byte);
-        }
+    if (m_framing == FramingMode::Cobs) {
+        return fcs.size(); // COBS копирует байты как есть
+    }
+    return FrameStuffer::stuffedSize(fcs.data(), fcs.size());
+}
+
+size_t FrameManager::cobsStuffFrame(uint8_t total, uint8_t sequence, uint8_t flags,
+                                    const uint8_t* data, size_t dataSize,
+                                    const uint8_t* fcs, size_t fcsSize, char* out) {
+    CobsFrameBuffer frame(total, sequence, flags, data, dataSize, fcs, fcsSize);
+
+    size_t written = FrameCobs::stuff(frame.bytes(), frame.size(), out);
+    out[written++] = static_cast<char>(COBS_DELIMITER);
+    return written;
+}
+
+Frame FrameManager::cobsUnstuff(const std::string& bytes) {
+    Frame result = Frame();
+
+    size_t length = bytes.size();
+    if (length > 0 && static_cast<uint8_t>(bytes.back()) == COBS_DELIMITER) {
+        length--;
+    }
+    if (length < COBS_MIN_FRAME_SIZE) {
+        return result;
     }
 
-    return stuffedFcs.size();
+    // флаги начала и конца возвращаются на место, чтобы разбор кадра был общим
+    std::vector<uint8_t> unstuffedBytes(length + 2);
+    size_t written;
+    unstuffedBytes[0] = START_FLAG_BYTE;
+    if (!FrameCobs::unstuff(bytes.data(), length, unstuffedBytes.data() + 1, written)) {
+        return result;
+    }
+    unstuffedBytes[1 + written] = END_FLAG_BYTE;
+    unstuffedBytes.resize(written + 2);
+
+    result.deserialize(unstuffedBytes);
+
+    return result;
 }
 
 bool FrameManager::isValidFrame(const std::vector<uint8_t>& data) {
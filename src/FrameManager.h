@@ -3,17 +3,58 @@
 #include "Frame.h"
 #include <vector>
 
+#define COBS_DELIMITER 0xFF // исключаемый COBS байт и разделитель кадров; совпадает с JAM_SIGNAL_BYTE
+#define COBS_MIN_FRAME_SIZE 6 // код, заголовок без флага начала, байт данных, байт fcs
+
+// Выделение кадров в потоке байтов; задаётся для линии одинаково на обоих концах
+enum class FramingMode : uint8_t {
+    Escaped,    // START_FLAG_BYTE ... END_FLAG_BYTE, внутри - байт-стаффинг ESCAPE_BYTE/XOR_MASK
+    Cobs        // COBS без байта COBS_DELIMITER, кадр завершается COBS_DELIMITER
+};
+
 class FrameManager {
 public:
     FrameManager() {};
 
+    void setFramingMode(FramingMode framing) { m_framing = framing; }
+    FramingMode getFramingMode() const { return m_framing; }
+
     std::vector<Frame> packMessage(const std::string& message);
+    bool encodeMessage(const std::string& message, std::string& encodedMessage);
+    Frame packFrame(const std::string& encodedMessage, int index, int total, uint8_t flags = 0);
+    static int getFrameCount(size_t encodedLength);
+
+    // сжимает закодированное сообщение на месте; false - сжатие не выгодно, сообщение не изменено
+    static bool compressMessage(std::string& encodedMessage);
+    // распаковывает собранное сообщение и переводит его в UTF-8
+    static bool decompressMessage(const std::string& payload, std::string& utf8Message);
     std::string unpackMessage(const Frame& frame);
     std::vector<std::string> byteStuff(const std::vector<Frame>& frames);
+    void stuffFrame(const Frame& frame, std::string& stuffedFrame);
+
+    // стаффинг кадра из готовых частей прямо в буфер; out вмещает maxStuffedFrameSize байтов,
+    // но пишется только stuffedFrameSize байтов - кадры можно класть в общий буфер вплотную
+    static size_t stuffFrame(uint8_t total, uint8_t sequence, uint8_t flags,
+                             const uint8_t* data, size_t dataSize,
+                             const uint8_t* fcs, size_t fcsSize, char* out,
+                             FramingMode framing = FramingMode::Escaped);
+    static size_t maxStuffedFrameSize(size_t dataSize, size_t fcsSize, FramingMode framing = FramingMode::Escaped);
+    static size_t stuffedFrameSize(uint8_t total, uint8_t sequence, uint8_t flags,
+                                   const uint8_t* data, size_t dataSize,
+                                   const uint8_t* fcs, size_t fcsSize,
+                                   FramingMode framing = FramingMode::Escaped);
     Frame byteUnstuff(const std::string& bytes);
 
     size_t getStuffedFcsSize(const std::vector<uint8_t>& fcs);
 
     static bool isValidFrame(const std::vector<uint8_t>& data);
     static bool isValidFrame(const std::string& data);
+
+private:
+    static size_t cobsStuffFrame(uint8_t total, uint8_t sequence, uint8_t flags,
+                                 const uint8_t* data, size_t dataSize,
+                                 const uint8_t* fcs, size_t fcsSize, char* out);
+    Frame cobsUnstuff(const std::string& bytes);
+
+    FramingMode m_framing = FramingMode::Escaped;
 };
@@ -0,0 +1,55 @@
+#include "FrameStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+void FrameStore::append(FrameDirection direction, FrameOutcome outcome, uint8_t sequence, uint8_t total,
+                        size_t fcsSize, size_t stuffedFcsSize, const std::string& bytes) {
+    size_t length = std::min<size_t>(bytes.size(), FRAME_STORE_BLOCK_SIZE);
+
+    if (m_blockUsed + length > FRAME_STORE_BLOCK_SIZE) {
+        m_blocks.emplace_back(new uint8_t[FRAME_STORE_BLOCK_SIZE]);
+        m_blockUsed = 0;
+    }
+
+    std::memcpy(m_blocks.back().get() + m_blockUsed, bytes.data(), length);
+
+    FrameRecordInfo info;
+    info.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch()).count();
+    info.offset = (m_blocks.size() - 1) * static_cast<uint64_t>(FRAME_STORE_BLOCK_SIZE) + m_blockUsed;
+    info.length = static_cast<uint16_t>(length);
+    info.sequence = sequence;
+    info.total = total;
+    info.fcsSize = static_cast<uint8_t>(fcsSize);
+    info.stuffedFcsSize = static_cast<uint8_t>(stuffedFcsSize);
+    info.direction = direction;
+    info.outcome = outcome;
+    m_index.push_back(info);
+
+    m_blockUsed += length;
+}
+
+void FrameStore::clear() {
+    m_index.clear();
+    m_blocks.clear();
+    m_blockUsed = FRAME_STORE_BLOCK_SIZE;
+}
+
+const uint8_t* FrameStore::bytes(size_t index) const {
+    uint64_t offset = m_index[index].offset;
+    return m_blocks[offset / FRAME_STORE_BLOCK_SIZE].get() + offset % FRAME_STORE_BLOCK_SIZE;
+}
+
+FrameOutcome FrameStore::outcomeFromCorrection(int correctionResult) {
+    switch (correctionResult) {
+    case 0:
+        return FrameOutcome::NoErrors;
+    case 1:
+        return FrameOutcome::Corrected;
+    case 2:
+        return FrameOutcome::DoubleError;
+    default:
+        return FrameOutcome::Empty;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FRAME_STORE_BLOCK_SIZE (1 << 20)
+
+enum class FrameDirection : uint8_t {
+    Transmitted,
+    Received
+};
+
+enum class FrameOutcome : uint8_t {
+    Sent,
+    NoErrors,
+    Corrected,
+    DoubleError,
+    Empty
+};
+
+struct FrameRecordInfo {
+    int64_t timestampMs;
+    uint64_t offset;
+    uint16_t length;
+    uint8_t sequence;
+    uint8_t total;
+    uint8_t fcsSize;
+    uint8_t stuffedFcsSize;
+    FrameDirection direction;
+    FrameOutcome outcome;
+};
+
+// Компактное хранилище кадров: байты кадров лежат подряд в блоках по 1 МБ,
+// а для каждого кадра хранится только небольшая запись с метаданными.
+class FrameStore {
+public:
+    void append(FrameDirection direction, FrameOutcome outcome, uint8_t sequence, uint8_t total,
+                size_t fcsSize, size_t stuffedFcsSize, const std::string& bytes);
+    void clear();
+
+    size_t size() const { return m_index.size(); }
+    const FrameRecordInfo& info(size_t index) const { return m_index[index]; }
+    const uint8_t* bytes(size_t index) const;
+
+    static FrameOutcome outcomeFromCorrection(int correctionResult);
+
+private:
+    std::deque<FrameRecordInfo> m_index;
+    std::vector<std::unique_ptr<uint8_t[]>> m_blocks;
+    size_t m_blockUsed = FRAME_STORE_BLOCK_SIZE;
+};
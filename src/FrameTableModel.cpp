@@ -0,0 +1,184 @@
+#include "FrameTableModel.h"
+#include <QDateTime>
+
+FrameTableModel::FrameTableModel(const FrameStore &store, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_store(store)
+{
+}
+
+int FrameTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return static_cast<int>(isFilterActive() ? m_rows.size() : m_scanned);
+}
+
+int FrameTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant FrameTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    size_t storeRow = storeIndex(index.row());
+    const FrameRecordInfo &info = m_store.info(storeRow);
+
+    switch (index.column()) {
+    case TimeColumn:
+        return QDateTime::fromMSecsSinceEpoch(info.timestampMs).toString("hh:mm:ss.zzz");
+    case DirectionColumn:
+        return info.direction == FrameDirection::Transmitted ? "→" : "←";
+    case SequenceColumn:
+        return QString("%1/%2").arg(info.sequence).arg(info.total);
+    case FcsColumn:
+        return QString("%1 байт").arg(info.fcsSize);
+    case OutcomeColumn:
+        return outcomeName(info.outcome);
+    case LengthColumn:
+        return info.length;
+    case DataColumn: {
+        const uint8_t *bytes = m_store.bytes(storeRow);
+        size_t count = std::min<size_t>(info.length, FRAME_HEX_PREVIEW_BYTES);
+        static const char digits[] = "0123456789abcdef";
+
+        QString hex;
+        hex.reserve(static_cast<int>(count * 3 + 3));
+        for (size_t i = 0; i < count; i++) {
+            hex += QLatin1Char(digits[bytes[i] >> 4]);
+            hex += QLatin1Char(digits[bytes[i] & 0x0F]);
+            hex += ' ';
+        }
+        if (count < info.length) {
+            hex += "…";
+        }
+        return hex;
+    }
+    default:
+        return QVariant();
+    }
+}
+
+QVariant FrameTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QVariant();
+    }
+
+    switch (section) {
+    case TimeColumn:
+        return "Время";
+    case DirectionColumn:
+        return "Напр.";
+    case SequenceColumn:
+        return "Кадр";
+    case FcsColumn:
+        return "КС";
+    case OutcomeColumn:
+        return "Результат";
+    case LengthColumn:
+        return "Размер";
+    case DataColumn:
+        return "Данные (hex)";
+    default:
+        return QVariant();
+    }
+}
+
+void FrameTableModel::setFilter(const FrameFilter &filter)
+{
+    beginResetModel();
+    m_filter = filter;
+    m_rows.clear();
+    m_scanned = 0;
+    endResetModel();
+
+    syncWithStore();
+}
+
+void FrameTableModel::syncWithStore()
+{
+    size_t storeSize = m_store.size();
+    if (storeSize < m_scanned) {
+        reset();
+        storeSize = m_store.size();
+    }
+    if (storeSize == m_scanned) {
+        return;
+    }
+
+    if (!isFilterActive()) {
+        beginInsertRows(QModelIndex(), static_cast<int>(m_scanned), static_cast<int>(storeSize - 1));
+        m_scanned = storeSize;
+        endInsertRows();
+        return;
+    }
+
+    std::vector<uint32_t> matched;
+    for (size_t i = m_scanned; i < storeSize; i++) {
+        if (matches(m_store.info(i))) {
+            matched.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    m_scanned = storeSize;
+
+    if (!matched.empty()) {
+        int first = static_cast<int>(m_rows.size());
+        beginInsertRows(QModelIndex(), first, first + static_cast<int>(matched.size()) - 1);
+        m_rows.insert(m_rows.end(), matched.begin(), matched.end());
+        endInsertRows();
+    }
+}
+
+void FrameTableModel::reset()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_scanned = 0;
+    endResetModel();
+}
+
+size_t FrameTableModel::storeIndex(int row) const
+{
+    return isFilterActive() ? m_rows[row] : static_cast<size_t>(row);
+}
+
+QString FrameTableModel::outcomeName(FrameOutcome outcome)
+{
+    switch (outcome) {
+    case FrameOutcome::Sent:
+        return "Передан";
+    case FrameOutcome::NoErrors:
+        return "Без ошибок";
+    case FrameOutcome::Corrected:
+        return "Исправлена ошибка";
+    case FrameOutcome::DoubleError:
+        return "Двойная ошибка";
+    default:
+        return "Пустые данные";
+    }
+}
+
+bool FrameTableModel::isFilterActive() const
+{
+    return m_filter.sequence != 0 || m_filter.fcsSize != 0 || m_filter.outcome >= 0;
+}
+
+bool FrameTableModel::matches(const FrameRecordInfo &info) const
+{
+    if (m_filter.sequence != 0 && info.sequence != m_filter.sequence) {
+        return false;
+    }
+    if (m_filter.fcsSize != 0 && info.fcsSize != m_filter.fcsSize) {
+        return false;
+    }
+    if (m_filter.outcome >= 0 && static_cast<int>(info.outcome) != m_filter.outcome) {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <vector>
+
+#include "FrameStore.h"
+
+#define FRAME_HEX_PREVIEW_BYTES 24
+
+struct FrameFilter {
+    int sequence = 0;       // 0 - любой
+    int fcsSize = 0;        // 0 - любой
+    int outcome = -1;       // -1 - любой, иначе значение FrameOutcome
+};
+
+// Модель таблицы кадров поверх FrameStore. Строки форматируются только при запросе
+// представлением, то есть для видимых строк.
+class FrameTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        TimeColumn,
+        DirectionColumn,
+        SequenceColumn,
+        FcsColumn,
+        OutcomeColumn,
+        LengthColumn,
+        DataColumn,
+        ColumnCount
+    };
+
+    explicit FrameTableModel(const FrameStore &store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setFilter(const FrameFilter &filter);
+    void syncWithStore();
+    void reset();
+
+    size_t storeIndex(int row) const;
+
+    static QString outcomeName(FrameOutcome outcome);
+
+private:
+    bool isFilterActive() const;
+    bool matches(const FrameRecordInfo &info) const;
+
+    const FrameStore &m_store;
+    FrameFilter m_filter;
+    std::vector<uint32_t> m_rows;   // используется только при активном фильтре
+    size_t m_scanned = 0;
+};
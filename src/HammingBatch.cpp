@@ -0,0 +1,82 @@
+#include "HammingBatch.h"
+#include "HammingKernel.h"
+#include "Frame.h"
+#include <atomic>
+
+static_assert(HAMMING_BATCH_FRAME_SIZE == FRAME_DATA_SIZE, "пакетное ядро считает fcs полных кадров");
+static_assert(HAMMING_BATCH_FCS_SIZE == HammingKernel<FRAME_DATA_SIZE>::FCS_SIZE, "fcs пакетного ядра и HammingKernel различаются");
+static_assert(HammingKernel<FRAME_DATA_SIZE>::CONTROL_BITS == 10, "hammingBatchFcs рассчитан на 10 контрольных битов");
+
+#ifdef HAMMING_BATCH_AVX2
+void hammingEncodeFramesAvx2(const uint8_t* const* data, uint8_t* const* fcs, size_t count);
+size_t hammingVerifyFramesAvx2(const uint8_t* const* data, const uint8_t* const* fcs, size_t count, uint8_t* mismatch);
+#endif
+
+namespace {
+
+using FrameKernel = HammingKernel<FRAME_DATA_SIZE>;
+
+bool cpuHasAvx2() {
+#if !defined(HAMMING_BATCH_AVX2)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    const bool popcnt = info[2] & (1 << 23);
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && popcnt && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+}
+
+const bool AVX2_AVAILABLE = cpuHasAvx2();
+std::atomic<bool> accelerationEnabled{true};
+
+} // namespace
+
+void HammingBatch::encode(const uint8_t* const* data, uint8_t* const* fcs, size_t count) {
+#ifdef HAMMING_BATCH_AVX2
+    if (AVX2_AVAILABLE && accelerationEnabled.load(std::memory_order_relaxed)) {
+        hammingEncodeFramesAvx2(data, fcs, count);
+        return;
+    }
+#endif
+
+    // без AVX2 свёртка масок на 64-битных словах медленнее покадрового ядра
+    // (прямолинейный код без ветвлений), поэтому кадры считаются им
+    for (size_t f = 0; f < count; f++) {
+        FrameKernel::encode(data[f], fcs[f]);
+    }
+}
+
+size_t HammingBatch::verify(const uint8_t* const* data, const uint8_t* const* fcs, size_t count, uint8_t* mismatch) {
+#ifdef HAMMING_BATCH_AVX2
+    if (AVX2_AVAILABLE && accelerationEnabled.load(std::memory_order_relaxed)) {
+        return hammingVerifyFramesAvx2(data, fcs, count, mismatch);
+    }
+#endif
+
+    size_t mismatches = 0;
+    for (size_t f = 0; f < count; f++) {
+        uint8_t expected[HAMMING_BATCH_FCS_SIZE];
+        FrameKernel::encode(data[f], expected);
+        bool bad = expected[0] != fcs[f][0] || expected[1] != fcs[f][1];
+        mismatch[f] = bad;
+        mismatches += bad;
+    }
+    return mismatches;
+}
+
+bool HammingBatch::isAccelerated() {
+    return AVX2_AVAILABLE && accelerationEnabled.load(std::memory_order_relaxed);
+}
+
+void HammingBatch::setAccelerationEnabled(bool enabled) {
+    accelerationEnabled = enabled;
+}
+
+const char* HammingBatch::implementationName() {
+    return isAccelerated() ? "AVX2" : "HammingKernel";
+}
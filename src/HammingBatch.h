@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define HAMMING_BATCH_FRAME_SIZE 64     // только полные кадры (FRAME_DATA_SIZE)
+#define HAMMING_BATCH_FCS_SIZE 2        // hammingFcsSize(HAMMING_BATCH_FRAME_SIZE)
+#define HAMMING_BATCH_GROUP 32          // кадров, которые ядро сводит за один проход
+
+// Свёртка кадра, из которой fcs получается без обхода битов. Контрольные биты - XOR позиций
+// единичных битов, позиция бита j (от старшего) байта k - 8k + j + 1, поэтому:
+// младшие три контрольных бита зависят только от XOR всех байтов кадра, а старшие - от того,
+// у каких байтов нечётны семь старших битов (вклад 8k) и установлен младший бит (вклад 8k + 8).
+struct HammingFrameMasks {
+    uint64_t parity;    // бит k - чётность байта k
+    uint64_t low;       // бит k - младший бит байта k
+    uint8_t xorByte;    // XOR всех байтов
+};
+
+// Функции ниже со внутренней компоновкой: файл с AVX2 собирается с другими флагами,
+// и общая (inline) копия могла бы достаться остальному коду в варианте с AVX2.
+static inline uint32_t hammingBatchParity(uint64_t value) {
+#ifdef _MSC_VER
+    return static_cast<uint32_t>(__popcnt64(value) & 1);
+#else
+    return static_cast<uint32_t>(__builtin_parityll(value));
+#endif
+}
+
+// вклад XOR всех байтов в упакованный fcs: контрольные биты 0..2 (биты 15..13;
+// от битов j = 0, 2, 4, 6 - позиций 1, 3, 5, 7 - и т.д.) и его чётность в бите общей чётности (бит 5)
+struct HammingBatchXorTable {
+    uint16_t packed[256];
+};
+
+static constexpr HammingBatchXorTable makeHammingBatchXorTable() {
+    HammingBatchXorTable table{};
+    for (uint32_t x = 0; x < 256; x++) {
+        uint32_t bits[8] = {};
+        for (uint32_t b = 0; b < 8; b++) {
+            bits[b] = (x >> b) & 1;
+        }
+        uint32_t c0 = bits[7] ^ bits[5] ^ bits[3] ^ bits[1];
+        uint32_t c1 = bits[6] ^ bits[5] ^ bits[2] ^ bits[1];
+        uint32_t c2 = bits[4] ^ bits[3] ^ bits[2] ^ bits[1];
+        uint32_t parity = 0;
+        for (uint32_t b = 0; b < 8; b++) {
+            parity ^= bits[b];
+        }
+        table.packed[x] = static_cast<uint16_t>(c0 << 15 | c1 << 14 | c2 << 13 | parity << 5);
+    }
+    return table;
+}
+
+static constexpr HammingBatchXorTable HAMMING_BATCH_XOR_TABLE = makeHammingBatchXorTable();
+
+// fcs в том же виде, что HammingKernel<64>::encode, как 16-битное число (fcs[0] - старший байт):
+// контрольный бит i - бит 15 - i, за ними бит общей чётности (бит 5)
+static inline uint32_t hammingBatchFcs(const HammingFrameMasks& masks) {
+    // XOR номеров байтов линеен, поэтому вклады 8k и 8k + 8 сводятся в одну маску;
+    // k + 1 = 64 для k = 63 в маску не помещается и добавляется отдельно
+    const uint64_t bytes = masks.parity ^ masks.low ^ (masks.low << 1);
+
+    uint32_t high = hammingBatchParity(bytes & 0xAAAAAAAAAAAAAAAAull) << 12
+                  | hammingBatchParity(bytes & 0xCCCCCCCCCCCCCCCCull) << 11
+                  | hammingBatchParity(bytes & 0xF0F0F0F0F0F0F0F0ull) << 10
+                  | hammingBatchParity(bytes & 0xFF00FF00FF00FF00ull) << 9
+                  | hammingBatchParity(bytes & 0xFFFF0000FFFF0000ull) << 8
+                  | hammingBatchParity(bytes & 0xFFFFFFFF00000000ull) << 7
+                  | static_cast<uint32_t>(masks.low >> 63) << 6;
+
+    // общая чётность - чётность данных и всех контрольных битов
+    uint32_t packed = HAMMING_BATCH_XOR_TABLE.packed[masks.xorByte] ^ high ^ (hammingBatchParity(high) << 5);
+    return packed ^ hammingBatchParity(packed & 0xE000) << 5;
+}
+
+// Расчёт и проверка fcs многих полных кадров сразу (пакетное кодирование, проверка
+// записанного трафика). На процессорах с AVX2 кадры сводятся к HammingFrameMasks группами
+// по HAMMING_BATCH_GROUP байтовыми операциями над 32-байтовыми регистрами (HammingBatchAvx2.cpp),
+// иначе каждый кадр считает HammingKernel<FRAME_DATA_SIZE>. Вариант выбирается один раз
+// по CPUID. Результат совпадает с HammingKernel<FRAME_DATA_SIZE> бит в бит.
+class HammingBatch {
+public:
+    // fcs[f] получает HAMMING_BATCH_FCS_SIZE байтов для data[f] (HAMMING_BATCH_FRAME_SIZE байтов)
+    static void encode(const uint8_t* const* data, uint8_t* const* fcs, size_t count);
+
+    // mismatch[f] = 1, если fcs[f] не совпадает с данными (кадр нужно исправлять), иначе 0;
+    // возвращает число несовпадений
+    static size_t verify(const uint8_t* const* data, const uint8_t* const* fcs, size_t count, uint8_t* mismatch);
+
+    static bool isAccelerated();
+    // для сравнения скорости: false - всегда покадровый HammingKernel
+    static void setAccelerationEnabled(bool enabled);
+    static const char* implementationName();
+};
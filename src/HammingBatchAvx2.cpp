@@ -0,0 +1,69 @@
+// Собирается с -mavx2 -mpopcnt (/arch:AVX2), вызывается только после проверки CPUID в HammingBatch.cpp
+#include "HammingBatch.h"
+#include <immintrin.h>
+
+namespace {
+
+// чётность каждого байта - в бит 0 байта; сдвиги 16-битные, но в бит 0 попадают только биты своего байта
+inline __m256i byteParity(__m256i v) {
+    __m256i t = _mm256_xor_si256(v, _mm256_srli_epi16(v, 4));
+    t = _mm256_xor_si256(t, _mm256_srli_epi16(t, 2));
+    return _mm256_xor_si256(t, _mm256_srli_epi16(t, 1));
+}
+
+// бит 0 каждого байта -> бит маски
+inline uint32_t lowBitMask(__m256i v) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(v, 7)));
+}
+
+void reduceFrames(const uint8_t* const* data, size_t count, HammingFrameMasks* out) {
+    for (size_t f = 0; f < count; f++) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data[f]));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data[f] + 32));
+
+        HammingFrameMasks& masks = out[f];
+        masks.parity = lowBitMask(byteParity(lo)) | static_cast<uint64_t>(lowBitMask(byteParity(hi))) << 32;
+        masks.low = lowBitMask(lo) | static_cast<uint64_t>(lowBitMask(hi)) << 32;
+
+        __m256i x = _mm256_xor_si256(lo, hi);
+        __m128i x128 = _mm_xor_si128(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+        uint64_t x64 = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_xor_si128(x128, _mm_unpackhi_epi64(x128, x128))));
+        x64 ^= x64 >> 32;
+        x64 ^= x64 >> 16;
+        x64 ^= x64 >> 8;
+        masks.xorByte = static_cast<uint8_t>(x64);
+    }
+}
+
+} // namespace
+
+void hammingEncodeFramesAvx2(const uint8_t* const* data, uint8_t* const* fcs, size_t count) {
+    HammingFrameMasks masks[HAMMING_BATCH_GROUP];
+
+    for (size_t first = 0; first < count; first += HAMMING_BATCH_GROUP) {
+        size_t group = count - first < HAMMING_BATCH_GROUP ? count - first : HAMMING_BATCH_GROUP;
+        reduceFrames(data + first, group, masks);
+        for (size_t f = 0; f < group; f++) {
+            uint32_t value = hammingBatchFcs(masks[f]);
+            fcs[first + f][0] = static_cast<uint8_t>(value >> 8);
+            fcs[first + f][1] = static_cast<uint8_t>(value);
+        }
+    }
+}
+
+size_t hammingVerifyFramesAvx2(const uint8_t* const* data, const uint8_t* const* fcs, size_t count, uint8_t* mismatch) {
+    HammingFrameMasks masks[HAMMING_BATCH_GROUP];
+    size_t mismatches = 0;
+
+    for (size_t first = 0; first < count; first += HAMMING_BATCH_GROUP) {
+        size_t group = count - first < HAMMING_BATCH_GROUP ? count - first : HAMMING_BATCH_GROUP;
+        reduceFrames(data + first, group, masks);
+        for (size_t f = 0; f < group; f++) {
+            const uint8_t* received = fcs[first + f];
+            bool bad = hammingBatchFcs(masks[f]) != (static_cast<uint32_t>(received[0]) << 8 | received[1]);
+            mismatch[first + f] = bad;
+            mismatches += bad;
+        }
+    }
+    return mismatches;
+}
@@ -0,0 +1,133 @@
+#include "Frame.h"
+#include "HammingBatch.h"
+#include "HammingKernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Скорость расчёта fcs полных кадров в одном потоке: покадровый HammingKernel и пакетный
+// HammingBatch (без AVX2 - тот же HammingKernel по кадрам, и, если процессор поддерживает, AVX2). Для каждого варианта
+// проверяется, что fcs совпадают с HammingKernel бит в бит и что проверка находит все
+// искажённые кадры.
+// Использование: hamming_bench [--frames N] [--repeat N] [--corrupt P] [--seed N]
+
+namespace {
+
+double measure(int repeat, const std::function<void()>& run) {
+    run(); // прогрев
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repeat;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    using FrameKernel = HammingKernel<FRAME_DATA_SIZE>;
+
+    size_t frameCount = 65536;
+    int repeat = 20;
+    double corruptRate = 0.01;
+    unsigned seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frameCount = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--corrupt") == 0 && i + 1 < argc) {
+            corruptRate = std::min(1.0, std::max(0.0, std::atof(argv[++i])));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Неизвестный параметр: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937 random(seed);
+    std::vector<uint8_t> data(frameCount * FRAME_DATA_SIZE);
+    for (uint8_t& byte : data) {
+        byte = static_cast<uint8_t>(random());
+    }
+
+    std::vector<uint8_t> reference(frameCount * FrameKernel::FCS_SIZE);
+    std::vector<uint8_t> fcs(reference.size());
+    std::vector<const uint8_t*> frames(frameCount);
+    std::vector<uint8_t*> fcsOut(frameCount);
+    std::vector<const uint8_t*> fcsIn(frameCount);
+    for (size_t f = 0; f < frameCount; f++) {
+        frames[f] = &data[f * FRAME_DATA_SIZE];
+        fcsOut[f] = &fcs[f * FrameKernel::FCS_SIZE];
+        fcsIn[f] = &reference[f * FrameKernel::FCS_SIZE];
+        FrameKernel::encode(frames[f], &reference[f * FrameKernel::FCS_SIZE]);
+    }
+
+    // искажённые кадры (по одному биту) для проверки verify
+    std::vector<uint8_t> corrupted = data;
+    std::vector<const uint8_t*> corruptedFrames(frameCount);
+    std::bernoulli_distribution corrupt(corruptRate);
+    size_t corruptedCount = 0;
+    for (size_t f = 0; f < frameCount; f++) {
+        corruptedFrames[f] = &corrupted[f * FRAME_DATA_SIZE];
+        if (corrupt(random)) {
+            corrupted[f * FRAME_DATA_SIZE + random() % FRAME_DATA_SIZE] ^= static_cast<uint8_t>(1u << (random() % 8));
+            corruptedCount++;
+        }
+    }
+    std::vector<uint8_t> mismatch(frameCount);
+
+    const double megabytes = static_cast<double>(data.size()) / 1e6;
+    std::cout << "Кадров:             " << frameCount << " по " << FRAME_DATA_SIZE << " байтов, искажено "
+              << corruptedCount << std::endl;
+
+    double kernelSeconds = measure(repeat, [&]() {
+        for (size_t f = 0; f < frameCount; f++) {
+            FrameKernel::encode(frames[f], fcsOut[f]);
+        }
+    });
+    std::cout << "HammingKernel:      расчёт " << megabytes / kernelSeconds << " МБ/с" << std::endl;
+
+    bool allCorrect = true;
+    const bool accelerated = HammingBatch::isAccelerated();
+
+    for (bool acceleration : {false, true}) {
+        if (acceleration && !accelerated) {
+            std::cout << "AVX2:               не поддерживается процессором" << std::endl;
+            continue;
+        }
+        HammingBatch::setAccelerationEnabled(acceleration);
+
+        std::fill(fcs.begin(), fcs.end(), 0);
+        HammingBatch::encode(frames.data(), fcsOut.data(), frameCount);
+        bool equal = fcs == reference;
+        size_t found = HammingBatch::verify(corruptedFrames.data(), fcsIn.data(), frameCount, mismatch.data());
+        size_t clean = HammingBatch::verify(frames.data(), fcsIn.data(), frameCount, mismatch.data());
+        bool correct = equal && found == corruptedCount && clean == 0;
+        allCorrect = allCorrect && correct;
+
+        double encodeSeconds = measure(repeat, [&]() {
+            HammingBatch::encode(frames.data(), fcsOut.data(), frameCount);
+        });
+        double verifySeconds = measure(repeat, [&]() {
+            HammingBatch::verify(frames.data(), fcsIn.data(), frameCount, mismatch.data());
+        });
+
+        std::cout << (acceleration ? "AVX2:               " : "Без AVX2:           ")
+                  << "расчёт " << megabytes / encodeSeconds << " МБ/с, проверка " << megabytes / verifySeconds
+                  << " МБ/с, " << (correct ? "совпадает с HammingKernel" : "РАСХОЖДЕНИЕ") << std::endl;
+    }
+    HammingBatch::setAccelerationEnabled(true);
+
+    return allCorrect ? 0 : 2;
+}
@@ -1,190 +1,122 @@
 #include "HammingEncoder.h"
-
-#include <QDebug>
-
-std::vector <uint8_t> HammingEncoder::calculateControlBits(const std::vector<uint8_t>& data) {
-    size_t amountOfControlBits = calculateRequiredBitSize(data.size());
-
-    std::vector<bool> dataBits = bytesToBits(data);
-    std::vector<bool> controlBits = calculateHammingControlBits(dataBits, amountOfControlBits);
-
-    bool overallParity = calculateOverallParity(dataBits, controlBits);
-    controlBits.push_back(overallParity);
-
-    std::vector<uint8_t> result;
-    packBitsToBytes(controlBits, result);
-
-    return result;
-}
-
-std::vector<bool> HammingEncoder::bytesToBits(const std::vector<uint8_t>& bytes) {
-    std::vector<bool> bits;
-    bits.reserve(bytes.size() * 8);
-
-    for (uint8_t byte : bytes) {
-        for (int i = 7; i >= 0; i--) {
-            bits.push_back((byte >> i) & 1);
+#include "HammingKernel.h"
+#include "Frame.h"
+
+// Полные кадры идут через HammingKernel<FRAME_DATA_SIZE>, всё остальное (последний кадр
+// сообщения) - через побайтовые таблицы: для байта с номером k позиции его битов
+// 8k+1..8k+7 не переносят разряд в 8k, поэтому их XOR раскладывается на табличную
+// младшую часть и 8k, взятое столько раз, сколько единиц в этих семи битах.
+struct HammingByteTables {
+    std::array<uint8_t, 256> lowPositions{};  // XOR (j + 1) по единичным битам j = 0..6 (от старшего)
+    std::array<uint8_t, 256> lowParity{};     // чётность тех же семи битов
+    std::array<uint8_t, 256> parity{};        // чётность байта
+};
+
+static constexpr HammingByteTables makeByteTables() {
+    HammingByteTables tables{};
+    for (size_t value = 0; value < 256; value++) {
+        uint8_t positions = 0;
+        uint8_t ones = 0;
+        for (size_t j = 0; j < 7; j++) {
+            if (value & (0x80 >> j)) {
+                positions ^= static_cast<uint8_t>(j + 1);
+                ones ^= 1;
+            }
         }
+        tables.lowPositions[value] = positions;
+        tables.lowParity[value] = ones;
+        tables.parity[value] = ones ^ (value & 1);
     }
-
-    return bits;
+    return tables;
 }
 
-std::vector<bool> HammingEncoder::calculateHammingControlBits(const std::vector<bool>& dataBits, size_t controlBitsCount) {
-    std::vector<bool> controlBits(controlBitsCount, false);
+static constexpr HammingByteTables BYTE_TABLES = makeByteTables();
 
-    for (size_t controlIndex = 0; controlIndex < controlBitsCount; controlIndex++) {
-        size_t controlBitPosition = (1 << controlIndex);
-        bool parity = false;
+uint32_t HammingEncoder::positionXor(const uint8_t* data, size_t length, uint32_t& parity) {
+    uint32_t positions = 0;
+    uint32_t ones = 0;
 
-        for (size_t dataBitIndex = 0; dataBitIndex < dataBits.size(); dataBitIndex++) {
-            size_t absolutePosition = dataBitIndex + 1;
+    for (size_t k = 0; k < length; k++) {
+        uint8_t value = data[k];
+        uint32_t base = static_cast<uint32_t>(k * 8);
 
-            if (absolutePosition & controlBitPosition) {
-                parity ^= dataBits[dataBitIndex];
-            }
-        }
-
-        controlBits[controlIndex] = parity;
+        positions ^= BYTE_TABLES.lowPositions[value];
+        positions ^= base & (0u - BYTE_TABLES.lowParity[value]);
+        positions ^= (base + 8) & (0u - (value & 1u)); // младший бит байта - позиция 8k+8
+        ones ^= BYTE_TABLES.parity[value];
     }
 
-    return controlBits;
+    parity = ones;
+    return positions;
 }
 
-size_t HammingEncoder::calculateRequiredBitSize(size_t dataByteCount) {
-    size_t amountOfControlBits = 0;
-
-    while ((1 << amountOfControlBits) < dataByteCount * 8 + 1) {
-        amountOfControlBits++;
-    }
-
-    return amountOfControlBits;
+std::vector <uint8_t> HammingEncoder::calculateControlBits(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> result(fcsSize(data.size()));
+    calculateControlBits(data.data(), data.size(), result.data());
+    return result;
 }
 
-bool HammingEncoder::calculateOverallParity(const std::vector<bool>& dataBits, const std::vector<bool>& controlBits) {
-    bool parity = false;
-
-    for (bool bit : dataBits) {
-        parity ^= bit;
-    }
+size_t HammingEncoder::calculateControlBits(const uint8_t* data, size_t length, uint8_t* fcs) {
+    using FrameKernel = HammingKernel<FRAME_DATA_SIZE>;
 
-    for (bool bit : controlBits) {
-        parity ^= bit;
+    if (length == FRAME_DATA_SIZE) {
+        FrameKernel::encode(data, fcs);
+        return FrameKernel::FCS_SIZE;
     }
 
-    return parity;
-}
+    const size_t controlBitCount = hammingControlBitCount(length);
+    const size_t size = hammingFcsSize(length);
 
-bool HammingEncoder::getOverallParityFromControlBits(const std::vector<uint8_t>& controlBits, size_t hammingControlBitsCount) {
-    std::vector<bool> controlBitsBool = bytesToBits(controlBits);
+    uint32_t dataParity;
+    uint32_t controlBits = positionXor(data, length, dataParity);
 
-    if (hammingControlBitsCount < controlBitsBool.size()) {
-        return controlBitsBool[hammingControlBitsCount];
-    }
-
-    return false;
+    hammingPackFcs(controlBits, dataParity ^ hammingParity64(controlBits), controlBitCount, fcs, size);
+    return size;
 }
 
-void HammingEncoder::packBitsToBytes(const std::vector<bool>& bits, std::vector<uint8_t>& bytes) {
-    bytes.clear();
-    if (bits.empty()) return;
-
-    size_t byteCount = (bits.size() + 7) / 8;       // можно добавить if для случаев когда bytes пустой или в нем уже есть данные
-    bytes.resize(byteCount, 0);                     // и size брать готовым а не рассчитывать
-
-    for (size_t i = 0; i < bits.size(); i++) {
-        if (bits[i]) {
-            size_t byteIndex = i / 8;
-            size_t bitIndex = 7 - (i % 8);
-            bytes[byteIndex] |= (1 << bitIndex);
-        }
-    }
+size_t HammingEncoder::fcsSize(size_t length) {
+    return hammingFcsSize(length);
 }
 
 bool HammingEncoder::verifyDataWithControlBits(const std::vector<uint8_t>& data, const std::vector<uint8_t>& controlBits) {
-    std::vector<uint8_t> calculatedControlBits = calculateControlBits(data);
-
-    if (calculatedControlBits.size() != controlBits.size()) {
-        return false;
-    }
-
-    for(size_t i = 0; i < calculatedControlBits.size(); i++) {
-        if(calculatedControlBits[i] != controlBits[i]) {
-            return  false;
-        }
-    }
-
-    return true;
+    return calculateControlBits(data) == controlBits;
 }
 
 int HammingEncoder::correctErrors(std::vector<uint8_t>& data, const std::vector<uint8_t>& controlBits) {
+    using FrameKernel = HammingKernel<FRAME_DATA_SIZE>;
+
     if (data.empty()) {
         return -1;
     }
 
-    if (verifyDataWithControlBits(data, controlBits)) {
-        return 0;
+    if (data.size() == FRAME_DATA_SIZE && controlBits.size() == FrameKernel::FCS_SIZE) {
+        return FrameKernel::correct(data.data(), controlBits.data());
     }
 
-    std::vector<bool> dataBits = bytesToBits(data);
-    size_t hammingControlBitsCount = calculateRequiredBitSize(data.size());
+    const size_t controlBitCount = hammingControlBitCount(data.size());
+    const size_t dataBitCount = data.size() * 8;
 
-    size_t syndrome = 0;
-
-    for (size_t controlIndex = 0; controlIndex < hammingControlBitsCount; controlIndex++) {
-        size_t controlBitPosition = (1 << controlIndex);
-        bool calculatedParity = false;
-
-        for (size_t dataBitIndex = 0; dataBitIndex < dataBits.size(); dataBitIndex++) {
-            size_t absolutePosition = dataBitIndex + 1;
-            if (absolutePosition & controlBitPosition) {
-                calculatedParity ^= dataBits[dataBitIndex];
-            }
-        }
-
-        size_t byteIndex = controlIndex / 8;
-        size_t bitShiftIndex = 7 - (controlIndex % 8);
-        bool expectedParity = (controlBits[byteIndex] >> bitShiftIndex) & 1;
-
-        if (calculatedParity != expectedParity) {
-            syndrome |= controlBitPosition;
-        }
+    // недостающие байты fcs (повреждённый кадр) считаются нулевыми
+    uint8_t received[4] = {0, 0, 0, 0};
+    const size_t fcsSize = hammingFcsSize(data.size());
+    for (size_t i = 0; i < fcsSize && i < controlBits.size(); i++) {
+        received[i] = controlBits[i];
     }
 
-    bool expectedOverallParity = getOverallParityFromControlBits(controlBits, hammingControlBitsCount);
+    uint32_t expectedOverallParity;
+    uint32_t receivedControlBits = hammingUnpackFcs(received, fcsSize, controlBitCount, expectedOverallParity);
 
-    std::vector<bool> receivedControlBits = bytesToBits(controlBits);
-    if (receivedControlBits.size() > hammingControlBitsCount) {
-        receivedControlBits.resize(hammingControlBitsCount);
-    }
-    bool currentOverallParity = calculateOverallParity(dataBits, receivedControlBits);
+    uint32_t dataParity;
+    uint32_t syndrome = positionXor(data.data(), data.size(), dataParity) ^ receivedControlBits;
+    uint32_t currentOverallParity = dataParity ^ hammingParity64(receivedControlBits);
 
     if (syndrome == 0) {
-        if (currentOverallParity == expectedOverallParity) {
-            //qDebug() << "Ошибок не обнаружено";
-            return 0;
-        } else {
-            //qDebug() << "Обнаружена двойная ошибка";
-            return 2;
-        }
-    }
-    else if (syndrome > 0 && syndrome <= dataBits.size()) {
-        if (currentOverallParity != expectedOverallParity) {
-            dataBits[syndrome - 1] = !dataBits[syndrome - 1];
-            std::vector<uint8_t> correctedData;
-            packBitsToBytes(dataBits, correctedData);
-
-            data = std::move(correctedData);
-            //qDebug() << "Исправлена одиночная ошибка. Синдром:" << syndrome << "Позиция бита:" << syndrome;
-            return 1;
-        }
-        else {
-            //qDebug() << "Обнаружена двойная ошибка. Синдром:" << syndrome;
-            return 2;
-        }
+        return currentOverallParity == expectedOverallParity ? 0 : 2;
     }
-    else {
-        //qDebug() << "Обнаружена двойная ошибка. Синдром:" << syndrome;
-        return 2;
+    if (syndrome <= dataBitCount && currentOverallParity != expectedOverallParity) {
+        size_t bit = syndrome - 1;
+        data[bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+        return 1;
     }
+    return 2;
 }
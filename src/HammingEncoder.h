@@ -1,21 +1,21 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
 class HammingEncoder {
 public:
     static std::vector<uint8_t> calculateControlBits(const std::vector<uint8_t>& data);
+    // без выделения памяти: fcs вмещает fcsSize(length) байтов, возвращает их число
+    static size_t calculateControlBits(const uint8_t* data, size_t length, uint8_t* fcs);
+    static size_t fcsSize(size_t length);
 
     static bool verifyDataWithControlBits(const std::vector<uint8_t>& data, const std::vector<uint8_t>& controlBits);
 
     static int correctErrors(std::vector<uint8_t>& data, const std::vector<uint8_t>& controlBits);
 
 private:
-    static std::vector<bool> bytesToBits(const std::vector<uint8_t>& bytes);
-    static std::vector<bool> calculateHammingControlBits(const std::vector<bool>& dataBits, size_t controlBitsCount);
-    static size_t calculateRequiredBitSize(size_t dataBitCount);
-    static bool calculateOverallParity(const std::vector<bool>& dataBits, const std::vector<bool>& controlBits);
-    static bool getOverallParityFromControlBits(const std::vector<uint8_t>& controlBits, size_t hammingControlBitsCount);
-    static void packBitsToBytes(const std::vector<bool>& bits, std::vector<uint8_t>& bytes);
+    // общий путь для данных, длина которых не совпадает с размером полного кадра
+    static uint32_t positionXor(const uint8_t* data, size_t length, uint32_t& parity);
 };
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Код Хэмминга (SECDED) над данными кадра. Биты данных нумеруются от старшего бита
+// первого байта, позиция бита - его номер + 1. Контрольный бит i - чётность битов
+// данных, у позиции которых установлен бит i, т.е. все контрольные биты вместе -
+// это XOR позиций единичных битов. За ними в fcs идёт бит общей чётности.
+
+// число контрольных битов без бита общей чётности: 2^r >= число битов данных + 1
+constexpr size_t hammingControlBitCount(size_t dataBytes) {
+    size_t count = 0;
+    while ((static_cast<size_t>(1) << count) < dataBytes * 8 + 1) {
+        count++;
+    }
+    return count;
+}
+
+constexpr size_t hammingFcsSize(size_t dataBytes) {
+    return (hammingControlBitCount(dataBytes) + 1 + 7) / 8;
+}
+
+inline uint32_t hammingParity64(uint64_t value) {
+#ifdef _MSC_VER
+    return static_cast<uint32_t>(__popcnt64(value) & 1);
+#else
+    return static_cast<uint32_t>(__builtin_parityll(value));
+#endif
+}
+
+// контрольные биты (бит i - контрольный бит i) и бит общей чётности -> fcs, старшим битом вперёд
+inline void hammingPackFcs(uint32_t controlBits, uint32_t overallParity, size_t controlBitCount, uint8_t* fcs, size_t fcsSize) {
+    uint32_t packed = 0;
+    for (size_t i = 0; i < controlBitCount; i++) {
+        packed |= ((controlBits >> i) & 1) << (fcsSize * 8 - 1 - i);
+    }
+    packed |= overallParity << (fcsSize * 8 - 1 - controlBitCount);
+
+    for (size_t i = 0; i < fcsSize; i++) {
+        fcs[i] = static_cast<uint8_t>(packed >> ((fcsSize - 1 - i) * 8));
+    }
+}
+
+inline uint32_t hammingUnpackFcs(const uint8_t* fcs, size_t fcsSize, size_t controlBitCount, uint32_t& overallParity) {
+    uint32_t packed = 0;
+    for (size_t i = 0; i < fcsSize; i++) {
+        packed = (packed << 8) | fcs[i];
+    }
+
+    uint32_t controlBits = 0;
+    for (size_t i = 0; i < controlBitCount; i++) {
+        controlBits |= ((packed >> (fcsSize * 8 - 1 - i)) & 1) << i;
+    }
+    overallParity = (packed >> (fcsSize * 8 - 1 - controlBitCount)) & 1;
+    return controlBits;
+}
+
+// Кодер/декодер для данных фиксированной длины N байт. Число контрольных битов и маски
+// позиций для каждого из них считаются при компиляции, а данные обрабатываются 64-битными
+// словами: контрольный бит - чётность (слово & маска) по всем словам. Для N = FRAME_DATA_SIZE
+// всё разворачивается в линейный код без ветвлений.
+template <size_t N>
+class HammingKernel {
+public:
+    static constexpr size_t DATA_BITS = N * 8;
+    static constexpr size_t CONTROL_BITS = hammingControlBitCount(N);
+    static constexpr size_t FCS_SIZE = hammingFcsSize(N);
+    static constexpr size_t WORDS = (N + 7) / 8;
+
+    static_assert(N > 0, "пустые данные обрабатывает общий путь");
+    static_assert(FCS_SIZE <= 4, "fcs собирается в 32-битном слове");
+
+    static void encode(const uint8_t* data, uint8_t* fcs) {
+        uint64_t words[WORDS];
+        load(data, words);
+
+        uint32_t controlBits = computeControlBits(words);
+        uint32_t overallParity = dataParity(words) ^ hammingParity64(controlBits);
+        hammingPackFcs(controlBits, overallParity, CONTROL_BITS, fcs, FCS_SIZE);
+    }
+
+    // 0 - ошибок нет, 1 - исправлена одиночная, 2 - обнаружена двойная (как HammingEncoder::correctErrors)
+    static int correct(uint8_t* data, const uint8_t* fcs) {
+        uint64_t words[WORDS];
+        load(data, words);
+
+        uint32_t expectedOverall;
+        uint32_t receivedControlBits = hammingUnpackFcs(fcs, FCS_SIZE, CONTROL_BITS, expectedOverall);
+        uint32_t currentOverall = dataParity(words) ^ hammingParity64(receivedControlBits);
+
+        // синдром - позиция искажённого бита
+        uint32_t syndrome = computeControlBits(words) ^ receivedControlBits;
+
+        if (syndrome == 0) {
+            return currentOverall == expectedOverall ? 0 : 2;
+        }
+        if (syndrome <= DATA_BITS && currentOverall != expectedOverall) {
+            size_t bit = syndrome - 1;
+            data[bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+            return 1;
+        }
+        return 2;
+    }
+
+private:
+    using Masks = std::array<std::array<uint64_t, WORDS>, CONTROL_BITS>;
+
+    static constexpr Masks makeMasks() {
+        Masks masks{};
+        for (size_t bit = 0; bit < DATA_BITS; bit++) {
+            size_t position = bit + 1;
+            for (size_t i = 0; i < CONTROL_BITS; i++) {
+                if (position & (static_cast<size_t>(1) << i)) {
+                    masks[i][bit / 64] |= static_cast<uint64_t>(1) << (63 - bit % 64);
+                }
+            }
+        }
+        return masks;
+    }
+
+    static constexpr Masks MASKS = makeMasks();
+
+    // слова в порядке битов данных: старший бит первого байта - старший бит первого слова
+    static void load(const uint8_t* data, uint64_t (&words)[WORDS]) {
+        for (size_t w = 0; w < WORDS; w++) {
+            uint64_t word = 0;
+            for (size_t b = 0; b < 8; b++) {
+                size_t index = w * 8 + b;
+                word = (word << 8) | (index < N ? data[index] : 0);
+            }
+            words[w] = word;
+        }
+    }
+
+    static uint32_t computeControlBits(const uint64_t (&words)[WORDS]) {
+        uint32_t controlBits = 0;
+        for (size_t i = 0; i < CONTROL_BITS; i++) {
+            uint64_t acc = 0;
+            for (size_t w = 0; w < WORDS; w++) {
+                acc ^= words[w] & MASKS[i][w];
+            }
+            controlBits |= hammingParity64(acc) << i;
+        }
+        return controlBits;
+    }
+
+    static uint32_t dataParity(const uint64_t (&words)[WORDS]) {
+        uint64_t acc = 0;
+        for (size_t w = 0; w < WORDS; w++) {
+            acc ^= words[w];
+        }
+        return hammingParity64(acc);
+    }
+};
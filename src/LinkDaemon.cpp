@@ -0,0 +1,555 @@
+#include "BondedPort.h"
+#include "CaptureWriter.h"
+#include "ChannelManager.h"
+#include "Compressor.h"
+#include "EncodingConverter.h"
+#include "Metrics.h"
+#ifdef __linux__
+#include "PortDiscovery.h"
+#endif
+#include "PosixSerialPort.h"
+#include "ReceivePipeline.h"
+#include "SessionLog.h"
+#include "ThreadPool.h"
+#include "TransmitWorker.h"
+#include "VirtualSerialPort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define DAEMON_RECORD_HEADER_SIZE 4
+#define DAEMON_MAX_RECORD_SIZE (COMPRESSION_MAX_OUTPUT * 3) // больше не передать и со сжатием; символ Windows-1251 в UTF-8 - до 3 байтов
+#define DAEMON_SKIP_CHUNK_SIZE 4096 // пропуск слишком длинной записи порциями
+#define DAEMON_POLL_MS 100          // так часто проверяется запрос остановки
+#define DAEMON_LINGER_MS 1000       // после конца ввода столько ждём тишины на линии, прежде чем выйти
+
+// Шлюз без графики: открывает порт и пропускает поток сообщений через весь стек протокола
+// (кадры, код Хэмминга, сжатие, CSMA/CD). Сообщения приходят и уходят записями
+// "4 байта длины (little-endian) + текст в UTF-8" через stdin/stdout или через сокет AF_UNIX.
+// Диагностика пишется в stderr, stdout занят записями.
+// Использование: link_daemon <порт> [--baud N] [--socket путь] [--compress] [--cobs] [--csma] [--mac профиль]
+//                                   [--threads N] [--linger мс] [--log файл] [--capture файл] [--metrics]
+//                link_daemon --loopback [...]
+//                link_daemon --list-ports
+// Запись, которая после перекодировки не помещается в FRAME_MAX_COUNT кадров (со сжатием - проверяет
+// TransmitWorker), не передаётся и считается ошибкой; сеанс продолжается со следующей записи.
+// С --socket к демону подключается один клиент за раз; принятое с линии, пока клиента нет, отбрасывается.
+// Без --socket демон завершается по концу stdin, дождавшись передачи очереди и тишины на линии.
+// --log пишет журнал сеанса (события кадров, исправление ошибок, CSMA/CD) в файл NDJSON с ротацией.
+// --capture записывает сырой трафик порта (CaptureWriter); запись воспроизводится утилитой capture_replay.
+// Несколько портов через запятую (/dev/ttyS0,/dev/ttyS1) объединяются в один канал (BondedPort).
+// --loopback вместо порта открывает виртуальный кабель, дальний конец которого возвращает всё переданное.
+// --list-ports (Linux) печатает найденные в системе последовательные порты (PortDiscovery) и завершается.
+
+namespace {
+
+volatile std::sig_atomic_t g_stopRequested = 0;
+
+void onStopSignal(int) {
+    g_stopRequested = 1;
+}
+
+// false - пора останавливаться
+bool waitReady(int fd, short events) {
+    while (!g_stopRequested) {
+        pollfd descriptor{fd, events, 0};
+        int ready = poll(&descriptor, 1, DAEMON_POLL_MS);
+        if (ready > 0) {
+            return true;
+        }
+        if (ready < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+    return false;
+}
+
+// false - конец потока, ошибка или остановка
+bool readFully(int fd, char* data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        if (!waitReady(fd, POLLIN)) {
+            return false;
+        }
+        ssize_t result = read(fd, data + done, length - done);
+        if (result == 0 || (result < 0 && errno != EINTR && errno != EAGAIN)) {
+            return false;
+        }
+        if (result > 0) {
+            done += static_cast<size_t>(result);
+        }
+    }
+    return true;
+}
+
+bool writeFully(int fd, const char* data, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t result = write(fd, data + done, length - done);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN && waitReady(fd, POLLOUT)) {
+                continue;
+            }
+            return false;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+enum class RecordStatus {
+    Ready,      // запись прочитана
+    Skipped,    // запись слишком длинная и пропущена, поток можно читать дальше
+    Closed      // конец потока, ошибка или остановка
+};
+
+RecordStatus readRecord(int fd, std::string& record) {
+    uint8_t header[DAEMON_RECORD_HEADER_SIZE];
+    if (!readFully(fd, reinterpret_cast<char*>(header), sizeof(header))) {
+        return RecordStatus::Closed;
+    }
+
+    uint32_t length = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24);
+    if (length > DAEMON_MAX_RECORD_SIZE) {
+        std::cerr << "Запись длиной " << length << " байт больше допустимой (" << DAEMON_MAX_RECORD_SIZE
+                  << ") и пропущена" << std::endl;
+        char skipped[DAEMON_SKIP_CHUNK_SIZE];
+        for (uint32_t left = length; left > 0; ) {
+            uint32_t chunk = std::min<uint32_t>(left, sizeof(skipped));
+            if (!readFully(fd, skipped, chunk)) {
+                return RecordStatus::Closed;
+            }
+            left -= chunk;
+        }
+        return RecordStatus::Skipped;
+    }
+
+    record.resize(length);
+    if (length > 0 && !readFully(fd, &record[0], length)) {
+        return RecordStatus::Closed;
+    }
+    return RecordStatus::Ready;
+}
+
+bool writeRecord(int fd, const std::string& record) {
+    std::string buffer(DAEMON_RECORD_HEADER_SIZE, '\0');
+    uint32_t length = static_cast<uint32_t>(record.size());
+    for (int i = 0; i < DAEMON_RECORD_HEADER_SIZE; i++) {
+        buffer[i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+    buffer += record;
+    return writeFully(fd, buffer.data(), buffer.size());
+}
+
+int openListeningSocket(const std::string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Слишком длинный путь сокета: " << path << std::endl;
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        std::cerr << "Ошибка создания сокета: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    unlink(path.c_str()); // сокет, оставшийся от предыдущего запуска
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 1) != 0) {
+        std::cerr << "Ошибка открытия сокета " << path << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Куда пишутся принятые сообщения: stdout или текущий клиент сокета
+class RecordOutput {
+public:
+    void setFd(int fd) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fd = fd;
+    }
+
+    // false - писать некуда или получатель отключился
+    bool write(const std::string& record) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fd < 0) {
+            return false;
+        }
+        if (!writeRecord(m_fd, record)) {
+            // сокет клиента закрывается на чтение, чтобы цикл ввода увидел отключение
+            shutdown(m_fd, SHUT_RDWR);
+            m_fd = -1;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    int m_fd = -1;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string portName;
+    int baudRate = 115200;
+    std::string socketPath;
+    bool compress = false;
+    bool csma = false;
+    bool loopback = false;
+    FramingMode framing = FramingMode::Escaped;
+    size_t threads = 0;
+    int lingerMs = DAEMON_LINGER_MS;
+    std::string logFileName;
+    std::string captureFileName;
+    bool printMetrics = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baudRate = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--compress") == 0) {
+            compress = true;
+        } else if (std::strcmp(argv[i], "--cobs") == 0) {
+            framing = FramingMode::Cobs;
+        } else if (std::strcmp(argv[i], "--csma") == 0) {
+            csma = true;
+        } else if (std::strcmp(argv[i], "--mac") == 0 && i + 1 < argc) {
+            MacProfile profile;
+            if (!MacProfile::parse(argv[++i], profile)) {
+                std::cerr << "Неизвестный профиль MAC: " << argv[i] << std::endl;
+                return 1;
+            }
+            ChannelManager::getInstance().setProfile(profile);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--linger") == 0 && i + 1 < argc) {
+            lingerMs = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logFileName = argv[++i];
+        } else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            captureFileName = argv[++i];
+        } else if (std::strcmp(argv[i], "--metrics") == 0) {
+            printMetrics = true;
+        } else if (std::strcmp(argv[i], "--loopback") == 0) {
+            loopback = true;
+#ifdef __linux__
+        } else if (std::strcmp(argv[i], "--list-ports") == 0) {
+            for (const std::string& port : PortDiscovery::enumeratePorts()) {
+                std::cout << port << std::endl;
+            }
+            return 0;
+#endif
+        } else if (argv[i][0] != '-' && portName.empty()) {
+            portName = argv[i];
+        } else {
+            std::cerr << "Неизвестный параметр: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    if (portName.empty() && !loopback) {
+        std::cerr << "Использование: link_daemon <порт> [--baud N] [--socket путь] [--compress] [--cobs] [--csma]"
+                     " [--mac профиль] [--threads N] [--linger мс] [--log файл] [--capture файл] [--metrics]"
+                     " | --loopback | --list-ports"
+                  << std::endl;
+        return 1;
+    }
+
+    struct sigaction stopAction{};
+    stopAction.sa_handler = onStopSignal;
+    sigaction(SIGINT, &stopAction, nullptr);
+    sigaction(SIGTERM, &stopAction, nullptr);
+    std::signal(SIGPIPE, SIG_IGN); // отключение клиента - ошибка записи, а не завершение процесса
+
+    // журнал сеанса - единственный потребитель очереди журнала, пишет её из своего потока
+    LogQueue logQueue;
+    SessionLog sessionLog;
+    LogQueue* log = nullptr;
+    if (!logFileName.empty()) {
+        sessionLog.setSource(&logQueue);
+        if (!sessionLog.open(logFileName)) {
+            return 1;
+        }
+        log = &logQueue;
+    }
+
+    // до портов: они пишут в него, пока не закрыты
+    CaptureWriter capture;
+    if (!captureFileName.empty() && !capture.open(captureFileName)) {
+        return 1;
+    }
+
+    // порт: настоящий или виртуальный кабель с заглушкой на дальнем конце
+    std::unique_ptr<VirtualNullModem> modem;
+    PosixSerialPort serialPort;
+    SerialPort* port = &serialPort;
+    std::vector<std::unique_ptr<PosixSerialPort>> bondMembers;
+    BondedPort bond;    // после своих портов: закрывает их в деструкторе
+    std::thread echoThread;
+    std::mutex echoMutex;
+    std::condition_variable echoCondition;
+    bool echoPending = false;
+    bool echoRunning = true;
+
+    if (!loopback && portName.find(',') != std::string::npos) {
+        if (csma) {
+            std::cerr << "Эмуляция CSMA/CD не работает через объединение портов" << std::endl;
+            return 1;
+        }
+        size_t begin = 0;
+        while (begin <= portName.size()) {
+            size_t end = std::min(portName.find(',', begin), portName.size());
+            if (end > begin) {
+                bondMembers.push_back(std::make_unique<PosixSerialPort>());
+                bond.addPort(*bondMembers.back(), portName.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        bond.setFramingMode(framing);
+        port = &bond;
+    }
+    if (loopback) {
+        modem = std::make_unique<VirtualNullModem>();
+        port = &modem->endpointA();
+        portName = "VCOM-A";
+    }
+    if (!port->open(portName, baudRate)) {
+        return 1;
+    }
+    if (capture.isOpen()) {
+        port->setCaptureWriter(&capture);
+    }
+
+    if (loopback) {
+        VirtualSerialPort& plug = modem->endpointB();
+        plug.open("VCOM-LOOP", baudRate);
+        plug.startAsyncReading([&]() {
+            {
+                std::lock_guard<std::mutex> lock(echoMutex);
+                echoPending = true;
+            }
+            echoCondition.notify_one();
+        });
+        echoThread = std::thread([&]() {
+            std::string bytes;
+            std::unique_lock<std::mutex> lock(echoMutex);
+            while (echoRunning) {
+                echoCondition.wait(lock, [&]() { return echoPending || !echoRunning; });
+                echoPending = false;
+                lock.unlock();
+                bytes.clear();
+                if (plug.readReceived(bytes) > 0) {
+                    plug.writeData(bytes);
+                }
+                lock.lock();
+            }
+        });
+    }
+
+    ThreadPool pool(threads);
+    TransmitWorker transmitter(*port, pool, log);
+    ReceivePipeline receiver(pool, log);
+    transmitter.setCompressionEnabled(compress);
+    transmitter.setEmulationEnabled(csma);
+    transmitter.setFramingMode(framing);
+    receiver.setFramingMode(framing);
+    receiver.setErrorSimulation(false);
+    receiver.setMetrics(port->getMetrics());
+    ChannelManager::getInstance().setEmulationEnabled(csma);
+
+    RecordOutput output;
+    std::mutex stateMutex;
+    std::condition_variable stateCondition;
+    bool resultsReady = false;
+    bool outputRunning = true;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t delivered = 0;
+    uint64_t discarded = 0;
+    auto lastReceived = std::chrono::steady_clock::now();
+
+    // принятые сообщения уходят получателю из отдельного потока, чтобы медленный клиент не задерживал приём
+    std::thread outputThread([&]() {
+        ReceiveResults results;
+        std::unique_lock<std::mutex> lock(stateMutex);
+        while (outputRunning || resultsReady) {
+            stateCondition.wait(lock, [&]() { return resultsReady || !outputRunning; });
+            resultsReady = false;
+            lock.unlock();
+
+            receiver.takeResults(results);
+            uint64_t written = 0;
+            for (const std::string& message : results.messages) {
+                if (output.write(message)) {
+                    written++;
+                }
+            }
+
+            lock.lock();
+            delivered += written;
+            discarded += results.messages.size() - written;
+            if (!results.frames.empty()) {
+                lastReceived = std::chrono::steady_clock::now();
+            }
+        }
+    });
+
+    receiver.start(
+        [&](std::string& out) { return port->readReceived(out); },
+        [&]() {
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                resultsReady = true;
+            }
+            stateCondition.notify_one();
+        });
+    port->startAsyncReading([&]() { receiver.notifyDataAvailable(); });
+    transmitter.start(nullptr, [&](uint64_t, bool success) {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            completed++;
+            if (!success) {
+                failed++;
+            }
+        }
+        stateCondition.notify_all();
+    });
+
+    // сообщения из записей ставятся в очередь передачи; пока очередь полна, ввод не читается
+    auto pumpRecords = [&](int fd) {
+        std::string record;
+        RecordStatus status;
+        while ((status = readRecord(fd, record)) != RecordStatus::Closed) {
+            // без сжатия предел известен сразу: Windows-1251 однобайтовая, кадр - FRAME_DATA_SIZE байтов
+            if (status == RecordStatus::Ready && !compress &&
+                FrameManager::getFrameCount(EncodingConverter::utf8ToWindows1251(record).size()) > FRAME_MAX_COUNT) {
+                std::cerr << "Запись не помещается в " << FRAME_MAX_COUNT << " кадров и не передана" << std::endl;
+                status = RecordStatus::Skipped;
+            }
+            if (status == RecordStatus::Skipped) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                submitted++;
+                completed++;
+                failed++;
+                continue;
+            }
+
+            while (!g_stopRequested &&
+                   transmitter.submit(record, MessagePriority::Normal, std::chrono::milliseconds(DAEMON_POLL_MS)) == 0) {
+            }
+            if (g_stopRequested) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(stateMutex);
+            submitted++;
+        }
+    };
+
+    int exitCode = 0;
+    if (socketPath.empty()) {
+        output.setFd(STDOUT_FILENO);
+        pumpRecords(STDIN_FILENO);
+
+        // конец ввода: дожидаемся передачи очереди, затем ответов с линии
+        std::unique_lock<std::mutex> lock(stateMutex);
+        while (!g_stopRequested && completed < submitted) {
+            stateCondition.wait_for(lock, std::chrono::milliseconds(DAEMON_POLL_MS));
+        }
+        lastReceived = std::max(lastReceived, std::chrono::steady_clock::now());
+        while (!g_stopRequested &&
+               std::chrono::steady_clock::now() - lastReceived < std::chrono::milliseconds(lingerMs)) {
+            stateCondition.wait_for(lock, std::chrono::milliseconds(DAEMON_POLL_MS));
+        }
+    } else {
+        int listenFd = openListeningSocket(socketPath);
+        if (listenFd < 0) {
+            g_stopRequested = 1;
+            exitCode = 1;
+        }
+        while (!g_stopRequested && waitReady(listenFd, POLLIN)) {
+            int clientFd = accept(listenFd, nullptr, nullptr);
+            if (clientFd < 0) {
+                continue;
+            }
+            std::cerr << "Клиент подключен" << std::endl;
+            output.setFd(clientFd);
+            pumpRecords(clientFd);
+            output.setFd(-1);
+            close(clientFd);
+            std::cerr << "Клиент отключен" << std::endl;
+        }
+        if (listenFd >= 0) {
+            close(listenFd);
+            unlink(socketPath.c_str());
+        }
+    }
+
+    transmitter.stop();
+    port->stopAsyncReading();
+    receiver.stop();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        outputRunning = false;
+    }
+    stateCondition.notify_all();
+    outputThread.join();
+    output.setFd(-1);
+
+    if (echoThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(echoMutex);
+            echoRunning = false;
+        }
+        echoCondition.notify_one();
+        echoThread.join();
+        modem->endpointB().stopAsyncReading();
+    }
+    port->close();
+    port->setCaptureWriter(nullptr);
+    capture.close();
+    sessionLog.close();
+
+    std::cerr << "Передано сообщений: " << completed - failed << " из " << submitted << ", ошибок " << failed
+              << "; принято " << delivered + discarded << ", отброшено без получателя " << discarded << std::endl;
+    if (sessionLog.getDroppedCount() > 0) {
+        std::cerr << "Пропущено записей журнала сеанса: " << sessionLog.getDroppedCount() << std::endl;
+    }
+    if (capture.getDroppedBytes() > 0) {
+        std::cerr << "Потеряно байтов записи трафика: " << capture.getDroppedBytes() << std::endl;
+    }
+    if (printMetrics) {
+        std::cerr << MetricsRegistry::getInstance().toJson();
+    }
+
+    return exitCode;
+}
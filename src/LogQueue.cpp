@@ -0,0 +1,84 @@
+#include "LogQueue.h"
+#include <chrono>
+#include <cstring>
+
+static int64_t currentTimeMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+LogQueue::LogQueue()
+    : m_cells(new Cell[LOG_QUEUE_CAPACITY]) {
+    for (size_t i = 0; i < LOG_QUEUE_CAPACITY; i++) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogQueue::push(LogEvent event, bool isIncoming, int32_t a0, int32_t a1, int32_t a2) {
+    return push(event, isIncoming, nullptr, 0, a0, a1, a2);
+}
+
+bool LogQueue::push(LogEvent event, bool isIncoming, const char* text, size_t length,
+                    int32_t a0, int32_t a1, int32_t a2) {
+    LogRecord record;
+    record.timestampMs = currentTimeMs();
+    record.event = event;
+    record.isIncoming = isIncoming;
+    record.args[0] = a0;
+    record.args[1] = a1;
+    record.args[2] = a2;
+
+    if (length > LOG_TEXT_SIZE) {
+        length = LOG_TEXT_SIZE;
+        // не разрываем многобайтовый символ UTF-8 (данные кадров однобайтовые)
+        while (event != LogEvent::FrameReceived && length > 0 &&
+               (static_cast<uint8_t>(text[length]) & 0xC0) == 0x80) {
+            length--;
+        }
+        record.isTruncated = true;
+    }
+    if (length > 0) {
+        std::memcpy(record.text, text, length);
+    }
+    record.textLength = static_cast<uint8_t>(length);
+
+    return enqueue(record);
+}
+
+bool LogQueue::enqueue(const LogRecord& record) {
+    const size_t mask = LOG_QUEUE_CAPACITY - 1;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+    while (true) {
+        Cell& cell = m_cells[pos & mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.record = record;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool LogQueue::pop(LogRecord& record) {
+    Cell& cell = m_cells[m_dequeuePos & (LOG_QUEUE_CAPACITY - 1)];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+
+    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(m_dequeuePos + 1) < 0) {
+        return false;
+    }
+
+    record = cell.record;
+    cell.sequence.store(m_dequeuePos + LOG_QUEUE_CAPACITY, std::memory_order_release);
+    m_dequeuePos++;
+    return true;
+}
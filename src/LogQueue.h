@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#define LOG_TEXT_SIZE 96
+#define LOG_QUEUE_CAPACITY 4096 // должно быть степенью двойки
+
+enum class LogEvent : uint8_t {
+    Text,               // произвольный текст
+    MessageSegmented,   // text - сообщение, a0 - число кадров
+    MessageCompressed,  // a0 - байт до сжатия, a1 - после
+    FrameSent,          // a0 - номер кадра, a1 - всего кадров
+    FrameTransmitted,   // a0 - номер кадра
+    FrameFailed,        // a0 - номер кадра, a1 != 0 - после всех попыток CSMA/CD
+    ChannelBusy,        // a0 - попытка, a1 - слотов, a2 - мкс
+    Collision,          // a0 - слотов, a1 - мкс
+    JamSent,
+    JamDetected,
+    FrameReceived,      // a0 - номер кадра, a1 - всего кадров, text - данные в Windows-1251
+    CompressedFrameReceived, // a0 - номер кадра, a1 - всего кадров, a2 - байт сжатых данных
+    DecompressFailed,
+    CorrectionResult,   // a0 - результат HammingEncoder::correctErrors
+    FrameDuplicate,     // a0 - номер кадра, a1 - всего кадров
+    FrameRejected,      // a0 - номер кадра, a1 - всего кадров, a2 - байт данных
+    MessagesEvicted,    // a0 - число отброшенных незавершённых сообщений
+    MessageCompleted,   // a0 - идентификатор сообщения, a1 != 0 - все кадры переданы
+    MessageTooLong      // a0 - идентификатор сообщения, a1 - число кадров (больше FRAME_MAX_COUNT)
+};
+
+struct LogRecord {
+    int64_t timestampMs = 0;
+    LogEvent event = LogEvent::Text;
+    bool isIncoming = false;
+    bool isTruncated = false;
+    uint8_t textLength = 0;
+    int32_t args[3] = {0, 0, 0};
+    char text[LOG_TEXT_SIZE];
+};
+
+// Ограниченная lock-free очередь записей журнала (много производителей, один потребитель).
+// При переполнении запись отбрасывается, а производитель никогда не блокируется.
+class LogQueue {
+public:
+    LogQueue();
+
+    bool push(LogEvent event, bool isIncoming, int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0);
+    bool push(LogEvent event, bool isIncoming, const char* text, size_t length,
+              int32_t a0 = 0, int32_t a1 = 0, int32_t a2 = 0);
+
+    bool pop(LogRecord& record);
+
+    uint64_t takeDroppedCount() { return m_dropped.exchange(0, std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    bool enqueue(const LogRecord& record);
+
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) size_t m_dequeuePos = 0;
+    alignas(64) std::atomic<uint64_t> m_dropped{0};
+};
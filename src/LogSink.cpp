@@ -0,0 +1,171 @@
+#include "LogSink.h"
+#include "EncodingConverter.h"
+#include "Frame.h"
+#include "Tracer.h"
+#include <QDateTime>
+#include <QScrollBar>
+#include <QTextCursor>
+
+LogSink::LogSink(QTextEdit *view, QObject *parent)
+    : QObject(parent)
+    , m_view(view)
+{
+    m_view->document()->setMaximumBlockCount(LOG_MAX_LINES);
+
+    connect(&m_flushTimer, &QTimer::timeout, this, &LogSink::flush);
+    m_flushTimer.start(LOG_FLUSH_INTERVAL_MS);
+}
+
+void LogSink::post(const QString &message, bool isIncoming)
+{
+    QByteArray utf8 = message.toUtf8();
+    m_queue.push(LogEvent::Text, isIncoming, utf8.constData(), utf8.size());
+}
+
+void LogSink::flush()
+{
+    TRACE_SCOPE("logFlush");
+
+    QString batch;
+    LogRecord record;
+    int count = 0;
+
+    while (count < LOG_MAX_RECORDS_PER_FLUSH && m_queue.pop(record)) {
+        if (!batch.isEmpty()) {
+            batch += '\n';
+        }
+        batch += formatRecord(record);
+        if (m_sessionLog) {
+            m_sessionLog->record(record);
+        }
+        count++;
+    }
+
+    uint64_t dropped = m_queue.takeDroppedCount();
+    if (dropped > 0) {
+        if (m_sessionLog) {
+            m_sessionLog->reportDropped(dropped);
+        }
+        if (!batch.isEmpty()) {
+            batch += '\n';
+        }
+        batch += QString("[перегрузка] пропущено записей журнала: %1").arg(dropped);
+    }
+
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    QScrollBar *scrollBar = m_view->verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    QTextCursor cursor(m_view->document());
+    cursor.movePosition(QTextCursor::End);
+    if (!m_view->document()->isEmpty()) {
+        cursor.insertBlock();
+    }
+    cursor.insertText(batch);
+
+    if (atBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
+
+QString LogSink::formatRecord(const LogRecord &record)
+{
+    int64_t second = record.timestampMs / 1000;
+    if (second != m_cachedSecond) {
+        m_cachedSecond = second;
+        m_cachedTimestamp = QDateTime::fromMSecsSinceEpoch(record.timestampMs).toString("hh:mm:ss");
+    }
+
+    QString text = QString::fromUtf8(record.text, record.textLength);
+    if (record.isTruncated) {
+        text += "…";
+    }
+
+    const int32_t *a = record.args;
+    QString message;
+
+    switch (record.event) {
+    case LogEvent::Text:
+        message = text;
+        break;
+    case LogEvent::MessageSegmented:
+        message = QString("Сообщение:\n%1\nбыло сегментировано на %2 кадр(ов)").arg(text).arg(a[0]);
+        break;
+    case LogEvent::MessageCompressed:
+        message = QString("Сообщение сжато: %1 -> %2 байт").arg(a[0]).arg(a[1]);
+        break;
+    case LogEvent::FrameSent:
+        message = QString("Отправлен кадр %1 из %2").arg(a[0]).arg(a[1]);
+        break;
+    case LogEvent::FrameTransmitted:
+        message = QString("Кадр %1 успешно передан").arg(a[0]);
+        break;
+    case LogEvent::FrameFailed:
+        message = a[1] ? QString("Ошибка: не удалось передать кадр %1 после всех попыток").arg(a[0])
+                       : QString("Ошибка передачи кадра %1").arg(a[0]);
+        break;
+    case LogEvent::ChannelBusy:
+        message = QString("Канал занят, попытка %1. Задержка: %2 слотов (%3 мкс)").arg(a[0]).arg(a[1]).arg(a[2]);
+        break;
+    case LogEvent::Collision:
+        message = QString("Коллизия на байте! Задержка: %1 слотов (%2 мкс)").arg(a[0]).arg(a[1]);
+        break;
+    case LogEvent::JamSent:
+        message = "Отправлен JAM-сигнал";
+        break;
+    case LogEvent::JamDetected:
+        message = "Обнаружен JAM-сигнал";
+        break;
+    case LogEvent::FrameReceived:
+        text = QString::fromStdString(EncodingConverter::windows1251ToUtf8(std::string(record.text, record.textLength)));
+        if (record.isTruncated) {
+            text += "…";
+        }
+        message = QString("Получен кадр %1 из %2 с данными: %3").arg(a[0]).arg(a[1]).arg(text);
+        break;
+    case LogEvent::CompressedFrameReceived:
+        message = QString("Получен кадр %1 из %2 со сжатыми данными (%3 байт)").arg(a[0]).arg(a[1]).arg(a[2]);
+        break;
+    case LogEvent::DecompressFailed:
+        message = "Ошибка распаковки сообщения";
+        break;
+    case LogEvent::CorrectionResult:
+        switch (a[0]) {
+        case 0:
+            message = "Ошибок обнаружено не было";
+            break;
+        case 1:
+            message = "Исправлена одиночная ошибка";
+            break;
+        case 2:
+            message = "Обнаружена двойная ошибка";
+            break;
+        default:
+            message = "Были переданы пустые данные";
+        }
+        break;
+    case LogEvent::FrameDuplicate:
+        message = QString("Повтор кадра %1 из %2 отброшен").arg(a[0]).arg(a[1]);
+        break;
+    case LogEvent::FrameRejected:
+        message = QString("Кадр %1 из %2 (%3 байт) не подходит к сообщению и отброшен").arg(a[0]).arg(a[1]).arg(a[2]);
+        break;
+    case LogEvent::MessagesEvicted:
+        message = QString("Отброшено незавершённых сообщений: %1").arg(a[0]);
+        break;
+    case LogEvent::MessageCompleted:
+        message = a[1] ? QString("Сообщение #%1 передано").arg(a[0])
+                       : QString("Сообщение #%1 передано не полностью").arg(a[0]);
+        break;
+    case LogEvent::MessageTooLong:
+        message = QString("Сообщение #%1 не отправлено: %2 кадров, допустимо не больше %3")
+                      .arg(a[0]).arg(a[1]).arg(FRAME_MAX_COUNT);
+        break;
+    }
+
+    QString direction = record.isIncoming ? "←" : "→";
+    return QString("[%1] %2 %3").arg(m_cachedTimestamp, direction, message);
+}
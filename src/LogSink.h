@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTextEdit>
+#include <QTimer>
+
+#include "LogQueue.h"
+#include "SessionLog.h"
+
+#define LOG_FLUSH_INTERVAL_MS 100
+#define LOG_MAX_RECORDS_PER_FLUSH 256
+#define LOG_MAX_LINES 5000
+
+// Потребитель очереди журнала на стороне GUI: по таймеру забирает записи пачкой,
+// форматирует их и выводит в окно с ограниченным числом строк.
+class LogSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LogSink(QTextEdit *view, QObject *parent = nullptr);
+
+    LogQueue& queue() { return m_queue; }
+
+    void post(const QString &message, bool isIncoming);
+
+    // записи, выведенные в окно, дублируются в журнал сеанса; nullptr - выключить
+    void setSessionLog(SessionLog *sessionLog) { m_sessionLog = sessionLog; }
+
+private slots:
+    void flush();
+
+private:
+    QString formatRecord(const LogRecord &record);
+
+    QTextEdit *m_view;
+    QTimer m_flushTimer;
+    LogQueue m_queue;
+    SessionLog *m_sessionLog = nullptr;
+
+    int64_t m_cachedSecond = -1;
+    QString m_cachedTimestamp;
+};
@@ -0,0 +1,351 @@
+#include "BondedPort.h"
+#include "ChannelManager.h"
+#include "FrameBatch.h"
+#include "Metrics.h"
+#include "ReceivePipeline.h"
+#include "ThreadPool.h"
+#include "TransmitWorker.h"
+#include "VirtualSerialPort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define LOOPBACK_IDLE_TIMEOUT_MS 2000 // столько ждём новых сообщений, прежде чем считать остальные потерянными
+#define LOOPBACK_ALARM_PREFIX "Тревога "
+
+// Передача сообщений через виртуальный нуль-модем: TransmitWorker на конце A,
+// ReceivePipeline на конце B. Замеряет задержку сообщения от постановки в очередь
+// до сборки на приёмной стороне, пропускную способность и загрузку линии.
+// Искажения вносит только модель линии (--ber, --drop): учебная порча кадров на приёме выключена.
+// Использование: loopback_bench [--baud N] [--rx-baud N] [--unpaced] [--latency мкс] [--ber P] [--drop P]
+//                               [--messages N] [--size N] [--compress] [--batch] [--cobs] [--csma] [--mac профиль]
+//                               [--bond N] [--alarm мс] [--alarm-channel N] [--threads N] [--metrics]
+// --csma включает эмуляцию CSMA/CD: байты, слоты и интервалы выдерживаются по скорости порта;
+// --mac задаёт профиль MAC (см. MacProfile::parse).
+// --bond N соединяет концы N одинаковых кабелей в объединения портов (BondedPort) на каждой стороне.
+// --alarm мс, пока идёт основной поток (канал 0), раз в заданное время ставит короткое сообщение
+// в канал --alarm-channel (по умолчанию 1, строгий приоритет) и замеряет его задержку отдельно;
+// с --alarm-channel 0 тревоги идут в общем канале с приоритетом сообщения High.
+int main(int argc, char *argv[])
+{
+    int baudRate = 115200;
+    int rxBaudRate = 0;
+    bool paced = true;
+    LinkModel model;
+    int messageCount = 100;
+    size_t messageSize = 64;
+    bool compress = false;
+    bool batch = false;
+    bool csma = false;
+    FramingMode framing = FramingMode::Escaped;
+    int bondSize = 1;
+    int alarmIntervalMs = 0;
+    int alarmChannel = 1;
+    size_t threads = 0;
+    bool printMetrics = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baudRate = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--rx-baud") == 0 && i + 1 < argc) {
+            rxBaudRate = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--unpaced") == 0) {
+            paced = false;
+        } else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            model.latencyUs = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--ber") == 0 && i + 1 < argc) {
+            model.bitErrorRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--drop") == 0 && i + 1 < argc) {
+            model.byteDropRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--messages") == 0 && i + 1 < argc) {
+            messageCount = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            messageSize = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--compress") == 0) {
+            compress = true;
+        } else if (std::strcmp(argv[i], "--batch") == 0) {
+            batch = true;
+        } else if (std::strcmp(argv[i], "--cobs") == 0) {
+            framing = FramingMode::Cobs;
+        } else if (std::strcmp(argv[i], "--csma") == 0) {
+            csma = true;
+        } else if (std::strcmp(argv[i], "--mac") == 0 && i + 1 < argc) {
+            MacProfile profile;
+            if (!MacProfile::parse(argv[++i], profile)) {
+                std::cerr << "Неизвестный профиль MAC: " << argv[i] << std::endl;
+                return 1;
+            }
+            ChannelManager::getInstance().setProfile(profile);
+        } else if (std::strcmp(argv[i], "--bond") == 0 && i + 1 < argc) {
+            bondSize = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--alarm") == 0 && i + 1 < argc) {
+            alarmIntervalMs = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--alarm-channel") == 0 && i + 1 < argc) {
+            alarmChannel = std::atoi(argv[++i]);
+            if (alarmChannel < 0 || alarmChannel >= FRAME_CHANNEL_COUNT) {
+                std::cerr << "Номер канала - от 0 до " << FRAME_CHANNEL_COUNT - 1 << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--metrics") == 0) {
+            printMetrics = true;
+        } else {
+            std::cerr << "Неизвестный параметр: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<VirtualNullModem>> modems;
+    for (int i = 0; i < bondSize; i++) {
+        modems.push_back(std::make_unique<VirtualNullModem>(paced, model));
+    }
+
+    BondedPort bondA;
+    BondedPort bondB;
+    SerialPort* portA = &modems[0]->endpointA();
+    SerialPort* portB = &modems[0]->endpointB();
+    if (bondSize > 1) {
+        for (int i = 0; i < bondSize; i++) {
+            bondA.addPort(modems[i]->endpointA(), "VCOM-A" + std::to_string(i + 1));
+            bondB.addPort(modems[i]->endpointB(), "VCOM-B" + std::to_string(i + 1));
+        }
+        bondB.setFramingMode(framing);
+        portA = &bondA;
+        portB = &bondB;
+    }
+    portA->open(bondSize > 1 ? "BOND-A" : "VCOM-A", baudRate);
+    portB->open(bondSize > 1 ? "BOND-B" : "VCOM-B", rxBaudRate ? rxBaudRate : baudRate);
+
+    ThreadPool pool(threads);
+    TransmitWorker transmitter(*portA, pool);
+    ReceivePipeline receiver(pool);
+    transmitter.setCompressionEnabled(compress);
+    transmitter.setEmulationEnabled(csma);
+    transmitter.setFramingMode(framing);
+    receiver.setFramingMode(framing);
+    receiver.setErrorSimulation(false);
+    ChannelManager::getInstance().setEmulationEnabled(csma);
+    if (alarmChannel != 0) {
+        ChannelConfig alarmConfig;
+        alarmConfig.priority = MessagePriority::High;
+        alarmConfig.queueLimit = 4;
+        transmitter.configureChannel(static_cast<uint8_t>(alarmChannel), alarmConfig);
+    }
+    receiver.setMetrics(portB->getMetrics());
+
+    std::mutex resultsMutex;
+    std::condition_variable resultsCondition;
+    bool resultsReady = false;
+
+    receiver.start(
+        [&](std::string& out) { return portB->readReceived(out); },
+        [&]() {
+            {
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                resultsReady = true;
+            }
+            resultsCondition.notify_one();
+        });
+    portB->startAsyncReading([&]() { receiver.notifyDataAvailable(); });
+    transmitter.start(nullptr, nullptr);
+
+    // текст с кириллицей, чтобы проходить через перекодировку так же, как сообщения из GUI
+    std::string pattern = "Проверка канала 0123456789 ";
+    std::string message;
+    while (message.size() < messageSize) {
+        message += pattern;
+    }
+    message.resize(messageSize);
+
+    // не обрываем многобайтовый символ UTF-8 на границе
+    size_t lead = message.size() - 1;
+    while (lead > 0 && (static_cast<uint8_t>(message[lead]) & 0xC0) == 0x80) {
+        lead--;
+    }
+    size_t charLength = static_cast<uint8_t>(message[lead]) >= 0xC0 ? 2 : 1;
+    if (lead + charLength > message.size()) {
+        message.resize(lead);
+    }
+
+    std::vector<std::chrono::steady_clock::time_point> submitTimes(messageCount);
+    auto start = std::chrono::steady_clock::now();
+
+    std::atomic<bool> keepSubmitting{true};
+
+    std::mutex alarmMutex;
+    std::vector<std::chrono::steady_clock::time_point> alarmTimes;
+    std::thread alarmSubmitter;
+    if (alarmIntervalMs > 0) {
+        alarmSubmitter = std::thread([&]() {
+            auto next = std::chrono::steady_clock::now();
+            while (keepSubmitting) {
+                next += std::chrono::milliseconds(alarmIntervalMs);
+                std::this_thread::sleep_until(next);
+
+                std::lock_guard<std::mutex> lock(alarmMutex);
+                std::string alarm = LOOPBACK_ALARM_PREFIX + std::to_string(alarmTimes.size());
+                alarmTimes.push_back(std::chrono::steady_clock::now());
+                if (transmitter.submit(alarm, MessagePriority::High, static_cast<uint8_t>(alarmChannel)) == 0) {
+                    alarmTimes.pop_back();
+                }
+            }
+        });
+    }
+
+    std::thread submitter([&]() {
+        if (batch) {
+            // все сообщения кодируются в пуле одним пакетом и уходят в порт из общего буфера
+            auto frames = std::make_shared<FrameBatch>();
+            BatchEncoder encoder(pool);
+            encoder.setFramingMode(framing);
+            std::fill(submitTimes.begin(), submitTimes.end(), std::chrono::steady_clock::now());
+            encoder.encode(std::vector<std::string>(messageCount, message), *frames, compress);
+            transmitter.submitBatch(frames);
+            return;
+        }
+
+        for (int i = 0; i < messageCount && keepSubmitting; i++) {
+            submitTimes[i] = std::chrono::steady_clock::now();
+            while (keepSubmitting &&
+                   transmitter.submit(message, MessagePriority::Normal, std::chrono::milliseconds(100)) == 0) {
+                submitTimes[i] = std::chrono::steady_clock::now();
+            }
+        }
+    });
+
+    LatencyHistogram latency;
+    LatencyHistogram alarmLatency;
+    int alarmsReceived = 0;
+    ReceiveResults results;
+    int received = 0;
+    int intact = 0;
+    uint64_t outcomes[4] = {0, 0, 0, 0}; // без ошибок, исправлено, двойная, пустые
+    auto lastProgress = std::chrono::steady_clock::now();
+
+    while (received < messageCount) {
+        {
+            std::unique_lock<std::mutex> lock(resultsMutex);
+            resultsCondition.wait_for(lock, std::chrono::milliseconds(100), [&]() { return resultsReady; });
+            resultsReady = false;
+        }
+
+        receiver.takeResults(results);
+        auto now = std::chrono::steady_clock::now();
+
+        for (const DecodedFrame& frame : results.frames) {
+            outcomes[frame.correctionResult >= 0 && frame.correctionResult <= 2 ? frame.correctionResult : 3]++;
+        }
+        for (size_t m = 0; m < results.messages.size(); m++) {
+            const std::string& text = results.messages[m];
+            // в общем канале тревога узнаётся по длине (текст может быть искажён);
+            // задержка считается только по неискажённым
+            if (alarmIntervalMs > 0 && (alarmChannel != 0 ? results.messageChannels[m] == alarmChannel
+                                                          : text.size() < message.size() / 2)) {
+                alarmsReceived++;
+                size_t index = static_cast<size_t>(std::atoi(text.c_str() + std::strlen(LOOPBACK_ALARM_PREFIX)));
+                std::lock_guard<std::mutex> lock(alarmMutex);
+                if (index < alarmTimes.size() && text == LOOPBACK_ALARM_PREFIX + std::to_string(index)) {
+                    alarmLatency.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(now - alarmTimes[index]).count()));
+                }
+                continue;
+            }
+            if (received < messageCount) {
+                latency.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - submitTimes[received]).count()));
+            }
+            if (text == message) {
+                intact++;
+            }
+            received++;
+        }
+
+        if (!results.frames.empty()) {
+            lastProgress = now;
+        } else if (now - lastProgress > std::chrono::milliseconds(LOOPBACK_IDLE_TIMEOUT_MS)) {
+            break;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    keepSubmitting = false;
+    submitter.join();
+    if (alarmSubmitter.joinable()) {
+        alarmSubmitter.join();
+    }
+    transmitter.stop();
+    portB->stopAsyncReading();
+    receiver.stop();
+
+    // время на линии складывается по всем кабелям, поэтому загрузка объединения может превышать 100%
+    LinkStatistics link;
+    for (auto& modem : modems) {
+        LinkStatistics cable = modem->getStatistics(LinkDirection::AtoB);
+        link.bytesWritten += cable.bytesWritten;
+        link.bytesDelivered += cable.bytesDelivered;
+        link.bytesDropped += cable.bytesDropped;
+        link.bitsFlipped += cable.bitsFlipped;
+        link.wireTimeNs += cable.wireTimeNs;
+    }
+    HistogramSnapshot snapshot = latency.snapshot();
+
+    std::cout << "Режим:              " << (paced ? "темповый" : "без темпа") << ", " << baudRate << " бод"
+              << (framing == FramingMode::Cobs ? ", COBS" : "")
+              << (bondSize > 1 ? ", портов в объединении: " + std::to_string(bondSize) : "") << std::endl;
+    std::cout << "Сообщений:          " << received << " из " << messageCount << ", без искажений: " << intact << std::endl;
+    std::cout << "Кадров:             без ошибок " << outcomes[0] << ", исправлено " << outcomes[1]
+              << ", двойных " << outcomes[2] << ", пустых " << outcomes[3] << std::endl;
+    std::cout << "Байт в линию:       " << link.bytesWritten << ", доставлено " << link.bytesDelivered
+              << ", потеряно " << link.bytesDropped << ", инвертировано битов " << link.bitsFlipped << std::endl;
+    std::cout << "Время, с:           " << seconds << std::endl;
+    if (seconds > 0) {
+        std::cout << "Байт/с:             " << link.bytesWritten / seconds << std::endl;
+        std::cout << "Сообщений/с:        " << received / seconds << std::endl;
+        std::cout << "Загрузка линии, %:  " << 100.0 * link.wireTimeNs / 1e9 / seconds << std::endl;
+    }
+    std::cout << "Задержка, мкс:      среднее " << snapshot.meanNs() / 1000.0
+              << ", p50 " << snapshot.percentileNs(50) / 1000.0
+              << ", p99 " << snapshot.percentileNs(99) / 1000.0
+              << ", макс " << snapshot.maxNs / 1000.0 << std::endl;
+    if (alarmIntervalMs > 0) {
+        HistogramSnapshot alarms = alarmLatency.snapshot();
+        std::cout << "Тревог:             " << alarmsReceived << " из " << alarmTimes.size()
+                  << " (канал " << alarmChannel << "), без искажений " << alarms.count << std::endl;
+        std::cout << "Задержка тревог:    среднее " << alarms.meanNs() / 1000.0
+                  << " мкс, p99 " << alarms.percentileNs(99) / 1000.0
+                  << " мкс, макс " << alarms.maxNs / 1000.0 << " мкс" << std::endl;
+    }
+    if (csma) {
+        HistogramSnapshot lateness = portA->getMetrics()->latency(MetricStage::TimerLateness);
+        std::cout << "Коллизий:           " << ChannelManager::getInstance().getCollisionCount() << std::endl;
+        std::cout << "Опоздание таймера:  ожиданий " << lateness.count << ", среднее " << lateness.meanNs() / 1000.0
+                  << " мкс, p99 " << lateness.percentileNs(99) / 1000.0
+                  << " мкс, макс " << lateness.maxNs / 1000.0 << " мкс" << std::endl;
+    }
+
+    if (bondSize > 1) {
+        for (const BondMemberStatus& member : bondA.getStatus()) {
+            std::cout << "Порт " << member.name << ":" << std::string(std::max<int>(1, 12 - static_cast<int>(member.name.size())), ' ')
+                      << "записей " << member.unitsWritten << ", отказов " << member.failures
+                      << (member.healthy ? "" : ", исключён") << std::endl;
+        }
+    }
+
+    if (printMetrics) {
+        std::cout << MetricsRegistry::getInstance().toJson();
+    }
+
+    return received == messageCount ? 0 : 2;
+}
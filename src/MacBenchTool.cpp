@@ -0,0 +1,177 @@
+#include "ChannelManager.h"
+#include "MacSimulator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Сравнение профилей MAC на модели общей линии: для каждого числа станций и каждой
+// предлагаемой нагрузки G выводит пропускную способность S, задержку кадра и потери,
+// а в конце - профиль с наибольшей пиковой S для каждого числа станций.
+// Использование: mac_bench [--stations 2,4,8] [--profiles 1-persistent,non-persistent,...]
+//                          [--loads 0.1,0.5,1,2] [--frame-bytes N] [--baud N] [--slot-bits N]
+//                          [--propagation-bits N] [--max-attempts N] [--frames N] [--seed N]
+// Профили в --profiles разделяются ';', если в имени есть ',' (например "1-persistent,linear").
+// --slot-bits и --max-attempts заменяют slot: и attempts: из имён всех профилей.
+
+namespace {
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+// setw считает байты, а в заголовках кириллица - выравниваем по числу символов UTF-8
+std::string padLeft(const std::string& text, size_t width) {
+    size_t length = std::count_if(text.begin(), text.end(), [](char c) { return (static_cast<uint8_t>(c) & 0xC0) != 0x80; });
+    return length < width ? std::string(width - length, ' ') + text : text;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::vector<int> stationCounts = {2, 4, 8};
+    std::vector<std::string> profileNames = {"1-persistent", "non-persistent", "p-persistent:0.5",
+                                             "p-persistent:0.1", "1-persistent,linear"};
+    std::vector<double> loads = {0.1, 0.25, 0.5, 0.75, 1.0, 1.5, 2.0, 3.0, 5.0};
+    MacSimulationConfig base;
+    int slotBits = 0;       // 0 - из профиля
+    int maxAttempts = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--stations") == 0 && i + 1 < argc) {
+            stationCounts.clear();
+            for (const std::string& part : split(argv[++i], ',')) {
+                stationCounts.push_back(std::max(1, std::atoi(part.c_str())));
+            }
+        } else if (std::strcmp(argv[i], "--profiles") == 0 && i + 1 < argc) {
+            std::string list = argv[++i];
+            profileNames = split(list, list.find(';') != std::string::npos ? ';' : ',');
+        } else if (std::strcmp(argv[i], "--loads") == 0 && i + 1 < argc) {
+            loads.clear();
+            for (const std::string& part : split(argv[++i], ',')) {
+                loads.push_back(std::max(0.0, std::atof(part.c_str())));
+            }
+        } else if (std::strcmp(argv[i], "--frame-bytes") == 0 && i + 1 < argc) {
+            base.frameBytes = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            base.baudRate = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--slot-bits") == 0 && i + 1 < argc) {
+            slotBits = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--propagation-bits") == 0 && i + 1 < argc) {
+            base.propagationBits = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--max-attempts") == 0 && i + 1 < argc) {
+            maxAttempts = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            base.frameTimes = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            base.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Неизвестный параметр: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<MacProfile> profiles;
+    for (const std::string& name : profileNames) {
+        MacProfile profile;
+        if (!MacProfile::parse(name, profile)) {
+            std::cerr << "Неизвестный профиль MAC: " << name << std::endl;
+            return 1;
+        }
+        if (slotBits > 0) {
+            profile.slotTimeBits = slotBits;
+        }
+        if (maxAttempts > 0) {
+            profile.maxAttempts = maxAttempts;
+        }
+        profiles.push_back(profile);
+    }
+
+    // столбец профиля - по самому длинному имени, но не уже заголовка
+    size_t nameWidth = 24;
+    for (const MacProfile& profile : profiles) {
+        nameWidth = std::max(nameWidth, profile.name().size() + 2);
+    }
+
+    std::cout << std::fixed;
+    std::vector<std::string> summary;
+
+    for (int stations : stationCounts) {
+        std::cout << "Станций: " << stations << ", кадр " << base.frameBytes << " байт, " << base.baudRate
+                  << " бод, слот " << (slotBits > 0 ? slotBits : SLOT_TIME_BITS) << " бит, задержка распространения " << base.propagationBits << " бит" << std::endl;
+        std::cout << "Профиль" << std::string(nameWidth - 7, ' ') << padLeft("G", 7) << padLeft("S", 8)
+                  << padLeft("ср., мс", 12) << padLeft("p99, мс", 12)
+                  << padLeft("коллизий", 10) << padLeft("потеряно", 10) << padLeft("отказано", 10) << std::endl;
+
+        const MacProfile* best = nullptr;
+        double bestPeak = -1.0;
+        double bestDelay = 0.0;
+
+        for (const MacProfile& profile : profiles) {
+            double peak = 0.0;
+            double delayAtPeak = 0.0;
+
+            for (double load : loads) {
+                MacSimulationConfig config = base;
+                config.profile = profile;
+                config.stations = stations;
+                config.offeredLoad = load;
+
+                MacSimulationResult result = MacSimulator::run(config);
+                double collisionsPerFrame = result.framesDelivered
+                    ? static_cast<double>(result.collisions) / result.framesDelivered : 0.0;
+
+                std::cout << std::left << std::setw(static_cast<int>(nameWidth)) << profile.name() << std::right
+                          << std::setprecision(2) << std::setw(7) << load
+                          << std::setprecision(3) << std::setw(8) << result.throughput
+                          << std::setprecision(2) << std::setw(12) << result.delay.meanNs() / 1e6
+                          << std::setw(12) << result.delay.percentileNs(99) / 1e6
+                          << std::setw(10) << collisionsPerFrame
+                          << std::setw(10) << result.framesDropped
+                          << std::setw(10) << result.framesRejected << std::endl;
+
+                if (result.throughput > peak) {
+                    peak = result.throughput;
+                    delayAtPeak = result.delay.meanNs();
+                }
+            }
+
+            // при равной пиковой S лучше тот, у кого меньше задержка
+            if (peak > bestPeak + 1e-3 || (peak > bestPeak - 1e-3 && delayAtPeak < bestDelay)) {
+                best = &profile;
+                bestPeak = peak;
+                bestDelay = delayAtPeak;
+            }
+        }
+        std::cout << std::endl;
+
+        if (best) {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(3) << "Станций " << stations << ": " << best->name()
+                 << " (пиковая S " << bestPeak << ")";
+            summary.push_back(line.str());
+        }
+    }
+
+    std::cout << "Лучший профиль по пиковой загрузке канала:" << std::endl;
+    for (const std::string& line : summary) {
+        std::cout << "  " << line << std::endl;
+    }
+
+    return 0;
+}
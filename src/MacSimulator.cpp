@@ -0,0 +1,168 @@
+#include "MacSimulator.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Station {
+    std::deque<uint64_t> queue;         // моменты поступления кадров, в шагах
+    std::geometric_distribution<uint64_t> arrivals;
+    uint64_t nextArrival = 0;
+    uint64_t nextSense = 0;
+    int attempt = 0;
+    bool transmitting = false;
+};
+
+struct Transmission {
+    int station;
+    uint64_t start;
+    uint64_t end;       // с учётом обрыва после коллизии и jam
+    bool collided;
+    bool done;
+};
+
+uint64_t bitsToSteps(int bits) {
+    return static_cast<uint64_t>(std::max(1, (bits + UART_BITS_PER_BYTE - 1) / UART_BITS_PER_BYTE));
+}
+
+} // namespace
+
+MacSimulationResult MacSimulator::run(const MacSimulationConfig& config) {
+    MacSimulationResult result;
+
+    const MacProfile& profile = config.profile;
+    const int stationCount = std::max(1, config.stations);
+    const uint64_t frameSteps = static_cast<uint64_t>(std::max(1, config.frameBytes));
+    const uint64_t slotSteps = bitsToSteps(profile.slotTimeBits);
+    const uint64_t propagationSteps = bitsToSteps(config.propagationBits);
+    const uint64_t jamSteps = bitsToSteps(JAM_SIGNAL_SIZE);
+    const uint64_t gapSteps = bitsToSteps(INTER_FRAME_GAP_BITS);
+    const uint64_t stepNs = std::max<uint64_t>(1, ChannelManager::getByteDuration(config.baudRate).count());
+    const uint64_t horizon = static_cast<uint64_t>(std::max(1, config.frameTimes)) * frameSteps;
+
+    std::mt19937 generator(config.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // вероятность поступления кадра на станцию за шаг
+    double rate = config.offeredLoad / (static_cast<double>(stationCount) * frameSteps);
+    rate = std::min(std::max(rate, 1e-12), 0.999999); // geometric_distribution не допускает 1
+
+    std::vector<Station> stations(stationCount);
+    for (Station& station : stations) {
+        station.arrivals = std::geometric_distribution<uint64_t>(rate);
+        station.nextArrival = station.arrivals(generator);
+    }
+
+    std::vector<Transmission> transmissions;
+    LatencyHistogram delay;
+    uint64_t successSteps = 0;
+
+    auto dropHead = [&](Station& station, uint64_t now) {
+        station.queue.pop_front();
+        station.attempt = 0;
+        station.nextSense = now + gapSteps;
+        result.framesDropped++;
+    };
+
+    for (uint64_t now = 0; now < horizon; now++) {
+        // завершение передач
+        for (Transmission& tx : transmissions) {
+            if (tx.done || tx.end != now) {
+                continue;
+            }
+            tx.done = true;
+            Station& station = stations[tx.station];
+            station.transmitting = false;
+
+            if (!tx.collided) {
+                delay.record((now - station.queue.front()) * stepNs);
+                station.queue.pop_front();
+                station.attempt = 0;
+                station.nextSense = now + gapSteps;
+                result.framesDelivered++;
+                successSteps += frameSteps;
+                continue;
+            }
+
+            result.collisions++;
+            station.attempt++;
+            if (station.attempt >= profile.maxAttempts) {
+                dropHead(station, now);
+            } else {
+                int slots = ChannelManager::backoffSlots(profile, station.attempt, generator);
+                station.nextSense = now + slots * slotSteps;
+            }
+        }
+        // сигнал закончившейся передачи ещё propagationSteps слышен остальным
+        transmissions.erase(std::remove_if(transmissions.begin(), transmissions.end(),
+                                           [&](const Transmission& tx) { return tx.done && tx.end + propagationSteps <= now; }),
+                            transmissions.end());
+
+        // поступление кадров
+        for (Station& station : stations) {
+            while (station.nextArrival <= now) {
+                result.framesOffered++;
+                if (station.queue.size() < MAC_SIM_QUEUE_LIMIT) {
+                    station.queue.push_back(now);
+                } else {
+                    result.framesRejected++;
+                }
+                station.nextArrival += 1 + station.arrivals(generator);
+            }
+        }
+
+        // прослушивание канала и начало передач
+        for (int s = 0; s < stationCount; s++) {
+            Station& station = stations[s];
+            if (station.transmitting || station.queue.empty() || station.nextSense > now) {
+                continue;
+            }
+
+            bool busy = std::any_of(transmissions.begin(), transmissions.end(), [&](const Transmission& tx) {
+                return tx.station != s && tx.start + propagationSteps <= now && now < tx.end + propagationSteps;
+            });
+
+            switch (ChannelManager::decide(profile, busy, uniform(generator))) {
+                case CarrierDecision::KeepSensing:
+                    station.nextSense = now + 1;
+                    break;
+                case CarrierDecision::DeferSlot:
+                    station.nextSense = now + slotSteps;
+                    break;
+                case CarrierDecision::RandomWait: {
+                    // как в TransmitWorker: ожидание расходует попытку
+                    int slots = ChannelManager::backoffSlots(profile, station.attempt + 1, generator);
+                    station.attempt++;
+                    if (station.attempt >= profile.maxAttempts) {
+                        dropHead(station, now);
+                    } else {
+                        station.nextSense = now + std::max<uint64_t>(1, slots * slotSteps);
+                    }
+                    break;
+                }
+                case CarrierDecision::Transmit: {
+                    Transmission started{s, now, now + frameSteps, false, false};
+                    // передачи, сигнал которых сюда ещё не дошёл, сталкиваются с этой
+                    for (Transmission& other : transmissions) {
+                        if (other.done || other.start + propagationSteps <= now) {
+                            continue;
+                        }
+                        started.collided = true;
+                        started.end = std::min(started.end, other.start + propagationSteps + jamSteps);
+                        other.collided = true;
+                        other.end = std::min(other.end, now + propagationSteps + jamSteps);
+                    }
+                    transmissions.push_back(started);
+                    station.transmitting = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    result.throughput = static_cast<double>(successSteps) / horizon;
+    result.delay = delay.snapshot();
+    return result;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ChannelManager.h"
+#include "Metrics.h"
+
+#define MAC_SIM_QUEUE_LIMIT 16 // кадров в очереди станции; остальные отбрасываются при поступлении
+
+struct MacSimulationConfig {
+    MacProfile profile;
+    int stations = 4;
+    int frameBytes = 80;            // кадр со стаффингом
+    int baudRate = 115200;
+    int propagationBits = SLOT_TIME_BITS / 2; // задержка распространения; слот - двойная задержка
+    double offeredLoad = 0.5;       // G: поступающих кадров за время кадра, по всем станциям
+    int frameTimes = 20000;         // длительность моделирования во временах кадра
+    uint32_t seed = 1;
+};
+
+struct MacSimulationResult {
+    double throughput = 0.0;        // S: доля времени канала, занятая успешными кадрами
+    uint64_t framesOffered = 0;
+    uint64_t framesDelivered = 0;
+    uint64_t framesDropped = 0;     // исчерпаны попытки
+    uint64_t framesRejected = 0;    // очередь станции переполнена
+    uint64_t collisions = 0;
+    HistogramSnapshot delay;        // от поступления в очередь до конца передачи, нс
+};
+
+// Модель общей линии с N станциями: время идёт шагами в один байт (UART_BITS_PER_BYTE бит),
+// кадры поступают пуассоновским потоком, станции слушают канал и выбирают отсрочку
+// по тем же правилам ChannelManager::decide / backoffSlots, что и TransmitWorker.
+// Сигнал станции доходит до остальных через propagationBits; станции, начавшие передачу
+// раньше, чем дошёл чужой сигнал, сталкиваются, обнаруживают коллизию и шлют jam.
+class MacSimulator {
+public:
+    static MacSimulationResult run(const MacSimulationConfig& config);
+};
@@ -0,0 +1,164 @@
+#include "MessageReassembler.h"
+#include "Frame.h"
+#include <algorithm>
+#include <cstring>
+
+ReassemblyResult MessageReassembler::accept(uint8_t sequence, uint8_t total, uint8_t flags, const char* data, size_t length,
+                                            Clock::time_point now, ReassembledMessage& completed) {
+    if (total == 0 || sequence == 0 || sequence > total || length > FRAME_DATA_SIZE) {
+        return ReassemblyResult::Invalid;
+    }
+    // все кадры, кроме последнего, заполнены целиком
+    if (sequence < total ? length != FRAME_DATA_SIZE : length == 0) {
+        return ReassemblyResult::Invalid;
+    }
+
+    expire(now);
+
+    Slot* slot = find(flags, total);
+    if (!slot) {
+        slot = allocate(flags, total, now);
+    } else if (slot->seen.test(sequence)) {
+        // метка повторяется через 8 сообщений: первый кадр при уже начатом сообщении
+        // означает, что прежнее с той же меткой потеряло кадры и уже не завершится
+        if (sequence != 1) {
+            slot->lastFrame = now;
+            return ReassemblyResult::Duplicate;
+        }
+        evict(*slot);
+        slot = allocate(flags, total, now);
+    }
+
+    std::memcpy(&slot->buffer[static_cast<size_t>(sequence - 1) * FRAME_DATA_SIZE], data, length);
+    slot->seen.set(sequence);
+    slot->received++;
+    slot->lastFrame = now;
+    if (sequence == total) {
+        slot->lastLength = length;
+    }
+
+    if (slot->received < total) {
+        return ReassemblyResult::Accepted;
+    }
+
+    slot->buffer.resize(static_cast<size_t>(total - 1) * FRAME_DATA_SIZE + slot->lastLength);
+    completed.data.swap(slot->buffer);
+    completed.flags = flags;
+    completed.total = total;
+    release(*slot);
+
+    return ReassemblyResult::Completed;
+}
+
+void MessageReassembler::expire(Clock::time_point now) {
+    for (Slot& slot : m_slots) {
+        if (slot.active && now - slot.lastFrame > std::chrono::milliseconds(REASSEMBLY_TIMEOUT_MS)) {
+            evict(slot);
+        }
+    }
+}
+
+void MessageReassembler::recycle(std::string&& buffer) {
+    // буфер больше самого длинного сообщения в пуле только занимал бы память
+    if (buffer.capacity() >= FRAME_DATA_SIZE && buffer.capacity() <= REASSEMBLY_MAX_BUFFER_SIZE &&
+        m_pool.size() < REASSEMBLY_MAX_MESSAGES) {
+        m_pool.push_back(std::move(buffer));
+    }
+}
+
+void MessageReassembler::clear() {
+    for (Slot& slot : m_slots) {
+        if (slot.active) {
+            release(slot);
+        }
+    }
+    m_evicted = 0;
+}
+
+size_t MessageReassembler::activeCount() const {
+    return static_cast<size_t>(std::count_if(m_slots.begin(), m_slots.end(), [](const Slot& slot) { return slot.active; }));
+}
+
+uint64_t MessageReassembler::takeEvictedCount() {
+    uint64_t evicted = m_evicted;
+    m_evicted = 0;
+    return evicted;
+}
+
+MessageReassembler::Slot* MessageReassembler::find(uint8_t flags, uint8_t total) {
+    for (Slot& slot : m_slots) {
+        if (slot.active && slot.flags == flags && slot.total == total) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+MessageReassembler::Slot* MessageReassembler::allocate(uint8_t flags, uint8_t total, Clock::time_point now) {
+    const size_t size = static_cast<size_t>(total) * FRAME_DATA_SIZE;
+
+    // место освобождается за счёт самого давно не пополнявшегося сообщения
+    while (true) {
+        Slot* oldest = nullptr;
+        Slot* freeSlot = nullptr;
+        for (Slot& slot : m_slots) {
+            if (!slot.active) {
+                freeSlot = &slot;
+            } else if (!oldest || slot.lastFrame < oldest->lastFrame) {
+                oldest = &slot;
+            }
+        }
+
+        // учитывается ёмкость буфера, а не size: из пула берётся самый маленький подходящий буфер,
+        // и только если он сам помещается в лимит - иначе выделяется новый ровно под сообщение
+        size_t pooled = m_pool.size();
+        for (size_t i = 0; i < m_pool.size(); i++) {
+            size_t capacity = m_pool[i].capacity();
+            if (capacity >= size && m_memoryUsed + capacity <= REASSEMBLY_MEMORY_LIMIT &&
+                (pooled == m_pool.size() || capacity < m_pool[pooled].capacity())) {
+                pooled = i;
+            }
+        }
+        const size_t reserve = pooled < m_pool.size() ? m_pool[pooled].capacity() : size;
+
+        if (freeSlot && (m_memoryUsed + reserve <= REASSEMBLY_MEMORY_LIMIT || !oldest)) {
+            Slot& slot = *freeSlot;
+            if (pooled < m_pool.size()) {
+                slot.buffer.swap(m_pool[pooled]);
+                m_pool[pooled].swap(m_pool.back());
+                m_pool.pop_back();
+            } else {
+                slot.buffer.reserve(size);
+            }
+            slot.buffer.resize(size);
+
+            slot.active = true;
+            slot.flags = flags;
+            slot.total = total;
+            slot.received = 0;
+            slot.lastLength = 0;
+            slot.seen.reset();
+            slot.lastFrame = now;
+            slot.reserved = slot.buffer.capacity();
+            m_memoryUsed += slot.reserved;
+            return &slot;
+        }
+
+        evict(*oldest);
+    }
+}
+
+void MessageReassembler::release(Slot& slot) {
+    m_memoryUsed -= slot.reserved;
+    slot.reserved = 0;
+    slot.active = false;
+
+    // после выдачи сообщения здесь лежит прежний буфер получателя - он тоже годится в пул
+    recycle(std::move(slot.buffer));
+    slot.buffer.clear();
+}
+
+void MessageReassembler::evict(Slot& slot) {
+    m_evicted++;
+    release(slot);
+}
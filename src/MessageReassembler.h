@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Frame.h"
+
+#define REASSEMBLY_MAX_MESSAGES 16              // одновременно собираемых сообщений (каждый канал передаёт по одному)
+#define REASSEMBLY_TIMEOUT_MS 5000              // сообщение без новых кадров дольше этого отбрасывается
+#define REASSEMBLY_MEMORY_LIMIT (256 * 1024)    // суммарный объём буферов собираемых сообщений
+#define REASSEMBLY_MAX_BUFFER_SIZE (FRAME_MAX_COUNT * FRAME_DATA_SIZE) // буферы больше этого в пул не возвращаются
+
+enum class ReassemblyResult : uint8_t {
+    Accepted,   // кадр записан, сообщение ещё не полное
+    Completed,  // кадр был последним недостающим, сообщение отдано целиком
+    Duplicate,  // такой кадр этого сообщения уже был
+    Invalid     // номер или длина кадра не согласуются с заголовком
+};
+
+struct ReassembledMessage {
+    std::string data;   // данные сообщения в том виде, в каком шли в кадрах (Windows-1251 или сжатые)
+    uint8_t flags = 0;
+    uint8_t total = 0;
+};
+
+// Сборка сообщений из кадров, пришедших в любом порядке. Сообщение определяется
+// байтом флагов (в нём метка сообщения) и числом кадров; для каждого ведётся
+// битовая карта принятых номеров, а данные кадра сразу пишутся на своё место
+// в буфер размером total * FRAME_DATA_SIZE, взятый из пула. Незавершённые
+// сообщения вытесняются по таймауту, по числу слотов и по лимиту памяти;
+// лимит считается по ёмкости буферов, а не по размеру сообщений.
+// Не потокобезопасен: вызывается из одного потока (или под внешним мьютексом).
+class MessageReassembler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ReassemblyResult accept(uint8_t sequence, uint8_t total, uint8_t flags, const char* data, size_t length,
+                            Clock::time_point now, ReassembledMessage& completed);
+
+    // отбрасывает сообщения, не получавшие кадров дольше REASSEMBLY_TIMEOUT_MS
+    void expire(Clock::time_point now);
+
+    // возвращает буфер отданного сообщения в пул (буфер больше REASSEMBLY_MAX_BUFFER_SIZE освобождается)
+    void recycle(std::string&& buffer);
+
+    void clear();
+
+    size_t activeCount() const;
+    size_t memoryUsed() const { return m_memoryUsed; }
+
+    // число вытесненных незавершённых сообщений с прошлого вызова
+    uint64_t takeEvictedCount();
+
+private:
+    struct Slot {
+        bool active = false;
+        uint8_t flags = 0;
+        uint8_t total = 0;
+        uint16_t received = 0;
+        size_t lastLength = 0;  // длина данных последнего кадра, когда он принят
+        size_t reserved = 0;    // учтено в m_memoryUsed
+        std::bitset<256> seen;
+        std::string buffer;
+        Clock::time_point lastFrame;
+    };
+
+    Slot* find(uint8_t flags, uint8_t total);
+    Slot* allocate(uint8_t flags, uint8_t total, Clock::time_point now);
+    void release(Slot& slot);
+    void evict(Slot& slot);
+
+    std::array<Slot, REASSEMBLY_MAX_MESSAGES> m_slots;
+    std::vector<std::string> m_pool;
+    size_t m_memoryUsed = 0;
+    uint64_t m_evicted = 0;
+};
@@ -0,0 +1,276 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static int highestBit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < METRICS_SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+
+    int shift = highestBit(value) - METRICS_SUB_BUCKET_BITS;
+    size_t subBucket = static_cast<size_t>(value >> shift) - METRICS_SUB_BUCKETS;
+    return static_cast<size_t>(shift + 1) * METRICS_SUB_BUCKETS + subBucket;
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < METRICS_SUB_BUCKETS) {
+        return index;
+    }
+
+    size_t shift = index / METRICS_SUB_BUCKETS - 1;
+    uint64_t subBucket = index % METRICS_SUB_BUCKETS;
+    return (METRICS_SUB_BUCKETS + subBucket) << shift;
+}
+
+void LatencyHistogram::record(uint64_t valueNs) {
+    m_buckets[bucketIndex(valueNs)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(valueNs, std::memory_order_relaxed);
+
+    uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+    while (valueNs > currentMax &&
+           !m_max.compare_exchange_weak(currentMax, valueNs, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot result;
+    result.buckets.resize(METRICS_BUCKET_COUNT);
+    for (size_t i = 0; i < METRICS_BUCKET_COUNT; i++) {
+        result.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        result.count += result.buckets[i];
+    }
+    result.sumNs = m_sum.load(std::memory_order_relaxed);
+    result.maxNs = m_max.load(std::memory_order_relaxed);
+    return result;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t HistogramSnapshot::percentileNs(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * count);
+    rank = std::min(std::max<uint64_t>(rank, 1), count);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // верхняя граница интервала, но не больше наблюдавшегося максимума
+            uint64_t upper = i + 1 < buckets.size() ? LatencyHistogram::bucketLowerBound(i + 1) - 1 : maxNs;
+            return std::min(upper, maxNs);
+        }
+    }
+    return maxNs;
+}
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other) {
+    if (buckets.size() < other.buckets.size()) {
+        buckets.resize(other.buckets.size());
+    }
+    for (size_t i = 0; i < other.buckets.size(); i++) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sumNs += other.sumNs;
+    maxNs = std::max(maxNs, other.maxNs);
+}
+
+void PortMetrics::reset() {
+    for (auto& counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& histogram : m_histograms) {
+        histogram.reset();
+    }
+}
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+PortMetrics* MetricsRegistry::getPort(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& port : m_ports) {
+        if (port.getName() == name) {
+            return &port;
+        }
+    }
+    m_ports.emplace_back(name);
+    return &m_ports.back();
+}
+
+std::vector<PortMetricsSnapshot> MetricsRegistry::snapshot() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<PortMetricsSnapshot> result;
+    result.reserve(m_ports.size());
+
+    for (const auto& port : m_ports) {
+        PortMetricsSnapshot snapshot;
+        snapshot.name = port.getName();
+        for (size_t i = 0; i < METRIC_COUNTER_COUNT; i++) {
+            snapshot.counters[i] = port.get(static_cast<MetricCounter>(i));
+        }
+        for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+            snapshot.latencies[i] = port.latency(static_cast<MetricStage>(i));
+        }
+        result.push_back(std::move(snapshot));
+    }
+    return result;
+}
+
+PortMetricsSnapshot MetricsRegistry::total(const std::vector<PortMetricsSnapshot>& ports) {
+    PortMetricsSnapshot result;
+    result.name = "total";
+    for (const auto& port : ports) {
+        for (size_t i = 0; i < METRIC_COUNTER_COUNT; i++) {
+            result.counters[i] += port.counters[i];
+        }
+        for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+            result.latencies[i].merge(port.latencies[i]);
+        }
+    }
+    return result;
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& port : m_ports) {
+        port.reset();
+    }
+}
+
+static void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+static void appendPortJson(std::string& out, const PortMetricsSnapshot& port) {
+    char buffer[256];
+
+    out += "{\"name\":";
+    appendJsonString(out, port.name);
+
+    out += ",\"counters\":{";
+    for (size_t i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        std::snprintf(buffer, sizeof(buffer), "%s\"%s\":%llu", i ? "," : "",
+                      MetricsRegistry::counterName(static_cast<MetricCounter>(i)),
+                      static_cast<unsigned long long>(port.counters[i]));
+        out += buffer;
+    }
+
+    out += "},\"latencyNs\":{";
+    bool first = true;
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        const HistogramSnapshot& histogram = port.latencies[i];
+        if (histogram.count == 0) {
+            continue;
+        }
+
+        std::snprintf(buffer, sizeof(buffer),
+                      "%s\"%s\":{\"count\":%llu,\"mean\":%.0f,\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"max\":%llu}",
+                      first ? "" : ",",
+                      MetricsRegistry::stageName(static_cast<MetricStage>(i)),
+                      static_cast<unsigned long long>(histogram.count),
+                      histogram.meanNs(),
+                      static_cast<unsigned long long>(histogram.percentileNs(50)),
+                      static_cast<unsigned long long>(histogram.percentileNs(90)),
+                      static_cast<unsigned long long>(histogram.percentileNs(99)),
+                      static_cast<unsigned long long>(histogram.maxNs));
+        out += buffer;
+        first = false;
+    }
+    out += "}}";
+}
+
+std::string MetricsRegistry::toJson() {
+    std::vector<PortMetricsSnapshot> ports = snapshot();
+
+    std::string out = "{\"total\":";
+    appendPortJson(out, total(ports));
+    out += ",\"ports\":[";
+    for (size_t i = 0; i < ports.size(); i++) {
+        if (i) {
+            out += ',';
+        }
+        appendPortJson(out, ports[i]);
+    }
+    out += "]}\n";
+    return out;
+}
+
+const char* MetricsRegistry::stageName(MetricStage stage) {
+    switch (stage) {
+        case MetricStage::Compress: return "compress";
+        case MetricStage::Pack: return "pack";
+        case MetricStage::Stuff: return "stuff";
+        case MetricStage::Write: return "write";
+        case MetricStage::Backoff: return "backoff";
+        case MetricStage::Deframe: return "deframe";
+        case MetricStage::Unstuff: return "unstuff";
+        case MetricStage::Correct: return "correct";
+        case MetricStage::Transcode: return "transcode";
+        case MetricStage::Decompress: return "decompress";
+        case MetricStage::TimerLateness: return "timerLateness";
+        default: return "unknown";
+    }
+}
+
+const char* MetricsRegistry::counterName(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::BytesSent: return "bytesSent";
+        case MetricCounter::BytesReceived: return "bytesReceived";
+        case MetricCounter::FramesSent: return "framesSent";
+        case MetricCounter::FramesReceived: return "framesReceived";
+        case MetricCounter::FramesFailed: return "framesFailed";
+        case MetricCounter::FramesCorrected: return "framesCorrected";
+        case MetricCounter::DoubleErrors: return "doubleErrors";
+        case MetricCounter::MessagesSent: return "messagesSent";
+        case MetricCounter::MessagesReceived: return "messagesReceived";
+        case MetricCounter::CompressedBytesIn: return "compressedBytesIn";
+        case MetricCounter::CompressedBytesOut: return "compressedBytesOut";
+        case MetricCounter::DecompressErrors: return "decompressErrors";
+        case MetricCounter::Collisions: return "collisions";
+        case MetricCounter::JamSent: return "jamSent";
+        case MetricCounter::JamDetected: return "jamDetected";
+        case MetricCounter::FramesDuplicate: return "framesDuplicate";
+        case MetricCounter::MessagesEvicted: return "messagesEvicted";
+        default: return "unknown";
+    }
+}
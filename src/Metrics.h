@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Логарифмически-линейная гистограмма: на каждую степень двойки по METRICS_SUB_BUCKETS
+// равных интервалов, т.е. относительная погрешность не больше 1/METRICS_SUB_BUCKETS
+#define METRICS_SUB_BUCKET_BITS 3
+#define METRICS_SUB_BUCKETS (1 << METRICS_SUB_BUCKET_BITS)
+#define METRICS_BUCKET_COUNT ((64 - METRICS_SUB_BUCKET_BITS + 1) * METRICS_SUB_BUCKETS)
+
+// Этапы конвейера, для которых измеряется задержка
+enum class MetricStage : uint8_t {
+    Compress,   // сжатие сообщения
+    Pack,       // кодирование сообщения и сборка кадра (Хэмминг)
+    Stuff,      // байт-стаффинг кадра
+    Write,      // запись в порт
+    Backoff,    // ожидание CSMA/CD
+    Deframe,    // выделение кадров из потока байтов
+    Unstuff,    // снятие байт-стаффинга
+    Correct,    // исправление ошибок
+    Transcode,  // перекодировка данных кадра
+    Decompress, // распаковка собранного сообщения
+    TimerLateness, // опоздание пробуждения DeadlineTimer относительно срока (джиттер)
+    Count
+};
+
+enum class MetricCounter : uint8_t {
+    BytesSent,
+    BytesReceived,
+    FramesSent,
+    FramesReceived,
+    FramesFailed,
+    FramesCorrected,
+    DoubleErrors,
+    MessagesSent,
+    MessagesReceived,
+    CompressedBytesIn,  // размер сообщений до сжатия
+    CompressedBytesOut, // и после
+    DecompressErrors,
+    Collisions,
+    JamSent,
+    JamDetected,
+    FramesDuplicate,
+    MessagesEvicted,    // незавершённые сообщения, отброшенные сборкой
+    Count
+};
+
+#define METRIC_STAGE_COUNT static_cast<size_t>(MetricStage::Count)
+#define METRIC_COUNTER_COUNT static_cast<size_t>(MetricCounter::Count)
+
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sumNs = 0;
+    uint64_t maxNs = 0;
+    std::vector<uint64_t> buckets;
+
+    double meanNs() const { return count ? static_cast<double>(sumNs) / count : 0.0; }
+    uint64_t percentileNs(double percentile) const;
+    void merge(const HistogramSnapshot& other);
+};
+
+// Гистограмма задержек без блокировок: запись - несколько relaxed-инкрементов
+class LatencyHistogram {
+public:
+    void record(uint64_t valueNs);
+    HistogramSnapshot snapshot() const;
+    void reset();
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketLowerBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, METRICS_BUCKET_COUNT> m_buckets{};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+// Метрики одного порта (или одного экземпляра конвейера)
+class PortMetrics {
+public:
+    explicit PortMetrics(const std::string& name) : m_name(name) {}
+
+    const std::string& getName() const { return m_name; }
+
+    void add(MetricCounter counter, uint64_t value = 1) {
+        m_counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+    }
+    uint64_t get(MetricCounter counter) const {
+        return m_counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    void recordLatency(MetricStage stage, uint64_t valueNs) {
+        m_histograms[static_cast<size_t>(stage)].record(valueNs);
+    }
+    HistogramSnapshot latency(MetricStage stage) const {
+        return m_histograms[static_cast<size_t>(stage)].snapshot();
+    }
+
+    void reset();
+
+private:
+    std::string m_name;
+    std::array<std::atomic<uint64_t>, METRIC_COUNTER_COUNT> m_counters{};
+    std::array<LatencyHistogram, METRIC_STAGE_COUNT> m_histograms;
+};
+
+struct PortMetricsSnapshot {
+    std::string name;
+    std::array<uint64_t, METRIC_COUNTER_COUNT> counters{};
+    std::array<HistogramSnapshot, METRIC_STAGE_COUNT> latencies;
+};
+
+// Реестр метрик процесса. Регистрация порта берёт мьютекс, а всё остальное
+// (счётчики, гистограммы) - только атомарные операции, поэтому указатель
+// на PortMetrics получают один раз и затем пишут в него с горячего пути.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& getInstance();
+
+    // возвращает существующие метрики порта или создаёт новые; указатель живёт до конца процесса
+    PortMetrics* getPort(const std::string& name);
+
+    std::vector<PortMetricsSnapshot> snapshot();
+    static PortMetricsSnapshot total(const std::vector<PortMetricsSnapshot>& ports);
+
+    std::string toJson();
+    void reset();
+
+    static const char* stageName(MetricStage stage);
+    static const char* counterName(MetricCounter counter);
+
+private:
+    MetricsRegistry() = default;
+
+    std::mutex m_mutex;
+    std::deque<PortMetrics> m_ports;
+};
+
+// Замер задержки этапа от конструктора до деструктора; при metrics == nullptr ничего не делает
+class ScopedLatency {
+public:
+    ScopedLatency(PortMetrics* metrics, MetricStage stage)
+        : m_metrics(metrics)
+        , m_stage(stage) {
+        if (m_metrics) {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedLatency() {
+        if (m_metrics) {
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_metrics->recordLatency(m_stage, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    PortMetrics* m_metrics;
+    MetricStage m_stage;
+    std::chrono::steady_clock::time_point m_start;
+};
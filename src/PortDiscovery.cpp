@@ -0,0 +1,39 @@
+#include "PortDiscovery.h"
+#include <algorithm>
+
+std::vector<std::string> PortDiscovery::getPorts() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ports;
+}
+
+void PortDiscovery::rescan(bool forceNotify) {
+    std::vector<std::string> ports = enumeratePorts();
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const std::string& port : ports) {
+            if (std::find(m_ports.begin(), m_ports.end(), port) == m_ports.end()) {
+                added.push_back(port);
+            }
+        }
+        for (const std::string& port : m_ports) {
+            if (std::find(ports.begin(), ports.end(), port) == ports.end()) {
+                removed.push_back(port);
+            }
+        }
+        m_ports = std::move(ports);
+    }
+
+    if ((forceNotify || !added.empty() || !removed.empty()) && m_callback) {
+        m_callback(added, removed);
+    }
+}
+
+void PortDiscovery::sortPorts(std::vector<std::string>& ports) {
+    // COM2 раньше COM10, /dev/ttyS2 раньше /dev/ttyS10
+    std::sort(ports.begin(), ports.end(), [](const std::string& a, const std::string& b) {
+        return a.length() != b.length() ? a.length() < b.length() : a < b;
+    });
+}
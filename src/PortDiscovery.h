@@ -0,0 +1,54 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Фоновое обнаружение последовательных портов: список берётся за один проход, кэшируется,
+// а подключение и отключение устройств отслеживается по уведомлениям системы.
+// Windows (PortDiscoveryWin.cpp): раздел реестра HKLM\HARDWARE\DEVICEMAP\SERIALCOMM
+// и уведомления об его изменении. Linux (PortDiscoveryLinux.cpp): /sys/class/tty,
+// события ядра (netlink uevent) и появление и удаление узлов tty* в /dev (inotify).
+class PortDiscovery {
+public:
+    // вызывается из фонового потока
+    using PortsChangedCallback = std::function<void(const std::vector<std::string>& added,
+                                                    const std::vector<std::string>& removed)>;
+
+    PortDiscovery();
+    ~PortDiscovery();
+
+    bool start(const PortsChangedCallback& callback);
+    void stop();
+
+    // принудительно перечитать список
+    void refresh();
+
+    std::vector<std::string> getPorts();
+
+    // имена для открытия порта: "COM3" в Windows, "/dev/ttyUSB0" в Linux
+    static std::vector<std::string> enumeratePorts();
+
+private:
+    void monitorThreadFunc();
+    void rescan(bool forceNotify);
+    static void sortPorts(std::vector<std::string>& ports);
+
+    PortsChangedCallback m_callback;
+    std::thread m_thread;
+#ifdef _WIN32
+    HANDLE m_stopEvent = NULL;
+    HANDLE m_refreshEvent = NULL;
+#else
+    int m_stopFd = -1;      // eventfd
+    int m_refreshFd = -1;   // eventfd
+#endif
+
+    std::mutex m_mutex;
+    std::vector<std::string> m_ports;
+};
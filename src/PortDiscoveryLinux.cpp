@@ -0,0 +1,211 @@
+#include "PortDiscovery.h"
+
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define SYSFS_TTY_DIR "/sys/class/tty"
+#define DEV_DIR "/dev"
+#define DISCOVERY_EVENT_BUFFER_SIZE 8192
+#define DISCOVERY_FALLBACK_POLL_MS 5000 // без netlink и inotify список перечитывается с этим периодом
+
+namespace {
+
+// eventfd без накопления: читает счётчик, чтобы poll снова ждал
+void drainEventFd(int fd) {
+    uint64_t count;
+    ssize_t result = read(fd, &count, sizeof(count));
+    (void)result;
+}
+
+void signalEventFd(int fd) {
+    uint64_t one = 1;
+    ssize_t result = write(fd, &one, sizeof(one));
+    (void)result;
+}
+
+// сокет событий ядра (kobject uevent); -1, если недоступен (например, в контейнере)
+int openUeventSocket() {
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) {
+        return -1;
+    }
+
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1; // события ядра
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// сообщение uevent: "ACTION@devpath\0KEY=VALUE\0..."; порты интересны только из подсистемы tty
+bool readUevents(int fd) {
+    char buffer[DISCOVERY_EVENT_BUFFER_SIZE];
+    bool relevant = false;
+
+    ssize_t length;
+    while ((length = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        for (ssize_t offset = 0; offset < length; offset += std::strlen(buffer + offset) + 1) {
+            if (std::strcmp(buffer + offset, "SUBSYSTEM=tty") == 0) {
+                relevant = true;
+            }
+        }
+    }
+    return relevant;
+}
+
+// узлы в /dev создаёт udev уже после события ядра; по ним ловится момент, когда порт можно открыть
+bool readDevEvents(int fd) {
+    alignas(inotify_event) char buffer[DISCOVERY_EVENT_BUFFER_SIZE];
+    bool relevant = false;
+
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < length; ) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && std::strncmp(event->name, "tty", 3) == 0) {
+                relevant = true;
+            }
+            offset += sizeof(inotify_event) + event->len;
+        }
+    }
+    return relevant;
+}
+
+// порт настоящий, если за ним стоит устройство; у виртуальных консолей (tty0..63), ptmx и pty
+// ссылки device нет. Порты 8250 регистрируются все (ttyS0..31), даже без оборудования, -
+// у отсутствующих тип порта 0 (PORT_UNKNOWN)
+bool isSerialDevice(const std::string& sysfsPath, const std::string& name) {
+    if (access((sysfsPath + "/device").c_str(), F_OK) != 0) {
+        return false;
+    }
+    if (name.compare(0, 4, "ttyS") == 0) {
+        std::ifstream typeFile(sysfsPath + "/type");
+        int type = 0;
+        if (typeFile >> type && type == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+PortDiscovery::PortDiscovery() {
+    m_stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    m_refreshFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+}
+
+PortDiscovery::~PortDiscovery() {
+    stop();
+    close(m_stopFd);
+    close(m_refreshFd);
+}
+
+bool PortDiscovery::start(const PortsChangedCallback& callback) {
+    if (m_thread.joinable() || m_stopFd < 0 || m_refreshFd < 0) {
+        return false;
+    }
+
+    m_callback = callback;
+    drainEventFd(m_stopFd);
+    m_thread = std::thread(&PortDiscovery::monitorThreadFunc, this);
+    return true;
+}
+
+void PortDiscovery::stop() {
+    signalEventFd(m_stopFd);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void PortDiscovery::refresh() {
+    signalEventFd(m_refreshFd);
+}
+
+std::vector<std::string> PortDiscovery::enumeratePorts() {
+    std::vector<std::string> ports;
+
+    DIR* directory = opendir(SYSFS_TTY_DIR);
+    if (!directory) {
+        return ports;
+    }
+
+    while (dirent* entry = readdir(directory)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        if (isSerialDevice(std::string(SYSFS_TTY_DIR "/") + name, name)) {
+            ports.push_back(DEV_DIR "/" + name);
+        }
+    }
+    closedir(directory);
+
+    sortPorts(ports);
+    return ports;
+}
+
+void PortDiscovery::monitorThreadFunc() {
+    int ueventFd = openUeventSocket();
+    int inotifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (inotifyFd >= 0 && inotify_add_watch(inotifyFd, DEV_DIR, IN_CREATE | IN_DELETE | IN_ATTRIB) < 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+
+    rescan(true);
+
+    while (true) {
+        pollfd descriptors[] = {
+            {m_stopFd, POLLIN, 0},
+            {m_refreshFd, POLLIN, 0},
+            {ueventFd, POLLIN, 0},      // отрицательные дескрипторы poll пропускает
+            {inotifyFd, POLLIN, 0},
+        };
+        // без источников уведомлений проверяем раз в несколько секунд
+        bool notified = ueventFd >= 0 || inotifyFd >= 0;
+        int ready = poll(descriptors, 4, notified ? -1 : DISCOVERY_FALLBACK_POLL_MS);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        if (descriptors[0].revents & POLLIN) {
+            break;
+        }
+
+        bool changed = ready == 0;
+        if (descriptors[1].revents & POLLIN) {
+            drainEventFd(m_refreshFd);
+            changed = true;
+        }
+        if ((descriptors[2].revents & POLLIN) && readUevents(ueventFd)) {
+            changed = true;
+        }
+        if ((descriptors[3].revents & POLLIN) && readDevEvents(inotifyFd)) {
+            changed = true;
+        }
+
+        if (changed) {
+            rescan(false);
+        }
+    }
+
+    if (ueventFd >= 0) {
+        close(ueventFd);
+    }
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+}
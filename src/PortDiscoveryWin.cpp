@@ -0,0 +1,107 @@
+#include "PortDiscovery.h"
+
+#define SERIALCOMM_KEY "HARDWARE\\DEVICEMAP\\SERIALCOMM"
+
+PortDiscovery::PortDiscovery() {
+    m_stopEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    m_refreshEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+}
+
+PortDiscovery::~PortDiscovery() {
+    stop();
+    CloseHandle(m_stopEvent);
+    CloseHandle(m_refreshEvent);
+}
+
+bool PortDiscovery::start(const PortsChangedCallback& callback) {
+    if (m_thread.joinable()) {
+        return false;
+    }
+
+    m_callback = callback;
+    ResetEvent(m_stopEvent);
+    m_thread = std::thread(&PortDiscovery::monitorThreadFunc, this);
+    return true;
+}
+
+void PortDiscovery::stop() {
+    SetEvent(m_stopEvent);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void PortDiscovery::refresh() {
+    SetEvent(m_refreshEvent);
+}
+
+std::vector<std::string> PortDiscovery::enumeratePorts() {
+    std::vector<std::string> ports;
+
+    HKEY key;
+    if (RegOpenKeyExA(HKEY_LOCAL_MACHINE, SERIALCOMM_KEY, 0, KEY_READ, &key) != ERROR_SUCCESS) {
+        return ports;
+    }
+
+    for (DWORD index = 0; ; index++) {
+        char valueName[256];
+        DWORD valueNameLength = sizeof(valueName);
+        char data[256];
+        DWORD dataLength = sizeof(data) - 1;
+        DWORD type;
+
+        LONG result = RegEnumValueA(key, index, valueName, &valueNameLength, NULL, &type,
+                                    reinterpret_cast<LPBYTE>(data), &dataLength);
+        if (result == ERROR_NO_MORE_ITEMS) {
+            break;
+        }
+        if (result != ERROR_SUCCESS || type != REG_SZ) {
+            continue;
+        }
+
+        data[dataLength] = '\0';
+        ports.push_back(data);
+    }
+
+    RegCloseKey(key);
+
+    sortPorts(ports);
+    return ports;
+}
+
+void PortDiscovery::monitorThreadFunc() {
+    HKEY key = NULL;
+    HANDLE changeEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+    // раздела может не быть, пока в системе нет ни одного порта
+    RegOpenKeyExA(HKEY_LOCAL_MACHINE, SERIALCOMM_KEY, 0, KEY_READ | KEY_NOTIFY, &key);
+
+    rescan(true);
+
+    while (true) {
+        if (key == NULL) {
+            RegOpenKeyExA(HKEY_LOCAL_MACHINE, SERIALCOMM_KEY, 0, KEY_READ | KEY_NOTIFY, &key);
+        }
+        if (key != NULL &&
+            RegNotifyChangeKeyValue(key, FALSE, REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET,
+                                    changeEvent, TRUE) != ERROR_SUCCESS) {
+            RegCloseKey(key);
+            key = NULL;
+        }
+
+        HANDLE events[] = { m_stopEvent, changeEvent, m_refreshEvent };
+        // без раздела реестра уведомлений нет - тогда проверяем раз в несколько секунд
+        DWORD waitResult = WaitForMultipleObjects(3, events, FALSE, key != NULL ? INFINITE : 5000);
+
+        if (waitResult == WAIT_OBJECT_0) {
+            break;
+        }
+
+        rescan(false);
+    }
+
+    if (key != NULL) {
+        RegCloseKey(key);
+    }
+    CloseHandle(changeEvent);
+}
@@ -0,0 +1,60 @@
+#include "PortMultiplexer.h"
+
+PortMultiplexer::PortMultiplexer(ThreadPool& pool, size_t loopThreadCount)
+    : m_pool(pool)
+    , m_loopThreadCount(loopThreadCount == 0 ? 1 : loopThreadCount) {
+}
+
+PortMultiplexer::~PortMultiplexer() {
+    stop();
+}
+
+void PortMultiplexer::deliverResults(PortContext* port) {
+    port->pipeline->takeResults(port->results);
+
+    if (port->results.frames.empty() && port->results.messages.empty()) {
+        return;
+    }
+
+    port->framesDecoded += port->results.frames.size();
+    port->messagesDecoded += port->results.messages.size();
+
+    if (port->callback && !port->closing) {
+        port->callback(port->id, port->results);
+    }
+}
+
+bool PortMultiplexer::writeData(int portId, const std::string& data) {
+    return writeData(portId, data.c_str(), data.length());
+}
+
+PortStatistics PortMultiplexer::getStatistics(int portId) {
+    PortStatistics statistics;
+    std::shared_ptr<PortContext> port = findPort(portId);
+    if (!port) {
+        return statistics;
+    }
+
+    statistics.bytesReceived = port->bytesReceived;
+    statistics.bytesSent = port->bytesSent;
+    statistics.framesDecoded = port->framesDecoded;
+    statistics.messagesDecoded = port->messagesDecoded;
+    statistics.readCompletions = port->readCompletions;
+    statistics.errors = port->errors;
+    return statistics;
+}
+
+std::vector<int> PortMultiplexer::getPortIds() {
+    std::lock_guard<std::mutex> lock(m_portsMutex);
+    std::vector<int> ids;
+    for (const auto& entry : m_ports) {
+        ids.push_back(entry.first);
+    }
+    return ids;
+}
+
+std::shared_ptr<PortMultiplexer::PortContext> PortMultiplexer::findPort(int portId) {
+    std::lock_guard<std::mutex> lock(m_portsMutex);
+    auto it = m_ports.find(portId);
+    return it != m_ports.end() ? it->second : nullptr;
+}
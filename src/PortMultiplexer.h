@@ -0,0 +1,120 @@
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include "PosixSerialPort.h"
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Metrics.h"
+#include "ReceivePipeline.h"
+#include "ThreadPool.h"
+
+#define MUX_READ_BUFFER_SIZE 4096
+#define MUX_READ_TIMEOUT_MS 1000
+
+struct PortStatistics {
+    uint64_t bytesReceived = 0;
+    uint64_t bytesSent = 0;
+    uint64_t framesDecoded = 0;
+    uint64_t messagesDecoded = 0;
+    uint64_t readCompletions = 0;
+    uint64_t errors = 0;
+};
+
+// Обслуживает много последовательных портов из фиксированного числа потоков цикла событий:
+// в Windows - на порте завершения ввода-вывода (PortMultiplexerIocp.cpp), в Linux - на epoll
+// поверх PosixSerialPort (PortMultiplexerEpoll.cpp). У каждого порта свой конвейер приёма
+// (выделение кадров и сборка сообщений), декодирование идёт в общем пуле.
+class PortMultiplexer {
+public:
+    // вызывается из потока цикла событий
+    using ResultsCallback = std::function<void(int portId, ReceiveResults& results)>;
+
+    PortMultiplexer(ThreadPool& pool, size_t loopThreadCount = 1);
+    ~PortMultiplexer();
+
+    bool start();
+    void stop();
+
+    // portName - "COM3" в Windows, путь к устройству ("/dev/ttyUSB0") в Linux;
+    // возвращает идентификатор порта или -1 при ошибке
+    int addPort(const std::string& portName, int baudRate, const ResultsCallback& callback);
+    void removePort(int portId);
+
+    bool writeData(int portId, const char* data, size_t length);
+    bool writeData(int portId, const std::string& data);
+
+    PortStatistics getStatistics(int portId);
+    std::vector<int> getPortIds();
+
+private:
+    struct PortContext {
+        int id;
+        std::string name;
+#ifdef _WIN32
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED readOverlapped;
+#else
+        PosixSerialPort serial;     // открытие, настройка termios и запись; читает цикл событий
+        int notifyFd = -1;          // eventfd: в конвейере появились результаты
+        std::mutex handlerMutex;    // обработчик событий порта и removePort не работают одновременно
+        std::mutex writeMutex;      // writeData и закрытие дескриптора в finishClose не работают одновременно
+#endif
+        char readBuffer[MUX_READ_BUFFER_SIZE];
+        std::unique_ptr<ReceivePipeline> pipeline;
+        PortMetrics* metrics = nullptr;
+        ResultsCallback callback;
+        ReceiveResults results;
+
+        std::atomic<bool> closing{false};
+        bool closed = false;
+
+        std::atomic<uint64_t> bytesReceived{0};
+        std::atomic<uint64_t> bytesSent{0};
+        std::atomic<uint64_t> framesDecoded{0};
+        std::atomic<uint64_t> messagesDecoded{0};
+        std::atomic<uint64_t> readCompletions{0};
+        std::atomic<uint64_t> errors{0};
+    };
+
+    void loopThreadFunc();
+    void deliverResults(PortContext* port);
+    void finishClose(PortContext* port);
+    std::shared_ptr<PortContext> findPort(int portId);
+
+#ifdef _WIN32
+    bool configurePort(HANDLE handle, int baudRate);
+    bool issueRead(PortContext* port);
+    void handleReadCompletion(PortContext* port, BOOL success, DWORD bytesTransferred);
+#else
+    void handleReadable(PortContext* port, uint32_t events);
+    void handleNotify(PortContext* port);
+    bool rearm(int fd, uint64_t key);
+#endif
+
+    ThreadPool& m_pool;
+    size_t m_loopThreadCount;
+#ifdef _WIN32
+    HANDLE m_completionPort = NULL;
+#else
+    int m_epollFd = -1;
+    int m_stopFd = -1;              // eventfd: сигнал завершения потокам цикла
+#endif
+    std::vector<std::thread> m_loopThreads;
+
+    std::mutex m_portsMutex;
+    std::condition_variable m_portClosed;
+    std::map<int, std::shared_ptr<PortContext>> m_ports;
+    int m_nextPortId = 1;
+};
@@ -0,0 +1,277 @@
+#include "PortMultiplexer.h"
+#include "Tracer.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Ключ события epoll: 0 - завершение, иначе идентификатор порта и младший бит -
+// 0 для чтения из порта, 1 для готовых результатов конвейера. Оба дескриптора порта
+// регистрируются с EPOLLONESHOT: событие порта обрабатывает один поток цикла,
+// после обработки дескриптор снова взводится.
+namespace {
+
+uint64_t readKey(int portId) {
+    return static_cast<uint64_t>(portId) << 1;
+}
+
+uint64_t notifyKey(int portId) {
+    return static_cast<uint64_t>(portId) << 1 | 1;
+}
+
+} // namespace
+
+bool PortMultiplexer::start() {
+    if (m_epollFd >= 0) {
+        return true;
+    }
+
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_event event{};
+    event.events = EPOLLIN; // без EPOLLONESHOT: сигнал завершения видят все потоки цикла
+    event.data.u64 = 0;
+    if (m_epollFd < 0 || m_stopFd < 0 || epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_stopFd, &event) != 0) {
+        std::cerr << "Ошибка создания epoll: " << std::strerror(errno) << std::endl;
+        if (m_stopFd >= 0) {
+            close(m_stopFd);
+            m_stopFd = -1;
+        }
+        if (m_epollFd >= 0) {
+            close(m_epollFd);
+            m_epollFd = -1;
+        }
+        return false;
+    }
+
+    for (size_t i = 0; i < m_loopThreadCount; i++) {
+        m_loopThreads.emplace_back(&PortMultiplexer::loopThreadFunc, this);
+    }
+
+    return true;
+}
+
+void PortMultiplexer::stop() {
+    if (m_epollFd < 0) {
+        return;
+    }
+
+    for (int portId : getPortIds()) {
+        removePort(portId);
+    }
+
+    uint64_t one = 1;
+    if (write(m_stopFd, &one, sizeof(one)) != sizeof(one)) {
+        std::cerr << "Ошибка остановки цикла epoll: " << std::strerror(errno) << std::endl;
+    }
+    for (std::thread& thread : m_loopThreads) {
+        thread.join();
+    }
+    m_loopThreads.clear();
+
+    close(m_stopFd);
+    close(m_epollFd);
+    m_stopFd = -1;
+    m_epollFd = -1;
+}
+
+int PortMultiplexer::addPort(const std::string& portName, int baudRate, const ResultsCallback& callback) {
+    if (m_epollFd < 0) {
+        return -1;
+    }
+
+    auto port = std::make_shared<PortContext>();
+    // порт настраивается PosixSerialPort (8N1, VMIN = VTIME = 0 - read не блокируется);
+    // его поток чтения не запускается, данные читает цикл событий
+    if (!port->serial.open(portName, baudRate)) {
+        return -1;
+    }
+
+    port->notifyFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (port->notifyFd < 0) {
+        std::cerr << "Ошибка создания eventfd: " << std::strerror(errno) << std::endl;
+        port->serial.close();
+        return -1;
+    }
+
+    port->name = portName;
+    port->callback = callback;
+    port->pipeline = std::make_unique<ReceivePipeline>(m_pool);
+    port->metrics = port->serial.getMetrics();
+    port->pipeline->setMetrics(port->metrics);
+    port->pipeline->setErrorSimulation(false);
+
+    {
+        std::lock_guard<std::mutex> lock(m_portsMutex);
+        port->id = m_nextPortId++;
+        m_ports[port->id] = port;
+    }
+
+    int notifyFd = port->notifyFd;
+    port->pipeline->setResultsCallback([notifyFd]() {
+        // готовые результаты передаются в поток цикла, чтобы обратные вызовы шли оттуда
+        uint64_t one = 1;
+        ssize_t result = write(notifyFd, &one, sizeof(one));
+        (void)result; // EAGAIN - счётчик уже взведён, уведомление не теряется
+    });
+
+    epoll_event readEvent{};
+    readEvent.events = EPOLLIN | EPOLLONESHOT;
+    readEvent.data.u64 = readKey(port->id);
+    epoll_event notifyEvent{};
+    notifyEvent.events = EPOLLIN | EPOLLONESHOT;
+    notifyEvent.data.u64 = notifyKey(port->id);
+
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, port->serial.getDescriptor(), &readEvent) != 0
+        || epoll_ctl(m_epollFd, EPOLL_CTL_ADD, port->notifyFd, &notifyEvent) != 0) {
+        std::cerr << "Ошибка добавления порта " << portName << " в epoll: " << std::strerror(errno) << std::endl;
+        removePort(port->id);
+        return -1;
+    }
+
+    return port->id;
+}
+
+void PortMultiplexer::removePort(int portId) {
+    std::shared_ptr<PortContext> port = findPort(portId);
+    if (!port) {
+        return;
+    }
+
+    {
+        // после этого блока обработчики порта в потоках цикла завершены, а новые
+        // события не приходят; уже выбранные из epoll увидят closing и ничего не сделают
+        std::lock_guard<std::mutex> handlerLock(port->handlerMutex);
+        port->closing = true;
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, port->serial.getDescriptor(), nullptr);
+        epoll_ctl(m_epollFd, EPOLL_CTL_DEL, port->notifyFd, nullptr);
+    }
+
+    finishClose(port.get());
+
+    std::lock_guard<std::mutex> lock(m_portsMutex);
+    m_ports.erase(portId);
+}
+
+void PortMultiplexer::loopThreadFunc() {
+    Tracer::setThreadName("epoll loop");
+
+    while (true) {
+        epoll_event event;
+        int ready = epoll_wait(m_epollFd, &event, 1, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        if (event.data.u64 == 0) {
+            return;
+        }
+
+        std::shared_ptr<PortContext> port = findPort(static_cast<int>(event.data.u64 >> 1));
+        if (!port) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> handlerLock(port->handlerMutex);
+        if (port->closing) {
+            continue;
+        }
+
+        if (event.data.u64 & 1) {
+            handleNotify(port.get());
+        } else {
+            handleReadable(port.get(), event.events);
+        }
+    }
+}
+
+// вызывается под handlerMutex
+void PortMultiplexer::handleReadable(PortContext* port, uint32_t events) {
+    port->readCompletions++;
+
+    ssize_t bytesRead = read(port->serial.getDescriptor(), port->readBuffer, MUX_READ_BUFFER_SIZE);
+    if (bytesRead > 0) {
+        port->bytesReceived += bytesRead;
+        port->metrics->add(MetricCounter::BytesReceived, bytesRead);
+        port->pipeline->pushBytes(port->readBuffer, static_cast<size_t>(bytesRead));
+    } else if (bytesRead < 0 && (errno == EAGAIN || errno == EINTR)) {
+        // ложное пробуждение - ждём следующих данных
+    } else if (bytesRead < 0 || (events & (EPOLLERR | EPOLLHUP))) {
+        // устройство отключено (EIO) или другой конец pty закрыт: дескриптор больше
+        // не взводится, порт закрывается removePort, как после ошибки чтения в IOCP
+        port->errors++;
+        return;
+    }
+
+    if (!rearm(port->serial.getDescriptor(), readKey(port->id))) {
+        port->errors++;
+    }
+}
+
+// вызывается под handlerMutex
+void PortMultiplexer::handleNotify(PortContext* port) {
+    uint64_t count;
+    ssize_t result = read(port->notifyFd, &count, sizeof(count));
+    (void)result; // счётчик сбрасывается; при EAGAIN результаты уже забраны
+
+    deliverResults(port);
+
+    if (!rearm(port->notifyFd, notifyKey(port->id))) {
+        port->errors++;
+    }
+}
+
+bool PortMultiplexer::rearm(int fd, uint64_t key) {
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u64 = key;
+    return epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+void PortMultiplexer::finishClose(PortContext* port) {
+    port->pipeline->stop();
+
+    {
+        // начатая запись дописывается, а новые видят closing: дескриптор не закроется
+        // посреди write и запись не уйдёт в чужой файл, получивший тот же номер
+        std::lock_guard<std::mutex> writeLock(port->writeMutex);
+        port->serial.close();
+    }
+
+    std::lock_guard<std::mutex> lock(m_portsMutex);
+    if (port->notifyFd >= 0) {
+        close(port->notifyFd);
+        port->notifyFd = -1;
+    }
+    port->closed = true;
+    m_portClosed.notify_all();
+}
+
+bool PortMultiplexer::writeData(int portId, const char* data, size_t length) {
+    std::shared_ptr<PortContext> port = findPort(portId);
+    if (!port) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> writeLock(port->writeMutex);
+    if (port->closing) {
+        return false;
+    }
+
+    // запись синхронная (PosixSerialPort, tcdrain) и учитывается в метриках порта там же
+    if (!port->serial.writeData(data, length)) {
+        port->errors++;
+        return false;
+    }
+
+    port->bytesSent += length;
+    return true;
+}
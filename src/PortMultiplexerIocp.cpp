@@ -0,0 +1,261 @@
+#include "PortMultiplexer.h"
+#include "Tracer.h"
+#include <iostream>
+
+bool PortMultiplexer::start() {
+    if (m_completionPort != NULL) {
+        return true;
+    }
+
+    m_completionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, static_cast<DWORD>(m_loopThreadCount));
+    if (m_completionPort == NULL) {
+        std::cerr << "Ошибка создания порта завершения ввода-вывода" << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < m_loopThreadCount; i++) {
+        m_loopThreads.emplace_back(&PortMultiplexer::loopThreadFunc, this);
+    }
+
+    return true;
+}
+
+void PortMultiplexer::stop() {
+    if (m_completionPort == NULL) {
+        return;
+    }
+
+    for (int portId : getPortIds()) {
+        removePort(portId);
+    }
+
+    // ключ 0 - сигнал завершения потоку цикла
+    for (size_t i = 0; i < m_loopThreads.size(); i++) {
+        PostQueuedCompletionStatus(m_completionPort, 0, 0, NULL);
+    }
+    for (std::thread& thread : m_loopThreads) {
+        thread.join();
+    }
+    m_loopThreads.clear();
+
+    CloseHandle(m_completionPort);
+    m_completionPort = NULL;
+}
+
+int PortMultiplexer::addPort(const std::string& portName, int baudRate, const ResultsCallback& callback) {
+    if (m_completionPort == NULL) {
+        return -1;
+    }
+
+    HANDLE handle = CreateFileA(
+        ("\\\\.\\" + portName).c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        0,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_OVERLAPPED,
+        NULL
+        );
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "Ошибка открытия порта " << portName << std::endl;
+        return -1;
+    }
+
+    if (!configurePort(handle, baudRate)) {
+        std::cerr << "Ошибка конфигурации порта " << portName << std::endl;
+        CloseHandle(handle);
+        return -1;
+    }
+
+    auto port = std::make_shared<PortContext>();
+    port->name = portName;
+    port->handle = handle;
+    port->callback = callback;
+    port->pipeline = std::make_unique<ReceivePipeline>(m_pool);
+    port->metrics = MetricsRegistry::getInstance().getPort(portName);
+    port->pipeline->setMetrics(port->metrics);
+    port->pipeline->setErrorSimulation(false);
+
+    {
+        std::lock_guard<std::mutex> lock(m_portsMutex);
+        port->id = m_nextPortId++;
+        m_ports[port->id] = port;
+    }
+
+    ULONG_PTR key = static_cast<ULONG_PTR>(port->id);
+    port->pipeline->setResultsCallback([this, key]() {
+        // готовые результаты передаются в поток цикла, чтобы обратные вызовы шли оттуда
+        PostQueuedCompletionStatus(m_completionPort, 0, key, NULL);
+    });
+
+    if (CreateIoCompletionPort(handle, m_completionPort, key, 0) == NULL || !issueRead(port.get())) {
+        port->closing = true;
+        finishClose(port.get());
+
+        std::lock_guard<std::mutex> lock(m_portsMutex);
+        m_ports.erase(port->id);
+        return -1;
+    }
+
+    return port->id;
+}
+
+void PortMultiplexer::removePort(int portId) {
+    std::shared_ptr<PortContext> port = findPort(portId);
+    if (!port) {
+        return;
+    }
+
+    port->closing = true;
+
+    std::unique_lock<std::mutex> lock(m_portsMutex);
+    if (!port->closed) {
+        CancelIoEx(port->handle, &port->readOverlapped);
+    }
+    // завершение отменённого чтения (или его тайм-аут) закроет порт в потоке цикла
+    m_portClosed.wait(lock, [&port]() { return port->closed; });
+    m_ports.erase(portId);
+}
+
+bool PortMultiplexer::configurePort(HANDLE handle, int baudRate) {
+    DCB dcb = { 0 };
+    dcb.DCBlength = sizeof(DCB);
+
+    if (!GetCommState(handle, &dcb)) {
+        return false;
+    }
+
+    dcb.BaudRate = baudRate;
+    dcb.ByteSize = 8;
+    dcb.StopBits = ONESTOPBIT;
+    dcb.Parity = NOPARITY;
+    dcb.fDtrControl = DTR_CONTROL_ENABLE;
+
+    if (!SetCommState(handle, &dcb)) {
+        return false;
+    }
+
+    // чтение завершается, как только пришёл хотя бы один байт, или по тайм-ауту
+    COMMTIMEOUTS timeouts = {0};
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+    timeouts.ReadTotalTimeoutConstant = MUX_READ_TIMEOUT_MS;
+    timeouts.WriteTotalTimeoutConstant = 0;
+    timeouts.WriteTotalTimeoutMultiplier = 0;
+
+    return SetCommTimeouts(handle, &timeouts);
+}
+
+bool PortMultiplexer::issueRead(PortContext* port) {
+    ZeroMemory(&port->readOverlapped, sizeof(OVERLAPPED));
+
+    if (!ReadFile(port->handle, port->readBuffer, MUX_READ_BUFFER_SIZE, NULL, &port->readOverlapped)) {
+        return GetLastError() == ERROR_IO_PENDING;
+    }
+    return true;
+}
+
+void PortMultiplexer::loopThreadFunc() {
+    Tracer::setThreadName("iocp loop");
+
+    while (true) {
+        DWORD bytesTransferred = 0;
+        ULONG_PTR key = 0;
+        LPOVERLAPPED overlapped = NULL;
+
+        BOOL success = GetQueuedCompletionStatus(m_completionPort, &bytesTransferred, &key, &overlapped, INFINITE);
+
+        if (!success && overlapped == NULL) {
+            // сам порт завершения закрыт
+            return;
+        }
+        if (key == 0) {
+            return;
+        }
+
+        std::shared_ptr<PortContext> port = findPort(static_cast<int>(key));
+        if (!port) {
+            continue;
+        }
+
+        if (overlapped == NULL) {
+            deliverResults(port.get());
+        } else {
+            handleReadCompletion(port.get(), success, bytesTransferred);
+        }
+    }
+}
+
+void PortMultiplexer::handleReadCompletion(PortContext* port, BOOL success, DWORD bytesTransferred) {
+    if (port->closing) {
+        finishClose(port);
+        return;
+    }
+
+    port->readCompletions++;
+
+    if (!success) {
+        port->errors++;
+    } else if (bytesTransferred > 0) {
+        port->bytesReceived += bytesTransferred;
+        port->metrics->add(MetricCounter::BytesReceived, bytesTransferred);
+        port->pipeline->pushBytes(port->readBuffer, bytesTransferred);
+    }
+
+    if (!issueRead(port)) {
+        port->errors++;
+        finishClose(port);
+    }
+}
+
+void PortMultiplexer::finishClose(PortContext* port) {
+    port->pipeline->stop();
+
+    std::lock_guard<std::mutex> lock(m_portsMutex);
+    if (port->handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(port->handle);
+        port->handle = INVALID_HANDLE_VALUE;
+    }
+    port->closed = true;
+    m_portClosed.notify_all();
+}
+
+bool PortMultiplexer::writeData(int portId, const char* data, size_t length) {
+    std::shared_ptr<PortContext> port = findPort(portId);
+    if (!port || port->closing) {
+        return false;
+    }
+
+    // событие на поток; младший бит в hEvent отключает уведомление порта завершения о записи
+    struct WriteEvent {
+        HANDLE handle = CreateEventA(NULL, TRUE, FALSE, NULL);
+        ~WriteEvent() { CloseHandle(handle); }
+    };
+    thread_local WriteEvent writeEvent;
+
+    OVERLAPPED overlapped = {0};
+    overlapped.hEvent = reinterpret_cast<HANDLE>(reinterpret_cast<ULONG_PTR>(writeEvent.handle) | 1);
+
+    DWORD bytesWritten = 0;
+    BOOL success;
+    {
+        ScopedLatency latency(port->metrics, MetricStage::Write);
+        success = WriteFile(port->handle, data, static_cast<DWORD>(length), NULL, &overlapped);
+        if (!success && GetLastError() == ERROR_IO_PENDING) {
+            success = TRUE;
+        }
+        if (success) {
+            success = GetOverlappedResult(port->handle, &overlapped, &bytesWritten, TRUE);
+        }
+    }
+
+    if (!success || bytesWritten != length) {
+        port->errors++;
+        return false;
+    }
+
+    port->bytesSent += bytesWritten;
+    port->metrics->add(MetricCounter::BytesSent, bytesWritten);
+    return true;
+}
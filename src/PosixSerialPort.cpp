@@ -0,0 +1,240 @@
+#include "PosixSerialPort.h"
+#include "Tracer.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+bool toSpeed(int baudRate, speed_t& speed) {
+    switch (baudRate) {
+        case 1200: speed = B1200; return true;
+        case 2400: speed = B2400; return true;
+        case 4800: speed = B4800; return true;
+        case 9600: speed = B9600; return true;
+        case 19200: speed = B19200; return true;
+        case 38400: speed = B38400; return true;
+        case 57600: speed = B57600; return true;
+        case 115200: speed = B115200; return true;
+        case 230400: speed = B230400; return true;
+#ifdef B460800
+        case 460800: speed = B460800; return true;
+#endif
+#ifdef B921600
+        case 921600: speed = B921600; return true;
+#endif
+#ifdef B1000000
+        case 1000000: speed = B1000000; return true;
+#endif
+#ifdef B2000000
+        case 2000000: speed = B2000000; return true;
+#endif
+#ifdef B3000000
+        case 3000000: speed = B3000000; return true;
+#endif
+        default: return false;
+    }
+}
+
+} // namespace
+
+PosixSerialPort::~PosixSerialPort() {
+    close();
+}
+
+bool PosixSerialPort::open(const std::string& portName, int baudRate) {
+    if (m_isOpen) {
+        close();
+    }
+
+    m_portName = portName;
+    m_baudRate = baudRate;
+
+    m_fd = ::open(portName.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (m_fd < 0) {
+        std::cerr << "Ошибка открытия порта " << portName << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!configurePort()) {
+        std::cerr << "Ошибка конфигурации порта " << portName << std::endl;
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    m_metrics = MetricsRegistry::getInstance().getPort(portName);
+    m_isOpen = true;
+    return true;
+}
+
+void PosixSerialPort::close() {
+    stopAsyncReading();
+
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+
+    m_isOpen = false;
+}
+
+bool PosixSerialPort::configurePort() {
+    speed_t speed;
+    if (!toSpeed(m_baudRate, speed)) {
+        std::cerr << "Скорость " << m_baudRate << " бод не поддерживается" << std::endl;
+        return false;
+    }
+
+    termios options;
+    if (tcgetattr(m_fd, &options) != 0) {
+        return false;
+    }
+
+    cfmakeraw(&options);
+    options.c_cflag |= CLOCAL | CREAD;
+    options.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+    options.c_iflag &= ~(IXON | IXOFF | IXANY);
+    // чтение не блокируется: поток чтения ждёт данных в poll
+    options.c_cc[VMIN] = 0;
+    options.c_cc[VTIME] = 0;
+
+    if (cfsetispeed(&options, speed) != 0 || cfsetospeed(&options, speed) != 0) {
+        return false;
+    }
+
+    return tcsetattr(m_fd, TCSANOW, &options) == 0;
+}
+
+bool PosixSerialPort::writeData(const char* data, size_t length) {
+    if (!isOpen()) return false;
+
+    TRACE_SCOPE_ARG("writeData", length);
+
+    size_t written = 0;
+    {
+        ScopedLatency latency(m_metrics, MetricStage::Write);
+        while (written < length) {
+            ssize_t result = ::write(m_fd, data + written, length - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            written += static_cast<size_t>(result);
+        }
+        // как синхронный WriteFile: возврат, когда передатчик опустел
+        tcdrain(m_fd);
+    }
+
+    if (m_metrics && written > 0) {
+        m_metrics->add(MetricCounter::BytesSent, written);
+    }
+
+    CaptureWriter* capture = m_capture;
+    if (capture && written > 0) {
+        capture->record(CaptureDirection::Transmitted, data, written);
+    }
+
+    return written == length;
+}
+
+bool PosixSerialPort::startAsyncReading(const DataReadyCallback& callback) {
+    if (!m_isOpen || m_keepReading) {
+        return false;
+    }
+
+    m_rxRing.reset();
+    m_notifyPending = false;
+    m_dataCallback = callback;
+    m_keepReading = true;
+    m_readingThread = std::thread(&PosixSerialPort::readingThreadFunc, this);
+
+    return true;
+}
+
+void PosixSerialPort::stopAsyncReading() {
+    m_keepReading = false;
+    if (m_readingThread.joinable()) {
+        m_readingThread.join();
+    }
+    m_dataCallback = nullptr;
+}
+
+void PosixSerialPort::readingThreadFunc() {
+    Tracer::setThreadName("reader");
+
+    while (m_keepReading) {
+        char* region;
+        size_t space = m_rxRing.writableRegion(region);
+        if (space == 0) {
+            // потребитель не успевает - ждём освобождения места, данные остаются в буфере драйвера
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        pollfd descriptor{m_fd, POLLIN, 0};
+        int ready = poll(&descriptor, 1, POSIX_READ_TIMEOUT_MS);
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            continue;
+        }
+        if (ready < 0 || (descriptor.revents & (POLLERR | POLLNVAL))) {
+            break;
+        }
+
+        ssize_t bytesRead = ::read(m_fd, region, space);
+        if (bytesRead > 0) {
+            TRACE_SCOPE_ARG("readChunk", bytesRead);
+
+            CaptureWriter* capture = m_capture;
+            if (capture) {
+                capture->record(CaptureDirection::Received, region, bytesRead);
+            }
+            m_metrics->add(MetricCounter::BytesReceived, bytesRead);
+
+            m_rxRing.commitWrite(bytesRead);
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!m_notifyPending.exchange(true) && m_dataCallback) {
+                m_dataCallback();
+            }
+        } else if (bytesRead < 0 && errno != EAGAIN && errno != EINTR) {
+            // устройство отключено (EIO) или закрыто - приём прекращается, как у ComPort
+            break;
+        } else if (descriptor.revents & POLLHUP) {
+            // другой конец pty закрыт: poll больше не ждёт, не крутимся вхолостую
+            std::this_thread::sleep_for(std::chrono::milliseconds(POSIX_READ_TIMEOUT_MS));
+        }
+    }
+}
+
+size_t PosixSerialPort::readReceived(std::string& out) {
+    m_notifyPending = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    size_t total = 0;
+    const char* region;
+    size_t length;
+
+    while ((length = m_rxRing.readableRegion(region)) > 0) {
+        out.append(region, length);
+        m_rxRing.commitRead(length);
+        total += length;
+    }
+
+    return total;
+}
+
+bool PosixSerialPort::setBaudRate(int baudRate) {
+    if (!isOpen()) return false;
+
+    m_baudRate = baudRate;
+    return configurePort();
+}
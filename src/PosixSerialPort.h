@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "ByteRingBuffer.h"
+#include "CaptureWriter.h"
+#include "Metrics.h"
+#include "SerialPort.h"
+
+#define POSIX_RX_RING_SIZE (64 * 1024)
+#define POSIX_READ_TIMEOUT_MS 50 // как таймауты чтения ComPort
+
+// Последовательный порт через termios (Linux и другие POSIX-системы): /dev/ttyS*, /dev/ttyUSB*, pty.
+// Режим 8N1 без управления потоком, как у ComPort. Запись синхронная - возвращает,
+// когда байты ушли в линию (tcdrain), на этом строятся времена CSMA/CD.
+class PosixSerialPort : public SerialPort {
+public:
+    PosixSerialPort() = default;
+    ~PosixSerialPort() override;
+
+    bool open(const std::string& portName, int baudRate = 9600) override;
+    void close() override;
+    bool isOpen() const override { return m_isOpen; }
+
+    using SerialPort::writeData;
+    bool writeData(const char* data, size_t length) override;
+
+    bool startAsyncReading(const DataReadyCallback& callback = nullptr) override;
+    void stopAsyncReading() override;
+
+    size_t readReceived(std::string& out) override;
+
+    bool setBaudRate(int baudRate) override;
+
+    void setCaptureWriter(CaptureWriter* writer) override { m_capture = writer; }
+    PortMetrics* getMetrics() const override { return m_metrics; }
+
+    std::string getPortName() const override { return m_portName; }
+    int getBaudRate() const override { return m_baudRate; }
+
+    // для внешнего цикла событий (PortMultiplexer): тот читает дескриптор сам,
+    // startAsyncReading при этом не вызывается
+    int getDescriptor() const { return m_fd; }
+
+private:
+    bool configurePort();
+    void readingThreadFunc();
+
+    int m_fd = -1;
+    std::string m_portName;
+    int m_baudRate = 9600;
+
+    std::atomic<bool> m_isOpen{false};
+    std::atomic<bool> m_keepReading{false};
+    std::thread m_readingThread;
+
+    ByteRingBuffer m_rxRing{POSIX_RX_RING_SIZE};
+    std::atomic<bool> m_notifyPending{false};
+    DataReadyCallback m_dataCallback;
+    std::atomic<CaptureWriter*> m_capture{nullptr};
+    PortMetrics* m_metrics = nullptr;
+};
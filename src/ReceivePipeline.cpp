@@ -0,0 +1,338 @@
+#include "ReceivePipeline.h"
+#include "ChannelManager.h"
+#include "CobsStuffer.h"
+#include "EncodingConverter.h"
+#include "Tracer.h"
+#include <string_view>
+
+ReceivePipeline::ReceivePipeline(ThreadPool& pool, LogQueue* log)
+    : m_pool(pool)
+    , m_log(log) {
+}
+
+ReceivePipeline::~ReceivePipeline() {
+    stop();
+}
+
+void ReceivePipeline::start(const ByteSource& source, const ResultsReadyCallback& callback) {
+    stop();
+
+    m_source = source;
+    m_resultsCallback = callback;
+    m_dataAvailable = false;
+    m_keepRunning = true;
+    m_inputThread = std::thread(&ReceivePipeline::inputThreadFunc, this);
+}
+
+void ReceivePipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_inputMutex);
+        m_keepRunning = false;
+    }
+    m_inputCondition.notify_one();
+
+    if (m_inputThread.joinable()) {
+        m_inputThread.join();
+    }
+
+    waitIdle();
+
+    m_receivedBytes.clear();
+    m_nextIndex = 0;
+
+    std::lock_guard<std::mutex> lock(m_orderMutex);
+    m_pending.clear();
+    m_nextToPublish = 0;
+    m_reassembler.clear();
+}
+
+void ReceivePipeline::notifyDataAvailable() {
+    {
+        std::lock_guard<std::mutex> lock(m_inputMutex);
+        m_dataAvailable = true;
+    }
+    m_inputCondition.notify_one();
+}
+
+void ReceivePipeline::inputThreadFunc() {
+    Tracer::setThreadName("deframe");
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_inputMutex);
+            m_inputCondition.wait(lock, [this]() { return m_dataAvailable || !m_keepRunning; });
+
+            if (!m_keepRunning) {
+                return;
+            }
+            m_dataAvailable = false;
+        }
+
+        m_chunk.clear();
+        if (m_source && m_source(m_chunk) > 0) {
+            pushBytes(m_chunk.data(), m_chunk.size());
+        }
+    }
+}
+
+void ReceivePipeline::pushBytes(const char* data, size_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    if (m_frameManager.getFramingMode() == FramingMode::Escaped &&
+        static_cast<uint8_t>(data[0]) == START_FLAG_BYTE && !m_receivedBytes.empty()) {
+        m_receivedBytes.clear();
+    }
+
+    std::string_view chunk(data, length);
+    const std::string jamPattern(JAM_SIGNAL_SIZE / 8, static_cast<char>(JAM_SIGNAL_BYTE));
+    size_t jamPos = chunk.find(jamPattern);
+
+    if (jamPos != std::string_view::npos) {
+        if (m_log) {
+            m_log->push(LogEvent::JamDetected, true);
+        }
+        if (m_metrics) {
+            m_metrics->add(MetricCounter::JamDetected);
+        }
+
+        m_receivedBytes.append(chunk.substr(0, jamPos));
+        m_receivedBytes.append(chunk.substr(jamPos + jamPattern.length()));
+    } else {
+        m_receivedBytes.append(chunk);
+    }
+
+    TRACE_SCOPE_ARG("deframe", length);
+    ScopedLatency latency(m_metrics, MetricStage::Deframe);
+
+    size_t consumed = 0;
+    size_t frameStart;
+    size_t frameEnd;
+
+    while (findCompleteFrame(consumed, frameStart, frameEnd)) {
+        decodeFrame(m_nextIndex++, m_receivedBytes.substr(frameStart, frameEnd - frameStart));
+        consumed = frameEnd;
+    }
+
+    m_receivedBytes.erase(0, consumed);
+}
+
+bool ReceivePipeline::findCompleteFrame(size_t from, size_t& frameStart, size_t& frameEnd) const {
+    if (m_frameManager.getFramingMode() == FramingMode::Cobs) {
+        return findCobsFrame(from, frameStart, frameEnd);
+    }
+
+    const std::string& data = m_receivedBytes;
+
+    if (data.length() < from + HEADER_SIZE + 1 + 1 + TRAILER_SIZE) {
+        return false;
+    }
+
+    size_t startPos = data.find(static_cast<char>(START_FLAG_BYTE), from);
+    if (startPos == std::string::npos) {
+        return false;
+    }
+
+    while (startPos < data.length() && data[startPos] == static_cast<char>(START_FLAG_BYTE)) {
+        startPos++;
+    }
+    if (startPos > from) startPos--;
+
+    for (size_t i = startPos + 1; i < data.length(); i++) {
+        if (static_cast<uint8_t>(data[i]) == END_FLAG_BYTE) {
+            size_t frameLength = i - startPos + 1;
+
+            if (frameLength >= HEADER_SIZE + 1 + 1 + TRAILER_SIZE &&
+                static_cast<uint8_t>(data[startPos]) == START_FLAG_BYTE) {
+                frameStart = startPos;
+                frameEnd = i + 1;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// кадр COBS - всё до разделителя включительно; пустые и короткие участки
+// (jam-сигнал, хвост кадра, начатого до подключения) пропускаются
+bool ReceivePipeline::findCobsFrame(size_t from, size_t& frameStart, size_t& frameEnd) const {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(m_receivedBytes.data());
+    const size_t size = m_receivedBytes.size();
+
+    size_t pos = from;
+    while (pos < size) {
+        size_t end = pos + CobsStuffer<COBS_DELIMITER>::findDelimiter(data + pos, size - pos);
+        if (end == size) {
+            return false;
+        }
+        if (end - pos >= COBS_MIN_FRAME_SIZE) {
+            frameStart = pos;
+            frameEnd = end + 1;
+            return true;
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+void ReceivePipeline::decodeFrame(uint64_t index, std::string stuffedFrame) {
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_inFlight++;
+    }
+
+    m_pool.submit([this, index, stuffedFrame = std::move(stuffedFrame)]() mutable {
+        TRACE_SCOPE_ARG("decodeFrame", index);
+        DecodedFrame result;
+        PortMetrics* metrics = m_metrics;
+
+        Frame frame;
+        {
+            TRACE_SCOPE("byteUnstuff");
+            ScopedLatency latency(metrics, MetricStage::Unstuff);
+            frame = m_frameManager.byteUnstuff(stuffedFrame);
+        }
+        if (m_errorSimulation) {
+            frame.simulateErrors();
+        }
+        result.flags = frame.getFlags();
+        result.isCompressed = frame.isCompressed();
+        if (!result.isCompressed) {
+            result.corruptedData = frame.dataToString();
+        }
+
+        {
+            TRACE_SCOPE("correctErrors");
+            ScopedLatency latency(metrics, MetricStage::Correct);
+            result.correctionResult = frame.correctErrors();
+        }
+        result.sequence = frame.getSequence();
+        result.total = frame.getTotal();
+        result.fcsSize = frame.getFcs().size();
+        result.stuffedFcsSize = m_frameManager.getStuffedFcsSize(frame.getFcs());
+        result.payload = frame.dataToString();
+        result.stuffedFrame = std::move(stuffedFrame);
+
+        if (metrics) {
+            metrics->add(MetricCounter::FramesReceived);
+            if (result.correctionResult == 1) {
+                metrics->add(MetricCounter::FramesCorrected);
+            } else if (result.correctionResult == 2) {
+                metrics->add(MetricCounter::DoubleErrors);
+            }
+        }
+
+        completeFrame(index, std::move(result));
+
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        if (--m_inFlight == 0) {
+            m_idleCondition.notify_all();
+        }
+    });
+}
+
+void ReceivePipeline::completeFrame(uint64_t index, DecodedFrame&& frame) {
+    std::lock_guard<std::mutex> lock(m_orderMutex);
+    m_pending.emplace(index, std::move(frame));
+
+    auto it = m_pending.find(m_nextToPublish);
+    while (it != m_pending.end()) {
+        publish(std::move(it->second));
+        m_pending.erase(it);
+        it = m_pending.find(++m_nextToPublish);
+    }
+}
+
+void ReceivePipeline::publish(DecodedFrame&& frame) {
+    TRACE_SCOPE_ARG("publish", frame.sequence);
+
+    if (m_log) {
+        if (frame.isCompressed) {
+            m_log->push(LogEvent::CompressedFrameReceived, true, frame.sequence, frame.total,
+                        static_cast<int32_t>(frame.payload.size()));
+        } else if (frame.corruptedData != "\n") {
+            m_log->push(LogEvent::FrameReceived, true, frame.corruptedData.data(), frame.corruptedData.size(),
+                        frame.sequence, frame.total);
+        }
+        m_log->push(LogEvent::CorrectionResult, true, frame.correctionResult);
+    }
+
+    ReassemblyResult assembly = m_reassembler.accept(frame.sequence, frame.total, frame.flags, frame.payload.data(),
+                                                     frame.payload.size(), MessageReassembler::Clock::now(), m_completed);
+
+    if (uint64_t evicted = m_reassembler.takeEvictedCount()) {
+        if (m_log) {
+            m_log->push(LogEvent::MessagesEvicted, true, static_cast<int32_t>(evicted));
+        }
+        if (m_metrics) {
+            m_metrics->add(MetricCounter::MessagesEvicted, evicted);
+        }
+    }
+    if (assembly == ReassemblyResult::Duplicate) {
+        if (m_log) {
+            m_log->push(LogEvent::FrameDuplicate, true, frame.sequence, frame.total);
+        }
+        if (m_metrics) {
+            m_metrics->add(MetricCounter::FramesDuplicate);
+        }
+    } else if (assembly == ReassemblyResult::Invalid && m_log) {
+        m_log->push(LogEvent::FrameRejected, true, frame.sequence, frame.total, static_cast<int32_t>(frame.payload.size()));
+    }
+
+    bool messageComplete = assembly == ReassemblyResult::Completed;
+    std::string messageText;
+
+    if (messageComplete) {
+        if (m_completed.flags & FRAME_FLAG_COMPRESSED) {
+            TRACE_SCOPE_ARG("decompress", m_completed.data.size());
+            ScopedLatency latency(m_metrics, MetricStage::Decompress);
+
+            if (!FrameManager::decompressMessage(m_completed.data, messageText)) {
+                if (m_log) {
+                    m_log->push(LogEvent::DecompressFailed, true);
+                }
+                if (m_metrics) {
+                    m_metrics->add(MetricCounter::DecompressErrors);
+                }
+            }
+        } else {
+            TRACE_SCOPE_ARG("transcode", m_completed.data.size());
+            ScopedLatency latency(m_metrics, MetricStage::Transcode);
+            messageText = EncodingConverter::windows1251ToUtf8(m_completed.data);
+        }
+        m_reassembler.recycle(std::move(m_completed.data));
+        m_completed.data.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.frames.push_back(std::move(frame));
+        if (messageComplete) {
+            m_results.messages.push_back(std::move(messageText));
+            m_results.messageChannels.push_back((m_completed.flags & FRAME_FLAG_CHANNEL_MASK) >> FRAME_FLAG_CHANNEL_SHIFT);
+        }
+    }
+
+    if (messageComplete && m_metrics) {
+        m_metrics->add(MetricCounter::MessagesReceived);
+    }
+
+    if (!m_publishPending.exchange(true) && m_resultsCallback) {
+        m_resultsCallback();
+    }
+}
+
+void ReceivePipeline::takeResults(ReceiveResults& out) {
+    m_publishPending = false;
+
+    out.clear();
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    std::swap(out, m_results);
+}
+
+void ReceivePipeline::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_idleMutex);
+    m_idleCondition.wait(lock, [this]() { return m_inFlight == 0; });
+}
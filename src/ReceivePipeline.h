@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameManager.h"
+#include "LogQueue.h"
+#include "MessageReassembler.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+
+struct DecodedFrame {
+    std::string stuffedFrame;
+    uint8_t sequence = 0;
+    uint8_t total = 0;
+    uint8_t flags = 0;
+    size_t fcsSize = 0;
+    size_t stuffedFcsSize = 0;
+    int correctionResult = -1;
+    bool isCompressed = false;
+    std::string corruptedData;  // данные до исправления, Windows-1251 (для сжатых кадров - не заполняется)
+    std::string payload;        // данные после исправления (Windows-1251 или сжатые); перекодируются после сборки сообщения
+};
+
+struct ReceiveResults {
+    std::vector<DecodedFrame> frames;
+    std::vector<std::string> messages;  // собранные сообщения, UTF-8
+    std::vector<uint8_t> messageChannels; // логический канал каждого сообщения из messages
+
+    void clear() { frames.clear(); messages.clear(); messageChannels.clear(); }
+};
+
+// Конвейер приёма: выделение кадров -> снятие байт-стаффинга -> исправление ошибок ->
+// сборка сообщений -> распаковка (если сообщение сжато) и перекодировка. Выделение кадров идёт в собственном потоке,
+// независимые кадры декодируются параллельно в пуле, а в GUI публикуются только
+// готовые результаты в исходном порядке. Сообщение собирается MessageReassembler,
+// поэтому пропуски, повторы и перестановки кадров на линии не смешивают сообщения.
+class ReceivePipeline {
+public:
+    using ByteSource = std::function<size_t(std::string& out)>;
+    using ResultsReadyCallback = std::function<void()>;
+
+    ReceivePipeline(ThreadPool& pool, LogQueue* log = nullptr);
+    ~ReceivePipeline();
+
+    void start(const ByteSource& source, const ResultsReadyCallback& callback);
+    void stop();
+
+    // для работы без собственного потока, когда байты подаются через pushBytes
+    void setResultsCallback(const ResultsReadyCallback& callback) { m_resultsCallback = callback; }
+
+    // метрики этапов приёма; задаётся до start/pushBytes, nullptr - не собирать
+    void setMetrics(PortMetrics* metrics) { m_metrics = metrics; }
+
+    // выделение кадров; задаётся до start/pushBytes, как у передатчика на другом конце линии
+    void setFramingMode(FramingMode framing) { m_frameManager.setFramingMode(framing); }
+
+    // учебная порча принятых кадров (ErrorSimulator) перед исправлением; задаётся до start/pushBytes.
+    // Нужна только демонстрации в GUI - шлюзы и утилиты с настоящим трафиком её выключают
+    void setErrorSimulation(bool enabled) { m_errorSimulation = enabled; }
+
+    // вызывается потоком чтения порта, когда в источнике появились данные
+    void notifyDataAvailable();
+
+    // выделение кадров без собственного потока; вызывать из одного потока
+    void pushBytes(const char* data, size_t length);
+
+    // забирает накопленные результаты; вызывается потребителем
+    void takeResults(ReceiveResults& out);
+
+    void waitIdle();
+
+private:
+    void inputThreadFunc();
+    bool findCompleteFrame(size_t from, size_t& frameStart, size_t& frameEnd) const;
+    bool findCobsFrame(size_t from, size_t& frameStart, size_t& frameEnd) const;
+    void decodeFrame(uint64_t index, std::string stuffedFrame);
+    void completeFrame(uint64_t index, DecodedFrame&& frame);
+    void publish(DecodedFrame&& frame);
+
+    ThreadPool& m_pool;
+    LogQueue* m_log;
+    PortMetrics* m_metrics = nullptr;
+    bool m_errorSimulation = true;
+    FrameManager m_frameManager;
+
+    ByteSource m_source;
+    ResultsReadyCallback m_resultsCallback;
+
+    std::thread m_inputThread;
+    std::mutex m_inputMutex;
+    std::condition_variable m_inputCondition;
+    bool m_dataAvailable = false;
+    bool m_keepRunning = false;
+
+    // состояние выделения кадров (только поток ввода)
+    std::string m_receivedBytes;
+    std::string m_chunk;
+    uint64_t m_nextIndex = 0;
+
+    // восстановление порядка и сборка (под m_orderMutex)
+    std::mutex m_orderMutex;
+    std::map<uint64_t, DecodedFrame> m_pending;
+    uint64_t m_nextToPublish = 0;
+    MessageReassembler m_reassembler;
+    ReassembledMessage m_completed;
+
+    std::mutex m_resultsMutex;
+    ReceiveResults m_results;
+    std::atomic<bool> m_publishPending{false};
+
+    std::mutex m_idleMutex;
+    std::condition_variable m_idleCondition;
+    size_t m_inFlight = 0;
+};
@@ -0,0 +1,135 @@
+#include "CaptureReader.h"
+#include "Metrics.h"
+#include "ReceivePipeline.h"
+#include "ThreadPool.h"
+#include "Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Воспроизведение записи трафика через конвейер приёма. Учебная порча кадров выключена,
+// чтобы результаты исправления ошибок зависели только от записи и повторялись от запуска к запуску.
+// Использование: capture_replay <файл> [--realtime] [--repeat N] [--threads N] [--cobs] [--metrics] [--trace файл.json]
+// --cobs - запись сделана с выделением кадров COBS (link_daemon --cobs).
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Использование: capture_replay <файл> [--realtime] [--repeat N] [--threads N] [--cobs] [--metrics] [--trace файл.json]" << std::endl;
+        return 1;
+    }
+
+    std::string fileName = argv[1];
+    bool realtime = false;
+    int repeat = 1;
+    size_t threads = 0;
+    FramingMode framing = FramingMode::Escaped;
+    bool printMetrics = false;
+    std::string traceFileName;
+
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--realtime") == 0) {
+            realtime = true;
+        } else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (std::strcmp(argv[i], "--cobs") == 0) {
+            framing = FramingMode::Cobs;
+        } else if (std::strcmp(argv[i], "--metrics") == 0) {
+            printMetrics = true;
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            traceFileName = argv[++i];
+        }
+    }
+
+    CaptureReader reader;
+    if (!reader.open(fileName)) {
+        return 1;
+    }
+
+    ThreadPool pool(threads);
+    ReceivePipeline pipeline(pool);
+    pipeline.setErrorSimulation(false);
+    pipeline.setFramingMode(framing);
+    if (printMetrics) {
+        pipeline.setMetrics(MetricsRegistry::getInstance().getPort(fileName));
+    }
+    ReceiveResults results;
+
+    uint64_t bytes = 0;
+    uint64_t frames = 0;
+    uint64_t messages = 0;
+    uint64_t outcomes[4] = {0, 0, 0, 0}; // без ошибок, исправлено, двойная, пустые
+
+    auto collect = [&]() {
+        pipeline.takeResults(results);
+        frames += results.frames.size();
+        messages += results.messages.size();
+        for (const DecodedFrame& frame : results.frames) {
+            outcomes[frame.correctionResult >= 0 && frame.correctionResult <= 2 ? frame.correctionResult : 3]++;
+        }
+    };
+
+    if (!traceFileName.empty()) {
+        Tracer::setThreadName("replay");
+        Tracer::getInstance().start();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < repeat; pass++) {
+        reader.rewind();
+        auto passStart = std::chrono::steady_clock::now();
+        CaptureRecord record;
+
+        while (reader.next(record)) {
+            if (record.direction != CaptureDirection::Received) {
+                continue;
+            }
+
+            if (realtime) {
+                std::this_thread::sleep_until(passStart + std::chrono::nanoseconds(record.timestampNs));
+            }
+
+            pipeline.pushBytes(record.data, record.length);
+            bytes += record.length;
+            collect();
+        }
+    }
+
+    pipeline.waitIdle();
+    collect();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Байт:            " << bytes << std::endl;
+    std::cout << "Кадров:          " << frames << std::endl;
+    std::cout << "Сообщений:       " << messages << std::endl;
+    std::cout << "Без ошибок:      " << outcomes[0] << std::endl;
+    std::cout << "Исправлено:      " << outcomes[1] << std::endl;
+    std::cout << "Двойных ошибок:  " << outcomes[2] << std::endl;
+    std::cout << "Пустых:          " << outcomes[3] << std::endl;
+    std::cout << "Время, с:        " << seconds << std::endl;
+    if (seconds > 0) {
+        std::cout << "МБ/с:            " << bytes / seconds / (1024.0 * 1024.0) << std::endl;
+        std::cout << "Кадров/с:        " << frames / seconds << std::endl;
+    }
+
+    if (!traceFileName.empty()) {
+        Tracer::getInstance().stop();
+        if (!Tracer::getInstance().writeJson(traceFileName)) {
+            std::cerr << "Не удалось записать трассу в " << traceFileName << std::endl;
+        }
+    }
+
+    if (printMetrics) {
+        std::cout << MetricsRegistry::getInstance().toJson();
+    }
+
+    return 0;
+}
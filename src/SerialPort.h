@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+class CaptureWriter;
+class PortMetrics;
+
+// Общий интерфейс последовательного порта: настоящий COM-порт (ComPort)
+// или виртуальный (VirtualSerialPort). Передача и приём работают через него.
+class SerialPort {
+public:
+    // вызывается из потока, доставляющего данные, когда в пустом буфере приёма появились данные
+    using DataReadyCallback = std::function<void()>;
+
+    virtual ~SerialPort() = default;
+
+    virtual bool open(const std::string& portName, int baudRate = 9600) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    virtual bool writeData(const char* data, size_t length) = 0;
+    bool writeData(const std::string& data) { return writeData(data.data(), data.length()); }
+
+    virtual bool startAsyncReading(const DataReadyCallback& callback = nullptr) = 0;
+    virtual void stopAsyncReading() = 0;
+
+    // забирает всё принятое на данный момент; вызывается только потребителем
+    virtual size_t readReceived(std::string& out) = 0;
+
+    virtual bool setBaudRate(int baudRate) = 0;
+
+    // запись сырого трафика; nullptr - выключить
+    virtual void setCaptureWriter(CaptureWriter* writer) = 0;
+
+    // метрики открытого порта в MetricsRegistry; nullptr, пока порт не открывался
+    virtual PortMetrics* getMetrics() const = 0;
+
+    virtual std::string getPortName() const = 0;
+    virtual int getBaudRate() const = 0;
+};
@@ -0,0 +1,260 @@
+#include "SessionLog.h"
+#include "EncodingConverter.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+struct EventFormat {
+    const char* name;
+    const char* args[3]; // имена полей для args[0..2]; nullptr - аргумент не используется
+};
+
+// по порядку LogEvent
+const EventFormat EVENT_FORMATS[] = {
+    {"text", {nullptr, nullptr, nullptr}},
+    {"messageSegmented", {"frames", nullptr, nullptr}},
+    {"messageCompressed", {"bytes", "compressedBytes", nullptr}},
+    {"frameSent", {"frame", "total", nullptr}},
+    {"frameTransmitted", {"frame", nullptr, nullptr}},
+    {"frameFailed", {"frame", "attemptsExhausted", nullptr}},
+    {"channelBusy", {"attempt", "slots", "us"}},
+    {"collision", {"slots", "us", nullptr}},
+    {"jamSent", {nullptr, nullptr, nullptr}},
+    {"jamDetected", {nullptr, nullptr, nullptr}},
+    {"frameReceived", {"frame", "total", nullptr}},
+    {"compressedFrameReceived", {"frame", "total", "bytes"}},
+    {"decompressFailed", {nullptr, nullptr, nullptr}},
+    {"correction", {"result", nullptr, nullptr}},
+    {"frameDuplicate", {"frame", "total", nullptr}},
+    {"frameRejected", {"frame", "total", "bytes"}},
+    {"messagesEvicted", {"count", nullptr, nullptr}},
+    {"messageCompleted", {"message", "success", nullptr}},
+    {"messageTooLong", {"message", "frames", nullptr}},
+};
+static_assert(sizeof(EVENT_FORMATS) / sizeof(EVENT_FORMATS[0]) == static_cast<size_t>(LogEvent::MessageTooLong) + 1,
+              "EVENT_FORMATS должен перечислять все LogEvent");
+
+void appendJsonString(std::string& out, const char* value, size_t length) {
+    out += '"';
+    for (size_t i = 0; i < length; i++) {
+        char c = value[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+SessionLog::~SessionLog() {
+    close();
+}
+
+bool SessionLog::open(const std::string& fileName, size_t maxFileSize, int maxFiles) {
+    close();
+
+    // журнал продолжается после перезапуска
+    m_file = std::fopen(fileName.c_str(), "ab");
+    if (!m_file) {
+        std::cerr << "Ошибка открытия журнала сеанса " << fileName << std::endl;
+        return false;
+    }
+    std::fseek(m_file, 0, SEEK_END);
+    m_fileSize = static_cast<size_t>(std::max(0L, std::ftell(m_file)));
+
+    m_fileName = fileName;
+    m_maxFileSize = maxFileSize;
+    m_maxFiles = std::max(1, maxFiles);
+    m_activeRecords.clear();
+    m_activeRecords.reserve(SESSION_LOG_MAX_PENDING);
+    m_writeRecords.reserve(SESSION_LOG_MAX_PENDING);
+    m_dropped = 0;
+    m_droppedTotal = 0;
+    m_keepWriting = true;
+    m_writerThread = std::thread(&SessionLog::writerThreadFunc, this);
+
+    m_isOpen = true;
+    return true;
+}
+
+void SessionLog::close() {
+    m_isOpen = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keepWriting = false;
+    }
+    m_condition.notify_one();
+
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void SessionLog::record(const LogRecord& record) {
+    if (!m_isOpen) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_activeRecords.size() >= SESSION_LOG_MAX_PENDING) {
+        // диск не успевает - не задерживаем вызывающий поток, а считаем потери
+        m_dropped++;
+        m_droppedTotal++;
+        return;
+    }
+    m_activeRecords.push_back(record);
+}
+
+void SessionLog::reportDropped(uint64_t count) {
+    if (!m_isOpen || count == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_dropped += count;
+    m_droppedTotal += count;
+}
+
+void SessionLog::writerThreadFunc() {
+    Tracer::setThreadName("sessionLog");
+    std::string chunk;
+    std::string line;
+
+    while (true) {
+        bool keepWriting;
+        uint64_t dropped;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait_for(lock, std::chrono::milliseconds(SESSION_LOG_FLUSH_INTERVAL_MS),
+                                 [this]() { return !m_keepWriting; });
+            keepWriting = m_keepWriting;
+            std::swap(m_activeRecords, m_writeRecords);
+            dropped = m_dropped;
+            m_dropped = 0;
+        }
+
+        if (m_source) {
+            LogRecord record;
+            while (m_writeRecords.size() < SESSION_LOG_MAX_PENDING && m_source->pop(record)) {
+                m_writeRecords.push_back(record);
+            }
+            uint64_t lost = m_source->takeDroppedCount();
+            dropped += lost;
+            m_droppedTotal += lost;
+        }
+
+        if (!m_writeRecords.empty() || dropped > 0) {
+            TRACE_SCOPE_ARG("sessionLogWrite", m_writeRecords.size());
+
+            for (const LogRecord& record : m_writeRecords) {
+                line.clear();
+                appendRecord(line, record);
+
+                // строка не делится между файлами
+                if (m_fileSize + chunk.size() + line.size() > m_maxFileSize && m_fileSize + chunk.size() > 0) {
+                    writeChunk(chunk);
+                    chunk.clear();
+                    rotate();
+                }
+                chunk += line;
+            }
+            m_writeRecords.clear();
+
+            if (dropped > 0) {
+                int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                    std::chrono::system_clock::now().time_since_epoch()).count();
+                char buffer[96];
+                std::snprintf(buffer, sizeof(buffer), "{\"ts\":%lld,\"event\":\"dropped\",\"count\":%llu}\n",
+                              static_cast<long long>(nowMs), static_cast<unsigned long long>(dropped));
+                chunk += buffer;
+            }
+
+            writeChunk(chunk);
+            chunk.clear();
+            if (m_file) {
+                std::fflush(m_file);
+            }
+        }
+
+        if (!keepWriting) {
+            return;
+        }
+    }
+}
+
+void SessionLog::appendRecord(std::string& out, const LogRecord& record) {
+    const EventFormat& format = EVENT_FORMATS[static_cast<size_t>(record.event)];
+    char buffer[64];
+
+    std::snprintf(buffer, sizeof(buffer), "{\"ts\":%lld,\"dir\":\"%s\",\"event\":\"",
+                  static_cast<long long>(record.timestampMs), record.isIncoming ? "rx" : "tx");
+    out += buffer;
+    out += format.name;
+    out += '"';
+
+    for (int i = 0; i < 3; i++) {
+        if (format.args[i]) {
+            std::snprintf(buffer, sizeof(buffer), ",\"%s\":%d", format.args[i], record.args[i]);
+            out += buffer;
+        }
+    }
+
+    if (record.textLength > 0) {
+        out += ",\"text\":";
+        if (record.event == LogEvent::FrameReceived) {
+            // данные кадра - в Windows-1251
+            std::string text = EncodingConverter::windows1251ToUtf8(std::string(record.text, record.textLength));
+            appendJsonString(out, text.data(), text.size());
+        } else {
+            appendJsonString(out, record.text, record.textLength);
+        }
+    }
+    if (record.isTruncated) {
+        out += ",\"truncated\":true";
+    }
+
+    out += "}\n";
+}
+
+void SessionLog::writeChunk(const std::string& chunk) {
+    if (!m_file || chunk.empty()) {
+        return;
+    }
+    m_fileSize += std::fwrite(chunk.data(), 1, chunk.size(), m_file);
+}
+
+void SessionLog::rotate() {
+    std::fclose(m_file);
+    m_file = nullptr;
+
+    // <файл>.N-1 -> <файл>.N, ..., <файл> -> <файл>.1; самый старый перезаписывается
+    for (int i = m_maxFiles - 1; i >= 1; i--) {
+        std::string from = i == 1 ? m_fileName : m_fileName + "." + std::to_string(i - 1);
+        std::string to = m_fileName + "." + std::to_string(i);
+        std::remove(to.c_str());
+        std::rename(from.c_str(), to.c_str());
+    }
+
+    m_file = std::fopen(m_fileName.c_str(), m_maxFiles > 1 ? "ab" : "wb");
+    m_fileSize = 0;
+    if (!m_file) {
+        std::cerr << "Ошибка открытия журнала сеанса " << m_fileName << std::endl;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LogQueue.h"
+
+#define SESSION_LOG_FLUSH_INTERVAL_MS 100
+#define SESSION_LOG_MAX_PENDING 16384              // записей в памяти; дальше - отбрасываются
+#define SESSION_LOG_MAX_FILE_SIZE (16 * 1024 * 1024)
+#define SESSION_LOG_MAX_FILES 5                    // текущий файл и файлы .1 ... .4
+
+// Журнал сеанса в файле: записи LogQueue (события кадров, исправление ошибок, попытки CSMA/CD)
+// в виде JSON по одной на строку. Вызывающий поток только копирует запись в буфер;
+// форматирование и запись в файл - в фоновом потоке, одним вызовом записи на пачку.
+// Память ограничена: при переполнении записи отбрасываются и считаются, а в файл
+// пишется строка {"event":"dropped",...}. Когда файл дорастает до maxFileSize,
+// он переименовывается в <файл>.1 (старые сдвигаются, самый старый удаляется).
+// Записи передаются через record() потребителем LogQueue (LogSink в GUI)
+// или забираются из очереди самим журналом (setSource).
+class SessionLog {
+public:
+    SessionLog() = default;
+    ~SessionLog();
+
+    SessionLog(const SessionLog&) = delete;
+    SessionLog& operator=(const SessionLog&) = delete;
+
+    bool open(const std::string& fileName, size_t maxFileSize = SESSION_LOG_MAX_FILE_SIZE,
+              int maxFiles = SESSION_LOG_MAX_FILES);
+    void close();
+    bool isOpen() const { return m_isOpen; }
+
+    void record(const LogRecord& record);
+
+    // записи, потерянные раньше (в переполненной LogQueue), отмечаются в файле так же
+    void reportDropped(uint64_t count);
+
+    // журнал сам забирает записи из очереди в фоновом потоке, если он - её единственный
+    // потребитель (без GUI); задаётся до open
+    void setSource(LogQueue* queue) { m_source = queue; }
+
+    uint64_t getDroppedCount() const { return m_droppedTotal; }
+
+private:
+    void writerThreadFunc();
+    void appendRecord(std::string& out, const LogRecord& record);
+    void writeChunk(const std::string& chunk);
+    void rotate();
+
+    LogQueue* m_source = nullptr;
+    std::string m_fileName;
+    size_t m_maxFileSize = SESSION_LOG_MAX_FILE_SIZE;
+    int m_maxFiles = SESSION_LOG_MAX_FILES;
+    std::FILE* m_file = nullptr;   // только фоновый поток (и open/close)
+    size_t m_fileSize = 0;
+    std::atomic<bool> m_isOpen{false};
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<LogRecord> m_activeRecords;
+    std::vector<LogRecord> m_writeRecords;
+    uint64_t m_dropped = 0;        // ещё не отмеченные в файле (под m_mutex)
+    bool m_keepWriting = false;
+    std::thread m_writerThread;
+
+    std::atomic<uint64_t> m_droppedTotal{0};
+};
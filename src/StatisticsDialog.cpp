@@ -0,0 +1,222 @@
+#include "StatisticsDialog.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QVBoxLayout>
+
+StatisticsDialog::StatisticsDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setupUI();
+    setWindowTitle("Статистика конвейера");
+    resize(760, 560);
+    setModal(false);
+
+    connect(&m_refreshTimer, &QTimer::timeout, this, &StatisticsDialog::onRefresh);
+    m_refreshTimer.start(STATISTICS_REFRESH_INTERVAL_MS);
+}
+
+void StatisticsDialog::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    m_portComboBox = new QComboBox(this);
+    m_portComboBox->addItem("Все порты");
+    connect(m_portComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &StatisticsDialog::onRefresh);
+
+    QHBoxLayout *portLayout = new QHBoxLayout();
+    portLayout->addWidget(new QLabel("Порт:"));
+    portLayout->addWidget(m_portComboBox);
+    portLayout->addStretch();
+
+    m_stageTable = new QTableWidget(METRIC_STAGE_COUNT, 7, this);
+    m_stageTable->setHorizontalHeaderLabels({"Этап", "Замеров", "Среднее, мкс", "p50, мкс",
+                                             "p90, мкс", "p99, мкс", "Макс., мкс"});
+    m_stageTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_stageTable->verticalHeader()->setVisible(false);
+    m_stageTable->horizontalHeader()->setStretchLastSection(true);
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        m_stageTable->setItem(static_cast<int>(i), 0, new QTableWidgetItem(stageTitle(static_cast<MetricStage>(i))));
+        for (int column = 1; column < 7; column++) {
+            QTableWidgetItem *item = new QTableWidgetItem();
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            m_stageTable->setItem(static_cast<int>(i), column, item);
+        }
+    }
+
+    m_counterTable = new QTableWidget(METRIC_COUNTER_COUNT, 2, this);
+    m_counterTable->setHorizontalHeaderLabels({"Счётчик", "Значение"});
+    m_counterTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_counterTable->verticalHeader()->setVisible(false);
+    m_counterTable->horizontalHeader()->setStretchLastSection(true);
+    for (size_t i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        m_counterTable->setItem(static_cast<int>(i), 0, new QTableWidgetItem(counterTitle(static_cast<MetricCounter>(i))));
+        QTableWidgetItem *item = new QTableWidgetItem();
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        m_counterTable->setItem(static_cast<int>(i), 1, item);
+    }
+
+    m_resetButton = new QPushButton("Сбросить", this);
+    m_saveButton = new QPushButton("Сохранить в JSON...", this);
+    connect(m_resetButton, &QPushButton::clicked, this, &StatisticsDialog::onReset);
+    connect(m_saveButton, &QPushButton::clicked, this, &StatisticsDialog::onSaveJson);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(m_resetButton);
+    buttonLayout->addWidget(m_saveButton);
+    buttonLayout->addStretch();
+
+    mainLayout->addLayout(portLayout);
+    mainLayout->addWidget(new QLabel("Задержки этапов:"));
+    mainLayout->addWidget(m_stageTable);
+    mainLayout->addWidget(new QLabel("Счётчики:"));
+    mainLayout->addWidget(m_counterTable);
+    mainLayout->addLayout(buttonLayout);
+}
+
+void StatisticsDialog::onRefresh()
+{
+    if (!isVisible()) {
+        return;
+    }
+
+    std::vector<PortMetricsSnapshot> ports = MetricsRegistry::getInstance().snapshot();
+
+    // новые порты добавляются в список, выбранный пункт не сбрасывается
+    for (const auto& port : ports) {
+        QString name = QString::fromStdString(port.name);
+        if (m_portComboBox->findText(name) < 0) {
+            m_portComboBox->addItem(name);
+        }
+    }
+
+    PortMetricsSnapshot selected;
+    if (m_portComboBox->currentIndex() <= 0) {
+        selected = MetricsRegistry::total(ports);
+    } else {
+        std::string name = m_portComboBox->currentText().toStdString();
+        for (const auto& port : ports) {
+            if (port.name == name) {
+                selected = port;
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < METRIC_STAGE_COUNT; i++) {
+        const HistogramSnapshot& histogram = selected.latencies[i];
+        int row = static_cast<int>(i);
+        bool empty = histogram.count == 0;
+
+        m_stageTable->item(row, 1)->setText(QString::number(histogram.count));
+        m_stageTable->item(row, 2)->setText(empty ? "-" : formatMicroseconds(histogram.meanNs()));
+        m_stageTable->item(row, 3)->setText(empty ? "-" : formatMicroseconds(histogram.percentileNs(50)));
+        m_stageTable->item(row, 4)->setText(empty ? "-" : formatMicroseconds(histogram.percentileNs(90)));
+        m_stageTable->item(row, 5)->setText(empty ? "-" : formatMicroseconds(histogram.percentileNs(99)));
+        m_stageTable->item(row, 6)->setText(empty ? "-" : formatMicroseconds(histogram.maxNs));
+    }
+
+    for (size_t i = 0; i < METRIC_COUNTER_COUNT; i++) {
+        m_counterTable->item(static_cast<int>(i), 1)->setText(QString::number(selected.counters[i]));
+    }
+}
+
+void StatisticsDialog::onReset()
+{
+    MetricsRegistry::getInstance().reset();
+    onRefresh();
+}
+
+void StatisticsDialog::onSaveJson()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Сохранить статистику", "statistics.json",
+                                                    "JSON (*.json)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "Ошибка", "Не удалось открыть файл " + fileName);
+        return;
+    }
+
+    std::string json = MetricsRegistry::getInstance().toJson();
+    file.write(json.data(), static_cast<qint64>(json.size()));
+}
+
+QString StatisticsDialog::formatMicroseconds(double valueNs)
+{
+    return QString::number(valueNs / 1000.0, 'f', 1);
+}
+
+QString StatisticsDialog::stageTitle(MetricStage stage)
+{
+    switch (stage) {
+    case MetricStage::Compress:
+        return "Сжатие";
+    case MetricStage::Pack:
+        return "Кодирование кадра";
+    case MetricStage::Stuff:
+        return "Байт-стаффинг";
+    case MetricStage::Write:
+        return "Запись в порт";
+    case MetricStage::Backoff:
+        return "Ожидание CSMA/CD";
+    case MetricStage::Deframe:
+        return "Выделение кадров";
+    case MetricStage::Unstuff:
+        return "Снятие стаффинга";
+    case MetricStage::Correct:
+        return "Исправление ошибок";
+    case MetricStage::Transcode:
+        return "Перекодировка";
+    case MetricStage::Decompress:
+        return "Распаковка";
+    case MetricStage::TimerLateness:
+        return "Опоздание таймера";
+    default:
+        return QString();
+    }
+}
+
+QString StatisticsDialog::counterTitle(MetricCounter counter)
+{
+    switch (counter) {
+    case MetricCounter::BytesSent:
+        return "Передано байт";
+    case MetricCounter::BytesReceived:
+        return "Принято байт";
+    case MetricCounter::FramesSent:
+        return "Передано кадров";
+    case MetricCounter::FramesReceived:
+        return "Принято кадров";
+    case MetricCounter::FramesFailed:
+        return "Кадров не передано";
+    case MetricCounter::FramesCorrected:
+        return "Исправлено кадров";
+    case MetricCounter::DoubleErrors:
+        return "Двойных ошибок";
+    case MetricCounter::MessagesSent:
+        return "Передано сообщений";
+    case MetricCounter::MessagesReceived:
+        return "Принято сообщений";
+    case MetricCounter::CompressedBytesIn:
+        return "Байт до сжатия";
+    case MetricCounter::CompressedBytesOut:
+        return "Байт после сжатия";
+    case MetricCounter::DecompressErrors:
+        return "Ошибок распаковки";
+    case MetricCounter::Collisions:
+        return "Коллизий";
+    case MetricCounter::JamSent:
+        return "Отправлено jam-сигналов";
+    case MetricCounter::JamDetected:
+        return "Принято jam-сигналов";
+    default:
+        return QString();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QDialog>
+#include <QComboBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+
+#include "Metrics.h"
+
+#define STATISTICS_REFRESH_INTERVAL_MS 500
+
+// Живой просмотр MetricsRegistry: счётчики и задержки этапов по портам
+class StatisticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit StatisticsDialog(QWidget *parent = nullptr);
+
+private slots:
+    void onRefresh();
+    void onReset();
+    void onSaveJson();
+
+private:
+    void setupUI();
+    static QString stageTitle(MetricStage stage);
+    static QString counterTitle(MetricCounter counter);
+    static QString formatMicroseconds(double valueNs);
+
+    QComboBox *m_portComboBox;
+    QTableWidget *m_stageTable;
+    QTableWidget *m_counterTable;
+    QPushButton *m_resetButton;
+    QPushButton *m_saveButton;
+    QTimer m_refreshTimer;
+};
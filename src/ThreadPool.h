@@ -0,0 +1,30 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул рабочих потоков с общей очередью задач.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0); // 0 - по числу ядер
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    size_t size() const { return m_workers.size(); }
+
+private:
+    void workerFunc();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
@@ -0,0 +1,119 @@
+#include "Tracer.h"
+#include <algorithm>
+#include <cstdio>
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+static thread_local const char* t_threadName = nullptr;
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::start() {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    m_buffers.clear();
+    m_dropped = 0;
+    m_originNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    // потоки с буферами от прошлой трассировки заведут новые
+    m_generation++;
+    s_enabled = true;
+}
+
+void Tracer::stop() {
+    s_enabled = false;
+}
+
+void Tracer::setThreadName(const char* name) {
+    t_threadName = name;
+}
+
+Tracer::ThreadBuffer* Tracer::currentBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+    thread_local uint64_t t_generation = 0;
+
+    uint64_t generation = m_generation.load(std::memory_order_acquire);
+    if (t_buffer && t_generation == generation) {
+        return t_buffer.get();
+    }
+
+    auto buffer = std::make_shared<ThreadBuffer>();
+    buffer->threadName = t_threadName;
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        buffer->threadId = m_nextThreadId++;
+        m_buffers.push_back(buffer);
+    }
+
+    t_buffer = buffer;
+    t_generation = generation;
+    return buffer.get();
+}
+
+void Tracer::record(const char* name, char phase, int64_t beginNs, int64_t durationNs, int64_t arg) {
+    ThreadBuffer* buffer = currentBuffer();
+
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->events.size() >= TRACE_MAX_EVENTS_PER_THREAD) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events.push_back(TraceEvent{name, phase, beginNs, durationNs, arg});
+}
+
+size_t Tracer::getEventCount() {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    size_t count = 0;
+    for (const auto& buffer : m_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+bool Tracer::writeJson(const std::string& fileName) {
+    std::FILE* file = std::fopen(fileName.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        buffers = m_buffers;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+    bool first = true;
+
+    for (const auto& buffer : buffers) {
+        std::vector<TraceEvent> events;
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            events = buffer->events;
+        }
+
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", buffer->threadId, buffer->threadName ? buffer->threadName : "thread");
+        first = false;
+
+        for (const TraceEvent& event : events) {
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f",
+                         event.name, event.phase, buffer->threadId, event.beginNs / 1000.0);
+            if (event.phase == 'X') {
+                std::fprintf(file, ",\"dur\":%.3f", event.durationNs / 1000.0);
+            } else {
+                std::fputs(",\"s\":\"t\"", file);
+            }
+            if (event.arg != TRACE_NO_ARG) {
+                std::fprintf(file, ",\"args\":{\"value\":%lld}", static_cast<long long>(event.arg));
+            }
+            std::fputc('}', file);
+        }
+    }
+
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define TRACE_MAX_EVENTS_PER_THREAD (1 << 20)
+#define TRACE_NO_ARG INT64_MIN
+
+struct TraceEvent {
+    const char* name;       // только строковые литералы: сохраняется указатель
+    char phase;             // 'X' - интервал, 'i' - мгновенное событие
+    int64_t beginNs;
+    int64_t durationNs;
+    int64_t arg;            // номер кадра, идентификатор сообщения и т.п.
+};
+
+// Трассировка по требованию: события пишутся в буфер своего потока и выгружаются
+// в JSON формата Chrome trace-event (chrome://tracing, ui.perfetto.dev).
+// Пока трассировка выключена, TRACE_SCOPE стоит одну relaxed-загрузку флага.
+class Tracer {
+public:
+    static Tracer& getInstance();
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // start очищает ранее собранные события
+    void start();
+    void stop();
+
+    // имя текущего потока в трассе; строковый литерал
+    static void setThreadName(const char* name);
+
+    void record(const char* name, char phase, int64_t beginNs, int64_t durationNs, int64_t arg);
+    int64_t nowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count() - m_originNs.load(std::memory_order_relaxed);
+    }
+
+    bool writeJson(const std::string& fileName);
+    size_t getEventCount();
+    uint64_t getDroppedCount() const { return m_dropped; }
+
+private:
+    struct ThreadBuffer {
+        uint32_t threadId;
+        const char* threadName;
+        std::mutex mutex; // захватывает только владелец и выгрузка, поэтому почти всегда свободен
+        std::vector<TraceEvent> events;
+    };
+
+    Tracer() = default;
+    ThreadBuffer* currentBuffer();
+
+    static std::atomic<bool> s_enabled;
+
+    std::atomic<int64_t> m_originNs{0};
+    std::atomic<uint64_t> m_generation{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::mutex m_buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers; // буферы переживают свои потоки
+    uint32_t m_nextThreadId = 1;
+};
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, int64_t arg = TRACE_NO_ARG)
+        : m_name(Tracer::isEnabled() ? name : nullptr)
+        , m_arg(arg) {
+        if (m_name) {
+            m_begin = Tracer::getInstance().nowNs();
+        }
+    }
+
+    ~TraceScope() {
+        if (m_name) {
+            Tracer& tracer = Tracer::getInstance();
+            tracer.record(m_name, 'X', m_begin, tracer.nowNs() - m_begin, m_arg);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    int64_t m_arg;
+    int64_t m_begin = 0;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, arg) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, static_cast<int64_t>(arg))
+#define TRACE_INSTANT(name, arg)                                                            \
+    do {                                                                                    \
+        if (Tracer::isEnabled()) {                                                          \
+            Tracer& tracer = Tracer::getInstance();                                         \
+            tracer.record(name, 'i', tracer.nowNs(), 0, static_cast<int64_t>(arg));         \
+        }                                                                                   \
+    } while (0)
@@ -0,0 +1,600 @@
+#include "TransmitWorker.h"
+#include "ChannelManager.h"
+#include "Tracer.h"
+#include <algorithm>
+
+TransmitWorker::TransmitWorker(SerialPort& port, ThreadPool& pool, LogQueue* log, size_t queueCapacity)
+    : m_port(port)
+    , m_pool(pool)
+    , m_log(log) {
+    for (Channel& channel : m_channels) {
+        channel.config.queueLimit = queueCapacity;
+    }
+}
+
+TransmitWorker::~TransmitWorker() {
+    stop();
+}
+
+void TransmitWorker::start(const FrameSentCallback& frameSent, const MessageCompletedCallback& messageCompleted) {
+    stop();
+
+    m_frameSentCallback = frameSent;
+    m_messageCompletedCallback = messageCompleted;
+    // метрики читают и поток передачи, и задачи кодирования в пуле, поэтому указатель
+    // берётся до их запуска и дальше не меняется; порт к этому моменту уже открыт
+    m_metrics = m_port.getMetrics();
+    m_timer.setMetrics(m_metrics);
+    m_keepRunning = true;
+    m_thread = std::thread(&TransmitWorker::workerFunc, this);
+}
+
+// поток передачи дописывает текущую запись в порт, а оставшиеся сообщения сообщает
+// как не переданные (abandonMessages)
+void TransmitWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_keepRunning = false;
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+uint64_t TransmitWorker::submit(const std::string& message, MessagePriority priority, uint8_t channel) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_keepRunning || channel >= FRAME_CHANNEL_COUNT || !hasSpace(channel)) {
+        return 0;
+    }
+    return enqueue(message, priority, channel);
+}
+
+uint64_t TransmitWorker::submit(const std::string& message, MessagePriority priority, std::chrono::milliseconds timeout,
+                                uint8_t channel) {
+    if (channel >= FRAME_CHANNEL_COUNT) {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool space = m_notFull.wait_for(lock, timeout, [this, channel]() {
+        return !m_keepRunning || hasSpace(channel);
+    });
+
+    if (!space || !m_keepRunning) {
+        return 0;
+    }
+    return enqueue(message, priority, channel);
+}
+
+uint64_t TransmitWorker::submitBatch(std::shared_ptr<const FrameBatch> batch, MessagePriority priority) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_keepRunning || !batch || batch->channel >= FRAME_CHANNEL_COUNT || !hasSpace(batch->channel)) {
+        return 0;
+    }
+    uint8_t channel = batch->channel;
+    return enqueue(std::string(), priority, channel, std::move(batch));
+}
+
+void TransmitWorker::configureChannel(uint8_t channel, const ChannelConfig& config) {
+    if (channel >= FRAME_CHANNEL_COUNT) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ChannelConfig& target = m_channels[channel].config;
+    target = config;
+    target.weight = std::max(1, config.weight);
+    target.queueLimit = std::max<size_t>(1, config.queueLimit);
+    m_interleaving = m_interleaving || channel != 0;
+}
+
+// вызывается под m_mutex; очереди каналов ограничены порознь, чтобы основной поток не занял место срочных
+bool TransmitWorker::hasSpace(uint8_t channel) const {
+    return m_channels[channel].queue.size() < m_channels[channel].config.queueLimit;
+}
+
+uint64_t TransmitWorker::enqueue(const std::string& message, MessagePriority priority, uint8_t channel,
+                                 std::shared_ptr<const FrameBatch> batch) {
+    uint64_t id = m_nextId++;
+    m_channels[channel].queue.push(QueuedMessage{id, priority, message, std::move(batch)});
+    m_queued++;
+    // пока все сообщения идут в канале 0, пакеты пишутся крупными группами
+    m_interleaving = m_interleaving || channel != 0;
+    m_notEmpty.notify_one();
+    return id;
+}
+
+size_t TransmitWorker::queuedCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queued;
+}
+
+size_t TransmitWorker::queuedCount(uint8_t channel) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return channel < FRAME_CHANNEL_COUNT ? m_channels[channel].queue.size() : 0;
+}
+
+// Вызывается под m_mutex, когда хотя бы в одном канале есть сообщение.
+// Каналы с наибольшим приоритетом обслуживаются по кругу: придя к каналу, перебор
+// добавляет ему weight * TX_CHANNEL_QUANTUM_BYTES и остаётся на нём, пока этот запас
+// не израсходован записями в порт. Простаивающий канал запас не копит.
+TransmitWorker::Channel* TransmitWorker::pickChannel() {
+    MessagePriority top = MessagePriority::Low;
+    for (Channel& channel : m_channels) {
+        if (channel.active || !channel.queue.empty()) {
+            top = std::max(top, channel.config.priority);
+        } else {
+            channel.deficit = 0;
+        }
+    }
+
+    while (true) {
+        Channel& channel = m_channels[m_current];
+        if ((channel.active || !channel.queue.empty()) && channel.config.priority == top) {
+            if (!m_quantumGiven) {
+                channel.deficit += channel.config.weight * TX_CHANNEL_QUANTUM_BYTES;
+                m_quantumGiven = true;
+            }
+            if (channel.deficit > 0) {
+                return &channel;
+            }
+        }
+        m_current = (m_current + 1) % m_channels.size();
+        m_quantumGiven = false;
+    }
+}
+
+void TransmitWorker::workerFunc() {
+    Tracer::setThreadName("transmit");
+
+    while (true) {
+        Channel* channel;
+        uint8_t channelId;
+        bool started = false;
+        size_t groupBytes;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this]() { return !m_keepRunning || m_queued > 0 || m_active > 0; });
+
+            if (!m_keepRunning) {
+                lock.unlock();
+                abandonMessages();
+                return;
+            }
+
+            channel = pickChannel();
+            channelId = static_cast<uint8_t>(channel - m_channels.data());
+            if (!channel->active) {
+                channel->message = channel->queue.top();
+                channel->queue.pop();
+                channel->active = true;
+                m_queued--;
+                m_active++;
+                started = true;
+            }
+            groupBytes = m_interleaving ? TX_INTERLEAVE_WRITE_BYTES : TX_BATCH_WRITE_BYTES;
+        }
+
+        size_t written = 0;
+        bool done;
+        bool success = false;
+
+        if (started) {
+            m_notFull.notify_all();
+        }
+
+        if (started && !beginMessage(*channel, channelId)) {
+            done = true;
+        } else {
+            if (channel->next < channel->total) {
+                written = channel->message.batch ? transmitNextGroup(*channel, groupBytes) : transmitNextFrame(*channel);
+            }
+            done = channel->next >= channel->total;
+            if (done) {
+                success = channel->message.batch ? finishBatch(*channel) : finishMessage(*channel);
+            }
+        }
+
+        uint64_t messageId = channel->message.id;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            channel->deficit -= static_cast<int>(written);
+            if (done) {
+                channel->active = false;
+                channel->message = QueuedMessage{};
+                m_active--;
+            }
+        }
+
+        if (done && m_messageCompletedCallback) {
+            m_messageCompletedCallback(messageId, success);
+        }
+    }
+}
+
+bool TransmitWorker::beginMessage(Channel& channel, uint8_t channelId) {
+    const QueuedMessage& message = channel.message;
+    channel.next = 0;
+    channel.allSent = true;
+
+    if (message.batch) {
+        TRACE_SCOPE_ARG("beginBatch", message.batch->frames.size());
+        channel.total = static_cast<int>(message.batch->frames.size());
+        channel.frameSent.assign(message.batch->frames.size(), 0);
+        return true;
+    }
+
+    TRACE_SCOPE_ARG("beginMessage", message.id);
+
+    std::string& encodedMessage = channel.encodedMessage;
+    bool encoded;
+    {
+        TRACE_SCOPE("encodeMessage");
+        ScopedLatency latency(m_metrics, MetricStage::Pack);
+        encoded = m_frameManager.encodeMessage(message.text, encodedMessage);
+    }
+    if (!encoded || encodedMessage.empty()) {
+        return false;
+    }
+
+    uint8_t flags = static_cast<uint8_t>(channelId << FRAME_FLAG_CHANNEL_SHIFT);
+    if (m_compressionEnabled) {
+        TRACE_SCOPE_ARG("compress", encodedMessage.size());
+        ScopedLatency latency(m_metrics, MetricStage::Compress);
+
+        size_t originalSize = encodedMessage.size();
+        if (FrameManager::compressMessage(encodedMessage)) {
+            flags |= FRAME_FLAG_COMPRESSED;
+
+            if (m_metrics) {
+                m_metrics->add(MetricCounter::CompressedBytesIn, originalSize);
+                m_metrics->add(MetricCounter::CompressedBytesOut, encodedMessage.size());
+            }
+            if (m_log) {
+                m_log->push(LogEvent::MessageCompressed, false, static_cast<int32_t>(originalSize),
+                            static_cast<int32_t>(encodedMessage.size()));
+            }
+        }
+    }
+
+    // метки считаются в каждом канале отдельно: канал входит в байт флагов
+    const int total = FrameManager::getFrameCount(encodedMessage.size());
+    if (total > FRAME_MAX_COUNT) {
+        // число и номер кадра в заголовке - по байту: такое сообщение ушло бы с повторяющимися номерами
+        // и собралось бы на приёме в мусор, поэтому оно не передаётся и сообщается как не переданное
+        if (m_log) {
+            m_log->push(LogEvent::MessageTooLong, false, static_cast<int32_t>(message.id), total);
+        }
+        return false;
+    }
+
+    flags |= static_cast<uint8_t>((channel.nextTag++ << FRAME_FLAG_TAG_SHIFT) & FRAME_FLAG_TAG_MASK);
+    channel.flags = flags;
+    channel.total = total;
+
+    if (m_log) {
+        m_log->push(LogEvent::MessageSegmented, false, message.text.data(), message.text.size(), total);
+    }
+
+    // Кадр N передаётся, пока кадр N+1 (а для больших сообщений - несколько следующих)
+    // кодируется в пуле в отдельный буфер.
+    size_t depth = total >= TX_PARALLEL_ENCODE_THRESHOLD ? m_pool.size() + 1 : 2;
+    depth = std::min(depth, static_cast<size_t>(total));
+    if (channel.slots.size() < depth) {
+        channel.slots.resize(depth);
+    }
+    channel.depth = depth;
+
+    for (size_t i = 0; i < depth; i++) {
+        scheduleEncode(channel.slots[i], encodedMessage, static_cast<int>(i), total, flags);
+    }
+    return true;
+}
+
+size_t TransmitWorker::transmitNextFrame(Channel& channel) {
+    const int i = channel.next++;
+    TRACE_SCOPE_ARG("transmitFrame", i + 1);
+
+    EncodeSlot& slot = channel.slots[i % channel.depth];
+    {
+        TRACE_SCOPE_ARG("waitEncode", i + 1);
+        slot.ready.wait();
+    }
+
+    bool emulationEnabled = m_emulationEnabled;
+    bool success;
+
+    if (emulationEnabled) {
+        success = transmitWithCSMACD(slot.stuffedFrame.data(), slot.stuffedFrame.size());
+    } else {
+        success = m_port.writeData(slot.stuffedFrame);
+    }
+    const size_t written = slot.stuffedFrame.size();
+
+    if (m_metrics) {
+        m_metrics->add(success ? MetricCounter::FramesSent : MetricCounter::FramesFailed);
+    }
+
+    if (success) {
+        if (m_frameSentCallback) {
+            m_frameSentCallback(TransmitReport{channel.message.id, i + 1, channel.total,
+                                               slot.frame.getFcs().size(),
+                                               m_frameManager.getStuffedFcsSize(slot.frame.getFcs()),
+                                               slot.stuffedFrame});
+        }
+
+        if (m_log) {
+            m_log->push(LogEvent::FrameTransmitted, false, i + 1);
+        }
+    } else {
+        channel.allSent = false;
+        if (m_log) {
+            m_log->push(LogEvent::FrameFailed, false, i + 1, emulationEnabled ? 1 : 0);
+        }
+    }
+
+    if (i + static_cast<int>(channel.depth) < channel.total) {
+        scheduleEncode(slot, channel.encodedMessage, i + static_cast<int>(channel.depth), channel.total, channel.flags);
+    }
+    return written;
+}
+
+size_t TransmitWorker::transmitNextGroup(Channel& channel, size_t maxBytes) {
+    const FrameBatch& batch = *channel.message.batch;
+    const size_t frame = static_cast<size_t>(channel.next);
+    const FrameSpan& first = batch.frames[frame];
+
+    if (m_emulationEnabled) {
+        // с CSMA/CD каждый кадр захватывает канал отдельно
+        channel.frameSent[frame] = transmitWithCSMACD(&batch.arena[first.offset], first.length);
+        channel.next++;
+        return first.length;
+    }
+
+    TRACE_SCOPE_ARG("batchWrite", frame + 1);
+
+    // кадры лежат вплотную, поэтому группа кадров - один непрерывный участок буфера
+    size_t end = frame + 1;
+    size_t length = first.length;
+    while (end < batch.frames.size() && length + batch.frames[end].length <= maxBytes) {
+        length += batch.frames[end].length;
+        end++;
+    }
+
+    bool success = m_port.writeData(&batch.arena[first.offset], length);
+    std::fill(channel.frameSent.begin() + frame, channel.frameSent.begin() + end, success ? 1 : 0);
+    channel.next = static_cast<int>(end);
+    return length;
+}
+
+bool TransmitWorker::finishMessage(Channel& channel) {
+    if (m_metrics && channel.allSent) {
+        m_metrics->add(MetricCounter::MessagesSent);
+    }
+
+    if (m_log) {
+        m_log->push(LogEvent::MessageCompleted, false, static_cast<int32_t>(channel.message.id), channel.allSent ? 1 : 0);
+    }
+
+    return channel.allSent;
+}
+
+bool TransmitWorker::finishBatch(Channel& channel) {
+    const FrameBatch& batch = *channel.message.batch;
+    const std::vector<uint8_t>& frameSent = channel.frameSent;
+
+    size_t framesSent = std::count(frameSent.begin(), frameSent.end(), 1);
+    if (m_metrics) {
+        m_metrics->add(MetricCounter::FramesSent, framesSent);
+        m_metrics->add(MetricCounter::FramesFailed, batch.frames.size() - framesSent);
+    }
+
+    bool allSent = true;
+    for (size_t message = 0; message < batch.messageCount(); message++) {
+        bool messageSent = batch.encoded[message] != 0;
+        for (uint32_t f = batch.firstFrame[message]; f < batch.firstFrame[message + 1]; f++) {
+            messageSent = messageSent && frameSent[f];
+        }
+
+        if (messageSent && m_metrics) {
+            m_metrics->add(MetricCounter::MessagesSent);
+        }
+        allSent = allSent && messageSent;
+    }
+
+    if (m_log) {
+        m_log->push(LogEvent::MessageCompleted, false, static_cast<int32_t>(channel.message.id), allSent ? 1 : 0);
+    }
+
+    return allSent;
+}
+
+// при остановке начатые и ждущие в очередях сообщения бросаются; каждое сообщается
+// MessageCompletedCallback как не переданное, чтобы счётчики завершений сошлись.
+// Буферы кадров начатых сообщений ещё могут кодироваться в пуле
+void TransmitWorker::abandonMessages() {
+    std::vector<uint64_t> dropped;
+
+    for (Channel& channel : m_channels) {
+        for (EncodeSlot& slot : channel.slots) {
+            if (slot.ready.valid()) {
+                slot.ready.wait();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (channel.active) {
+            dropped.push_back(channel.message.id);
+            channel.active = false;
+            channel.message = QueuedMessage{};
+            m_active--;
+        }
+        while (!channel.queue.empty()) {
+            dropped.push_back(channel.queue.top().id);
+            channel.queue.pop();
+            m_queued--;
+        }
+        channel.deficit = 0;
+    }
+
+    std::sort(dropped.begin(), dropped.end());
+    for (uint64_t messageId : dropped) {
+        if (m_log) {
+            m_log->push(LogEvent::MessageCompleted, false, static_cast<int32_t>(messageId), 0);
+        }
+        if (m_messageCompletedCallback) {
+            m_messageCompletedCallback(messageId, false);
+        }
+    }
+}
+
+void TransmitWorker::scheduleEncode(EncodeSlot& slot, const std::string& encodedMessage, int index, int total, uint8_t flags) {
+    auto promise = std::make_shared<std::promise<void>>();
+    slot.ready = promise->get_future();
+
+    m_pool.submit([this, &slot, &encodedMessage, index, total, flags, promise]() {
+        {
+            TRACE_SCOPE_ARG("packFrame", index + 1);
+            ScopedLatency latency(m_metrics, MetricStage::Pack);
+            slot.frame = m_frameManager.packFrame(encodedMessage, index, total, flags);
+        }
+        {
+            TRACE_SCOPE_ARG("stuffFrame", index + 1);
+            ScopedLatency latency(m_metrics, MetricStage::Stuff);
+            m_frameManager.stuffFrame(slot.frame, slot.stuffedFrame);
+        }
+        promise->set_value();
+    });
+}
+
+// Основной метод передачи с CSMA/CD. Все ожидания - по абсолютным срокам DeadlineTimer,
+// длительности байта, слота и межкадрового интервала считаются от скорости порта.
+// Реакция на занятый канал и отсрочка после коллизии задаются профилем MAC.
+bool TransmitWorker::transmitWithCSMACD(const char* frameData, size_t length) {
+    ChannelManager& channel = ChannelManager::getInstance();
+    const MacProfile profile = channel.getProfile();
+    int attempt = 0;
+    const int maxAttempts = profile.maxAttempts;
+    const int baudRate = m_port.getBaudRate();
+    const auto byteDuration = ChannelManager::getByteDuration(baudRate);
+    const auto slotDuration = ChannelManager::getSlotDuration(profile, baudRate);
+
+    // межкадровый интервал нужен только эмуляции CSMA/CD: флаг начала внутри кадра
+    // всегда экранирован, поэтому приёмник разделяет кадры, идущие вплотную
+    m_timer.sleepUntil(m_channelFreeAt);
+
+    // прослушивание и отложенные слоты попыток не тратят, поэтому их число ограничено отдельно:
+    // иначе кадр на вечно занятом канале не вернул бы управление
+    int senseRounds = 0;
+
+    while (attempt < maxAttempts) {
+        TRACE_SCOPE_ARG("csmaAttempt", attempt + 1);
+
+        CarrierDecision decision = channel.senseCarrier(profile, channel.isChannelBusy());
+
+        if (decision == CarrierDecision::KeepSensing || decision == CarrierDecision::DeferSlot) {
+            if (++senseRounds > profile.maxSenseRounds) {
+                return false;
+            }
+        }
+        if (decision == CarrierDecision::KeepSensing) {
+            // канал слушается непрерывно - следующая проверка через время байта
+            TRACE_INSTANT("channelBusy", attempt + 1);
+            m_timer.sleepFor(byteDuration);
+            continue;
+        }
+        if (decision == CarrierDecision::DeferSlot) {
+            m_timer.sleepFor(slotDuration);
+            continue;
+        }
+        if (decision == CarrierDecision::RandomWait) {
+            TRACE_INSTANT("channelBusy", attempt + 1);
+            backoff(profile, attempt, false);
+            attempt++;
+            continue;
+        }
+
+        bool collisionDetected = false;
+        const size_t collisionAt = channel.rollCollision(profile, length);
+        // срок следующего байта сдвигается на время байта от начала кадра, а не от
+        // момента пробуждения, поэтому кадр занимает ровно length байтовых интервалов
+        auto byteDeadline = DeadlineTimer::Clock::now();
+
+        for (size_t i = 0; i < length; i++) {
+            if (i == collisionAt) {
+                collisionDetected = true;
+                break;
+            }
+
+            if (!m_port.writeData(&frameData[i], 1)) {
+                collisionDetected = true;
+                break;
+            }
+
+            byteDeadline += byteDuration;
+            m_timer.sleepUntil(byteDeadline);
+        }
+
+        if (collisionDetected) {
+            // Коллизия обнаружена на одном из байтов - отправляем jam-сигнал
+            sendJamSignal();
+
+            TRACE_INSTANT("collision", attempt + 1);
+            channel.incrementCollisions();
+            if (m_metrics) {
+                m_metrics->add(MetricCounter::Collisions);
+            }
+
+            backoff(profile, attempt, true);
+            attempt++;
+        } else {
+            // Успешная передача всего кадра без коллизий
+            m_channelFreeAt = DeadlineTimer::Clock::now() + ChannelManager::bitsDuration(INTER_FRAME_GAP_BITS, baudRate);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TransmitWorker::backoff(const MacProfile& profile, int attempt, bool collision) {
+    ChannelManager& channel = ChannelManager::getInstance();
+    // окно - по числу неудачных попыток, включая эту: после первой коллизии уже 2 слота
+    int backoffSlots = channel.calculateBackoffDelay(profile, attempt + 1);
+    auto delay = backoffSlots * ChannelManager::getSlotDuration(profile, m_port.getBaudRate());
+    int backoffUs = static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(delay).count());
+
+    if (m_log) {
+        if (collision) {
+            m_log->push(LogEvent::Collision, false, backoffSlots, backoffUs);
+        } else {
+            m_log->push(LogEvent::ChannelBusy, false, attempt + 1, backoffSlots, backoffUs);
+        }
+    }
+
+    m_currentBackoffUs = backoffUs;
+
+    TRACE_SCOPE_ARG("backoff", backoffUs);
+    ScopedLatency latency(m_metrics, MetricStage::Backoff);
+    m_timer.sleepFor(delay);
+}
+
+void TransmitWorker::sendJamSignal() {
+    TRACE_SCOPE("jam");
+
+    // 32 бита jam-сигнала (4 байта)
+    std::string jamSignal(JAM_SIGNAL_SIZE / 8, static_cast<char>(JAM_SIGNAL_BYTE));
+
+    m_port.writeData(jamSignal);
+
+    if (m_metrics) {
+        m_metrics->add(MetricCounter::JamSent);
+    }
+
+    if (m_log) {
+        m_log->push(LogEvent::JamSent, false);
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SerialPort.h"
+#include "ChannelManager.h"
+#include "DeadlineTimer.h"
+#include "FrameBatch.h"
+#include "FrameManager.h"
+#include "LogQueue.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+
+#define TX_QUEUE_CAPACITY 64
+#define TX_PARALLEL_ENCODE_THRESHOLD 16 // с этого числа кадров кодирование идёт на всех потоках пула
+#define TX_BATCH_WRITE_BYTES 4096 // кадры пакета пишутся в порт группами не больше этого размера
+#define TX_INTERLEAVE_WRITE_BYTES 512 // то же, когда используется больше одного канала
+#define TX_CHANNEL_QUANTUM_BYTES 256 // байтов за круг взвешенного перебора каналов на единицу веса
+
+enum class MessagePriority : uint8_t {
+    Low,
+    Normal,
+    High
+};
+
+// Логический канал передатчика. Из каналов с сообщениями всегда обслуживаются каналы
+// с наибольшим priority (строгий приоритет), между ними линия делится по weight
+// (дефицитный циклический перебор по байтам). Внутри канала сообщения идут по приоритету
+// сообщения, затем по порядку поступления.
+struct ChannelConfig {
+    MessagePriority priority = MessagePriority::Normal;
+    int weight = 1;
+    size_t queueLimit = TX_QUEUE_CAPACITY;  // сообщений в очереди канала; по умолчанию - queueCapacity передатчика
+};
+
+struct TransmitReport {
+    uint64_t messageId;
+    int current;
+    int total;
+    size_t fcsSize;
+    size_t stuffedFcsSize;
+    std::string stuffedFrame;
+};
+
+// Долгоживущий поток передачи: владеет записью в порт и берёт сообщения из
+// ограниченных очередей логических каналов. Сообщения разных каналов передаются
+// вперемежку по кадрам (пакеты - группами кадров), поэтому срочное сообщение ждёт
+// не конца большого сообщения другого канала, а только конца текущей записи в порт.
+// Завершение каждого сообщения сообщается асинхронно.
+class TransmitWorker {
+public:
+    using FrameSentCallback = std::function<void(const TransmitReport& report)>;
+    using MessageCompletedCallback = std::function<void(uint64_t messageId, bool success)>;
+
+    TransmitWorker(SerialPort& port, ThreadPool& pool, LogQueue* log = nullptr, size_t queueCapacity = TX_QUEUE_CAPACITY);
+    ~TransmitWorker();
+
+    // порт должен быть уже открыт: его метрики берутся здесь
+    void start(const FrameSentCallback& frameSent, const MessageCompletedCallback& messageCompleted);
+    void stop();
+
+    // возвращает идентификатор сообщения или 0, если очередь канала заполнена. Сообщение, которое
+    // после перекодировки (и сжатия) занимает больше FRAME_MAX_COUNT кадров, не передаётся:
+    // MessageCompletedCallback сообщает о нём с success = false
+    uint64_t submit(const std::string& message, MessagePriority priority = MessagePriority::Normal, uint8_t channel = 0);
+    uint64_t submit(const std::string& message, MessagePriority priority, std::chrono::milliseconds timeout,
+                    uint8_t channel = 0);
+
+    // готовый пакет кадров (BatchEncoder) передаётся из общего буфера без копирования, в канале batch->channel;
+    // FrameSentCallback для кадров пакета не вызывается, MessageCompletedCallback - один раз на пакет
+    uint64_t submitBatch(std::shared_ptr<const FrameBatch> batch, MessagePriority priority = MessagePriority::Normal);
+
+    // приоритет, вес и лимит очереди канала 0..FRAME_CHANNEL_COUNT-1
+    void configureChannel(uint8_t channel, const ChannelConfig& config);
+
+    size_t queuedCount();
+    size_t queuedCount(uint8_t channel);
+
+    void setEmulationEnabled(bool enabled) { m_emulationEnabled = enabled; }
+    void setCompressionEnabled(bool enabled) { m_compressionEnabled = enabled; }
+
+    // выделение кадров на линии; задаётся до start, как у приёмника на другом конце
+    void setFramingMode(FramingMode framing) { m_frameManager.setFramingMode(framing); }
+
+    // задержка последнего ожидания CSMA/CD в мкс
+    int getCurrentBackoffUs() const { return m_currentBackoffUs; }
+
+private:
+    struct QueuedMessage {
+        uint64_t id;
+        MessagePriority priority;
+        std::string text;
+        std::shared_ptr<const FrameBatch> batch;
+
+        bool operator<(const QueuedMessage& other) const {
+            if (priority != other.priority) {
+                return priority < other.priority;
+            }
+            return id > other.id; // при равном приоритете - по порядку поступления
+        }
+    };
+
+    // буфер для кадра, который кодируется, пока передаётся предыдущий
+    struct EncodeSlot {
+        Frame frame;
+        std::string stuffedFrame;
+        std::future<void> ready;
+    };
+
+    struct Channel {
+        ChannelConfig config;
+        std::priority_queue<QueuedMessage> queue;   // под m_mutex
+
+        // передаваемое сообщение (только поток передачи; active и deficit - под m_mutex)
+        bool active = false;
+        QueuedMessage message;
+        std::string encodedMessage;
+        uint8_t flags = 0;
+        int total = 0;
+        int next = 0;           // следующий кадр
+        size_t depth = 0;       // кадров, кодируемых заранее
+        bool allSent = true;
+        std::vector<EncodeSlot> slots;
+        std::vector<uint8_t> frameSent;     // кадры пакета
+        int deficit = 0;        // байтов, которые канал ещё может передать в этом круге
+        uint8_t nextTag = 0;    // метка следующего сообщения канала
+    };
+
+    uint64_t enqueue(const std::string& message, MessagePriority priority, uint8_t channel,
+                     std::shared_ptr<const FrameBatch> batch = nullptr);
+    bool hasSpace(uint8_t channel) const;
+    Channel* pickChannel();
+    void scheduleEncode(EncodeSlot& slot, const std::string& encodedMessage, int index, int total, uint8_t flags);
+    void workerFunc();
+    bool beginMessage(Channel& channel, uint8_t channelId);
+    size_t transmitNextFrame(Channel& channel);
+    size_t transmitNextGroup(Channel& channel, size_t maxBytes);
+    bool finishMessage(Channel& channel);
+    bool finishBatch(Channel& channel);
+    void abandonMessages();
+
+    // CSMA/CD методы
+    bool transmitWithCSMACD(const char* frameData, size_t length);
+    void backoff(const MacProfile& profile, int attempt, bool collision);
+    void sendJamSignal();
+
+    SerialPort& m_port;
+    ThreadPool& m_pool;
+    LogQueue* m_log;
+    FrameManager m_frameManager;
+
+    std::array<Channel, FRAME_CHANNEL_COUNT> m_channels;
+    size_t m_queued = 0;        // сообщений во всех очередях каналов
+    size_t m_active = 0;        // каналов с начатым сообщением
+    size_t m_current = 0;       // канал, на котором остановился перебор
+    bool m_quantumGiven = false; // m_current уже получил свою долю в этом круге
+    bool m_interleaving = false; // используется (или настроен) канал, кроме 0
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    uint64_t m_nextId = 1;
+    bool m_keepRunning = false;
+
+    std::thread m_thread;
+    std::atomic<bool> m_emulationEnabled{false};
+    std::atomic<bool> m_compressionEnabled{false};
+    std::atomic<int> m_currentBackoffUs{0};
+
+    // времена CSMA/CD отсчитываются от скорости порта (только поток передачи)
+    DeadlineTimer m_timer;
+    DeadlineTimer::Clock::time_point m_channelFreeAt;  // раньше этого момента (конец кадра + интервал) канал не захватывается
+    PortMetrics* m_metrics = nullptr;  // метрики порта на момент start; до stop не меняется
+
+    FrameSentCallback m_frameSentCallback;
+    MessageCompletedCallback m_messageCompletedCallback;
+};
@@ -0,0 +1,395 @@
+#include "VirtualSerialPort.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+VirtualSerialPort::~VirtualSerialPort() {
+    close();
+}
+
+bool VirtualSerialPort::open(const std::string& portName, int baudRate) {
+    if (m_isOpen) {
+        close();
+    }
+
+    m_portName = portName;
+    m_baudRate = baudRate;
+    m_metrics = MetricsRegistry::getInstance().getPort(portName);
+    m_isOpen = true;
+    return true;
+}
+
+void VirtualSerialPort::close() {
+    stopAsyncReading();
+    m_isOpen = false;
+}
+
+bool VirtualSerialPort::writeData(const char* data, size_t length) {
+    if (!isOpen()) return false;
+
+    TRACE_SCOPE_ARG("writeData", length);
+    {
+        ScopedLatency latency(m_metrics, MetricStage::Write);
+        m_txLink->transmit(data, length);
+    }
+
+    m_metrics->add(MetricCounter::BytesSent, length);
+
+    CaptureWriter* capture = m_capture;
+    if (capture && length > 0) {
+        capture->record(CaptureDirection::Transmitted, data, length);
+    }
+
+    return true;
+}
+
+bool VirtualSerialPort::startAsyncReading(const DataReadyCallback& callback) {
+    if (!m_isOpen || m_keepReading) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        m_dataCallback = callback;
+    }
+    m_notifyPending = false;
+    m_keepReading = true;
+
+    // байты, пришедшие между open и началом чтения, лежат в буфере - как в буфере драйвера
+    if (!m_rxRing.empty() && !m_notifyPending.exchange(true)) {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (m_dataCallback) {
+            m_dataCallback();
+        }
+    }
+
+    return true;
+}
+
+void VirtualSerialPort::stopAsyncReading() {
+    m_keepReading = false;
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_dataCallback = nullptr;
+}
+
+void VirtualSerialPort::deliver(const char* data, size_t length) {
+    if (!m_isOpen) {
+        // на закрытом конце кабеля байты теряются
+        return;
+    }
+
+    TRACE_SCOPE_ARG("readChunk", length);
+
+    CaptureWriter* capture = m_capture;
+    if (capture) {
+        capture->record(CaptureDirection::Received, data, length);
+    }
+    m_metrics->add(MetricCounter::BytesReceived, length);
+
+    while (length > 0) {
+        char* region;
+        size_t space = m_rxRing.writableRegion(region);
+        if (space == 0) {
+            // потребитель не успевает - линия ждёт, как при аппаратном управлении потоком
+            if (!m_isOpen) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        size_t count = std::min(space, length);
+        std::copy(data, data + count, region);
+        m_rxRing.commitWrite(count);
+        data += count;
+        length -= count;
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_keepReading && !m_notifyPending.exchange(true)) {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            if (m_dataCallback) {
+                m_dataCallback();
+            }
+        }
+    }
+}
+
+size_t VirtualSerialPort::readReceived(std::string& out) {
+    m_notifyPending = false;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    size_t total = 0;
+    const char* region;
+    size_t length;
+
+    while ((length = m_rxRing.readableRegion(region)) > 0) {
+        out.append(region, length);
+        m_rxRing.commitRead(length);
+        total += length;
+    }
+
+    return total;
+}
+
+bool VirtualSerialPort::setBaudRate(int baudRate) {
+    if (!isOpen() || baudRate <= 0) return false;
+
+    m_baudRate = baudRate;
+    return true;
+}
+
+VirtualLink::VirtualLink(VirtualSerialPort& sender, VirtualSerialPort& receiver, bool paced)
+    : m_sender(sender)
+    , m_receiver(receiver)
+    , m_paced(paced)
+    , m_lineFreeAt(std::chrono::steady_clock::now()) {
+    setModel(LinkModel());
+    m_deliveryThread = std::thread(&VirtualLink::deliveryThreadFunc, this);
+}
+
+VirtualLink::~VirtualLink() {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_keepRunning = false;
+    }
+    m_queueCondition.notify_all();
+
+    if (m_deliveryThread.joinable()) {
+        m_deliveryThread.join();
+    }
+}
+
+void VirtualLink::setModel(const LinkModel& model) {
+    std::lock_guard<std::mutex> lock(m_modelMutex);
+    m_model = model;
+    m_generator.seed(model.seed ? model.seed : std::random_device{}());
+}
+
+LinkStatistics VirtualLink::getStatistics() {
+    std::lock_guard<std::mutex> lock(m_modelMutex);
+    return m_statistics;
+}
+
+void VirtualLink::resetStatistics() {
+    std::lock_guard<std::mutex> lock(m_modelMutex);
+    m_statistics = LinkStatistics();
+}
+
+void VirtualLink::transmit(const char* data, size_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point lineFreeAt;
+    std::string bytes(data, length);
+
+    {
+        std::lock_guard<std::mutex> lock(m_modelMutex);
+
+        const int txBaud = m_sender.getBaudRate();
+        const int rxBaud = m_receiver.getBaudRate();
+
+        // время на линии определяет скорость передатчика
+        auto wireTime = std::chrono::nanoseconds(static_cast<int64_t>(
+            std::llround(1e9 * m_model.bitsPerByte() * length / txBaud)));
+        auto start = m_paced ? std::max(now, m_lineFreeAt) : now;
+        m_lineFreeAt = start + wireTime;
+        lineFreeAt = m_lineFreeAt;
+
+        m_statistics.bytesWritten += length;
+        m_statistics.wireTimeNs += static_cast<uint64_t>(wireTime.count());
+
+        if (txBaud != rxBaud) {
+            bytes = resample(bytes, txBaud, rxBaud);
+            m_statistics.bytesGarbled += length;
+        }
+        applyErrors(bytes);
+
+        if (!bytes.empty()) {
+            auto latency = std::chrono::microseconds(m_model.latencyUs);
+
+            std::lock_guard<std::mutex> queueLock(m_queueMutex);
+            for (size_t offset = 0; offset < bytes.size(); offset += VIRTUAL_DELIVERY_CHUNK) {
+                size_t count = std::min<size_t>(VIRTUAL_DELIVERY_CHUNK, bytes.size() - offset);
+
+                // порция доступна приёмнику, когда по линии прошёл её последний байт
+                auto deliverAt = now + latency;
+                if (m_paced) {
+                    deliverAt = start + wireTime * static_cast<int64_t>(offset + count) / static_cast<int64_t>(bytes.size()) + latency;
+                }
+                m_queue.push_back(Chunk{deliverAt, bytes.substr(offset, count)});
+            }
+        }
+    }
+    m_queueCondition.notify_one();
+
+    if (m_paced) {
+        // как синхронный WriteFile: возврат, когда передатчик опустел
+        std::this_thread::sleep_until(lineFreeAt);
+    }
+}
+
+void VirtualLink::applyErrors(std::string& bytes) {
+    if (m_model.dataBits < 8) {
+        const char mask = static_cast<char>((1 << m_model.dataBits) - 1);
+        for (char& byte : bytes) {
+            byte &= mask;
+        }
+    }
+
+    if (m_model.byteDropRate > 0.0) {
+        std::geometric_distribution<size_t> gap(std::min(m_model.byteDropRate, VIRTUAL_MAX_RATE));
+        std::string kept;
+        kept.reserve(bytes.size());
+
+        size_t next = gap(m_generator);
+        for (size_t i = 0; i < bytes.size(); i++) {
+            if (i == next) {
+                m_statistics.bytesDropped++;
+                next += 1 + gap(m_generator);
+            } else {
+                kept += bytes[i];
+            }
+        }
+        bytes.swap(kept);
+    }
+
+    if (m_model.bitErrorRate > 0.0 && !bytes.empty()) {
+        // расстояние до следующего ошибочного бита вместо броска на каждый бит
+        std::geometric_distribution<uint64_t> gap(std::min(m_model.bitErrorRate, VIRTUAL_MAX_RATE));
+        const uint64_t totalBits = static_cast<uint64_t>(bytes.size()) * m_model.dataBits;
+
+        for (uint64_t bit = gap(m_generator); bit < totalBits; bit += 1 + gap(m_generator)) {
+            bytes[bit / m_model.dataBits] ^= static_cast<char>(1 << (bit % m_model.dataBits));
+            m_statistics.bitsFlipped++;
+        }
+    }
+}
+
+// Приём потока, переданного на одной скорости, UART-ом, настроенным на другую:
+// приёмник ловит спад старт-бита и читает биты в середине своих битовых интервалов.
+std::string VirtualLink::resample(const std::string& bytes, int txBaud, int rxBaud) {
+    const int dataBits = m_model.dataBits;
+
+    std::vector<uint8_t> line;
+    line.reserve(bytes.size() * m_model.bitsPerByte());
+    for (char c : bytes) {
+        uint8_t value = static_cast<uint8_t>(c);
+        int ones = 0;
+
+        line.push_back(0);
+        for (int i = 0; i < dataBits; i++) {
+            uint8_t bit = (value >> i) & 1;
+            ones += bit;
+            line.push_back(bit);
+        }
+        if (m_model.parityBits) {
+            line.push_back(ones & 1);
+        }
+        for (int i = 0; i < m_model.stopBits; i++) {
+            line.push_back(1);
+        }
+    }
+
+    const double txBit = 1.0 / txBaud;
+    const double rxBit = 1.0 / rxBaud;
+    auto level = [&](double t) {
+        size_t index = static_cast<size_t>(t / txBit);
+        return index < line.size() ? line[index] : static_cast<uint8_t>(1);
+    };
+
+    std::string out;
+    double t = 0.0;
+    size_t index = 0;
+
+    while (true) {
+        index = std::max(index, static_cast<size_t>(t / txBit));
+        while (index < line.size() && line[index] != 0) {
+            index++;
+        }
+        if (index >= line.size()) {
+            break;
+        }
+
+        double startBit = std::max(t, index * txBit);
+        uint8_t value = 0;
+        for (int i = 0; i < dataBits; i++) {
+            if (level(startBit + (1.5 + i) * rxBit)) {
+                value |= static_cast<uint8_t>(1 << i);
+            }
+        }
+        out += static_cast<char>(value);
+
+        // до середины стоп-бита приёмник новый старт-бит не ищет
+        t = startBit + (1.5 + dataBits + m_model.parityBits) * rxBit;
+    }
+
+    return out;
+}
+
+void VirtualLink::deliveryThreadFunc() {
+    Tracer::setThreadName("link");
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    while (m_keepRunning) {
+        if (m_queue.empty()) {
+            m_queueCondition.wait(lock);
+            continue;
+        }
+
+        auto deliverAt = m_queue.front().deliverAt;
+        if (std::chrono::steady_clock::now() < deliverAt) {
+            m_queueCondition.wait_until(lock, deliverAt);
+            continue;
+        }
+
+        Chunk chunk = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+
+        m_receiver.deliver(chunk.bytes.data(), chunk.bytes.size());
+        {
+            std::lock_guard<std::mutex> modelLock(m_modelMutex);
+            m_statistics.bytesDelivered += chunk.bytes.size();
+        }
+
+        lock.lock();
+    }
+}
+
+VirtualNullModem::VirtualNullModem(bool paced, const LinkModel& model)
+    : m_paced(paced)
+    , m_endpointA(new VirtualSerialPort())
+    , m_endpointB(new VirtualSerialPort()) {
+    m_linkAtoB.reset(new VirtualLink(*m_endpointA, *m_endpointB, paced));
+    m_linkBtoA.reset(new VirtualLink(*m_endpointB, *m_endpointA, paced));
+
+    m_linkAtoB->setModel(model);
+    m_linkBtoA->setModel(model);
+
+    m_endpointA->m_txLink = m_linkAtoB.get();
+    m_endpointB->m_txLink = m_linkBtoA.get();
+}
+
+VirtualNullModem::~VirtualNullModem() {
+    // закрытие отпускает поток доставки, если он ждёт места в буфере приёма
+    m_endpointA->close();
+    m_endpointB->close();
+
+    m_linkAtoB.reset();
+    m_linkBtoA.reset();
+}
+
+void VirtualNullModem::setLinkModel(LinkDirection direction, const LinkModel& model) {
+    link(direction).setModel(model);
+}
+
+LinkStatistics VirtualNullModem::getStatistics(LinkDirection direction) {
+    return link(direction).getStatistics();
+}
+
+void VirtualNullModem::resetStatistics() {
+    m_linkAtoB->resetStatistics();
+    m_linkBtoA->resetStatistics();
+}
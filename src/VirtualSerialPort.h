@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "ByteRingBuffer.h"
+#include "CaptureWriter.h"
+#include "Metrics.h"
+#include "SerialPort.h"
+
+#define VIRTUAL_RX_RING_SIZE (64 * 1024)
+#define VIRTUAL_DELIVERY_CHUNK 16 // столько байтов приёмник получает за раз (как FIFO UART)
+#define VIRTUAL_MAX_RATE 0.999999  // geometric_distribution не допускает вероятность 1
+
+// Модель линии в одном направлении
+struct LinkModel {
+    int dataBits = 8;
+    int parityBits = 0;         // 0 или 1 (чётность)
+    int stopBits = 1;
+    int latencyUs = 0;          // задержка доставки сверх времени передачи (драйвер, USB-адаптер)
+    double bitErrorRate = 0.0;  // вероятность инверсии каждого бита данных
+    double byteDropRate = 0.0;  // вероятность потери байта целиком
+    uint32_t seed = 0;          // 0 - случайное начальное значение
+
+    // старт + данные + чётность + стоп
+    int bitsPerByte() const { return 1 + dataBits + parityBits + stopBits; }
+};
+
+struct LinkStatistics {
+    uint64_t bytesWritten = 0;
+    uint64_t bytesDelivered = 0;
+    uint64_t bytesDropped = 0;
+    uint64_t bitsFlipped = 0;
+    uint64_t bytesGarbled = 0;  // искажены из-за несовпадения скоростей
+    uint64_t wireTimeNs = 0;    // суммарное время занятости линии при заданной скорости
+};
+
+class VirtualNullModem;
+class VirtualLink;
+
+// Конец виртуального нуль-модемного кабеля. Ведёт себя как ComPort: запись занимает
+// линию на время, определяемое скоростью, а принятые байты появляются в буфере
+// приёма порциями, как из FIFO UART.
+class VirtualSerialPort : public SerialPort {
+public:
+    ~VirtualSerialPort() override;
+
+    bool open(const std::string& portName, int baudRate = 9600) override;
+    void close() override;
+    bool isOpen() const override { return m_isOpen; }
+
+    using SerialPort::writeData;
+    bool writeData(const char* data, size_t length) override;
+
+    bool startAsyncReading(const DataReadyCallback& callback = nullptr) override;
+    void stopAsyncReading() override;
+
+    size_t readReceived(std::string& out) override;
+
+    bool setBaudRate(int baudRate) override;
+
+    void setCaptureWriter(CaptureWriter* writer) override { m_capture = writer; }
+    PortMetrics* getMetrics() const override { return m_metrics; }
+
+    std::string getPortName() const override { return m_portName; }
+    int getBaudRate() const override { return m_baudRate; }
+
+private:
+    friend class VirtualNullModem;
+    friend class VirtualLink;
+
+    VirtualSerialPort() = default;
+
+    // вызывается потоком доставки линии
+    void deliver(const char* data, size_t length);
+
+    VirtualLink* m_txLink = nullptr;
+    std::string m_portName;
+    std::atomic<int> m_baudRate{9600};
+
+    std::atomic<bool> m_isOpen{false};
+    std::atomic<bool> m_keepReading{false};
+
+    ByteRingBuffer m_rxRing{VIRTUAL_RX_RING_SIZE};
+    std::atomic<bool> m_notifyPending{false};
+    std::mutex m_callbackMutex;
+    DataReadyCallback m_dataCallback;
+    std::atomic<CaptureWriter*> m_capture{nullptr};
+    PortMetrics* m_metrics = nullptr;
+};
+
+// Одно направление кабеля: модель ошибок, расчёт времени на линии и поток доставки
+class VirtualLink {
+public:
+    VirtualLink(VirtualSerialPort& sender, VirtualSerialPort& receiver, bool paced);
+    ~VirtualLink();
+
+    VirtualLink(const VirtualLink&) = delete;
+    VirtualLink& operator=(const VirtualLink&) = delete;
+
+    void setModel(const LinkModel& model);
+    LinkStatistics getStatistics();
+    void resetStatistics();
+
+    // возвращает, когда последний байт ушёл в линию (в темповом режиме)
+    void transmit(const char* data, size_t length);
+
+private:
+    struct Chunk {
+        std::chrono::steady_clock::time_point deliverAt;
+        std::string bytes;
+    };
+
+    void applyErrors(std::string& bytes);
+    std::string resample(const std::string& bytes, int txBaud, int rxBaud);
+    void deliveryThreadFunc();
+
+    VirtualSerialPort& m_sender;
+    VirtualSerialPort& m_receiver;
+    const bool m_paced;
+
+    std::mutex m_modelMutex; // модель, генератор, статистика и занятость линии
+    LinkModel m_model;
+    std::mt19937 m_generator;
+    LinkStatistics m_statistics;
+    std::chrono::steady_clock::time_point m_lineFreeAt;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCondition;
+    std::deque<Chunk> m_queue;
+    bool m_keepRunning = true;
+    std::thread m_deliveryThread;
+};
+
+enum class LinkDirection : uint8_t {
+    AtoB,
+    BtoA
+};
+
+// Пара соединённых виртуальных портов. В темповом режиме (paced) передача идёт
+// со скоростью линии с учётом старт/стоп-битов, в нетемповом - байты доставляются
+// сразу, а время на линии только подсчитывается.
+class VirtualNullModem {
+public:
+    explicit VirtualNullModem(bool paced = true, const LinkModel& model = LinkModel());
+    ~VirtualNullModem();
+
+    VirtualNullModem(const VirtualNullModem&) = delete;
+    VirtualNullModem& operator=(const VirtualNullModem&) = delete;
+
+    VirtualSerialPort& endpointA() { return *m_endpointA; }
+    VirtualSerialPort& endpointB() { return *m_endpointB; }
+
+    void setLinkModel(LinkDirection direction, const LinkModel& model);
+    LinkStatistics getStatistics(LinkDirection direction);
+    void resetStatistics();
+
+    bool isPaced() const { return m_paced; }
+
+private:
+    VirtualLink& link(LinkDirection direction) { return direction == LinkDirection::AtoB ? *m_linkAtoB : *m_linkBtoA; }
+
+    const bool m_paced;
+    std::unique_ptr<VirtualSerialPort> m_endpointA;
+    std::unique_ptr<VirtualSerialPort> m_endpointB;
+    std::unique_ptr<VirtualLink> m_linkAtoB;
+    std::unique_ptr<VirtualLink> m_linkBtoA;
+};
@@ -1,17 +1,28 @@
 #include "mainwindow.h"
 #include "ChannelManager.h"
+#include "Tracer.h"
 #include "ui_mainwindow.h"
+#include <QFileDialog>
 #include <QMessageBox>
 #include <QScrollBar>
-#include <QDateTime>
-#include <QThread>
+#include <QTextCursor>
+#include <QStatusBar>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_frameInfoDialog(new FrameInfoDialog(this))
+    , m_statisticsDialog(new StatisticsDialog(this))
 {
     ui->setupUi(this);
+    Tracer::setThreadName("gui");
+    m_logSink = new LogSink(ui->logTextEdit, this);
+    m_receivePipeline = std::make_unique<ReceivePipeline>(m_threadPool, &m_logSink->queue());
+    m_transmitWorker = std::make_unique<TransmitWorker>(m_comPort, m_threadPool, &m_logSink->queue());
+
+    ui->receiveTextEdit->document()->setMaximumBlockCount(RECEIVE_MAX_LINES);
+    connect(&m_receiveFlushTimer, &QTimer::timeout, this, &MainWindow::onFlushReceivedData);
+    m_receiveFlushTimer.start(RECEIVE_FLUSH_INTERVAL_MS);
 
     QVector<int> standardBaudRates = {50, 75, 110, 134, 150, 300, 600, 1200, 1800, 2400, 4800, 9600, 19200, 38400, 57600, 115200};
     for (int rate : standardBaudRates) {
@@ -19,7 +30,20 @@ MainWindow::MainWindow(QWidget *parent)
     }
     ui->baudRateComboBox->setCurrentIndex(11);
 
-    onRefreshPorts();
+    ui->portComboBox->addItem("Поиск портов...");
+    ui->openCloseButton->setEnabled(false);
+    m_portDiscovery.start([this](const std::vector<std::string>& added, const std::vector<std::string>& removed) {
+        QStringList addedPorts;
+        QStringList removedPorts;
+        for (const auto& port : added) {
+            addedPorts << QString::fromStdString(port);
+        }
+        for (const auto& port : removed) {
+            removedPorts << QString::fromStdString(port);
+        }
+        QMetaObject::invokeMethod(this, "onPortsChanged", Qt::QueuedConnection,
+                                  Q_ARG(QStringList, addedPorts), Q_ARG(QStringList, removedPorts));
+    });
 
     connect(ui->refreshButton, &QPushButton::clicked, this, &MainWindow::onRefreshPorts);
     connect(ui->openCloseButton, &QPushButton::clicked, this, &MainWindow::onOpenClose);
@@ -33,7 +57,12 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(ui->sendLineEdit, &QLineEdit::returnPressed, this, &MainWindow::onSendData);
     connect(ui->frameInfoButton, &QPushButton::clicked, this, &MainWindow::onShowFrameInfo);
+    connect(ui->statisticsButton, &QPushButton::clicked, this, &MainWindow::onShowStatistics);
     connect(ui->enableEmulationCheckBox, &QCheckBox::toggled, this, &MainWindow::onEmulationToggled);
+    connect(ui->compressionCheckBox, &QCheckBox::toggled, this, &MainWindow::onCompressionToggled);
+    connect(ui->captureButton, &QPushButton::toggled, this, &MainWindow::onCaptureToggled);
+    connect(ui->sessionLogButton, &QPushButton::toggled, this, &MainWindow::onSessionLogToggled);
+    connect(ui->traceButton, &QPushButton::toggled, this, &MainWindow::onTraceToggled);
 
     int clearButtonWidth = 140;
     ui->clearButton->setFixedWidth(clearButtonWidth);
@@ -44,45 +73,93 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    m_portDiscovery.stop();
+    m_transmitWorker->stop();
     if (m_portOpened) {
         m_comPort.close();
     }
+    m_receivePipeline->stop();
+    m_comPort.setCaptureWriter(nullptr);
+    m_captureWriter.close();
+    m_logSink->setSessionLog(nullptr);
+    m_sessionLog.close();
     delete ui;
 }
 
 void MainWindow::onRefreshPorts()
 {
+    m_portDiscovery.refresh();
+}
+
+void MainWindow::onPortsChanged(const QStringList &added, const QStringList &removed)
+{
+    if (m_portsDiscovered) {
+        for (const QString &port : added) {
+            logMessage("Подключен порт " + port, false);
+        }
+        for (const QString &port : removed) {
+            logMessage("Отключен порт " + port, false);
+        }
+    }
+    m_portsDiscovered = true;
+
+    QString currentPort = ui->portComboBox->currentText();
     ui->portComboBox->clear();
 
-    auto ports = ComPort::getAvailablePorts();
+    auto ports = m_portDiscovery.getPorts();
     for (const auto& port : ports) {
         ui->portComboBox->addItem(QString::fromStdString(port));
     }
 
+    int currentIndex = ui->portComboBox->findText(currentPort);
+    if (currentIndex >= 0) {
+        ui->portComboBox->setCurrentIndex(currentIndex);
+    }
+
     if (ports.empty()) {
         ui->portComboBox->addItem("Нет доступных портов");
-        ui->openCloseButton->setEnabled(false);
-    } else {
-        ui->openCloseButton->setEnabled(true);
     }
+    // открытый порт должно быть можно закрыть, даже если устройство уже отключено
+    ui->openCloseButton->setEnabled(m_portOpened || !ports.empty());
 }
 
 void MainWindow::onOpenClose()
 {
     if (m_portOpened) {
+        m_transmitWorker->stop();
         m_comPort.close();
+        m_receivePipeline->stop();
         m_portOpened = false;
+        updateQueueStatus();
         logMessage("Порт закрыт", false);
     } else {
         QString portName = ui->portComboBox->currentText();
         int baudRate = ui->baudRateComboBox->currentData().toInt();
 
         if (m_comPort.open(portName.toStdString(), baudRate)) {
-            m_comPort.startAsyncReading([this](const std::string& data) {
-                QMetaObject::invokeMethod(this, "onDataReceived",
-                                          Qt::QueuedConnection, Q_ARG(std::string, data));
+            m_receivePipeline->setMetrics(m_comPort.getMetrics());
+            m_receivePipeline->start(
+                [this](std::string& out) { return m_comPort.readReceived(out); },
+                [this]() { QMetaObject::invokeMethod(this, "onReceiveResults", Qt::QueuedConnection); });
+
+            m_comPort.startAsyncReading([this]() {
+                m_receivePipeline->notifyDataAvailable();
             });
 
+            m_transmitWorker->start(
+                [this](const TransmitReport& report) {
+                    QMetaObject::invokeMethod(this, "onFrameSent", Qt::QueuedConnection,
+                                              Q_ARG(int, report.current),
+                                              Q_ARG(int, report.total),
+                                              Q_ARG(size_t, report.fcsSize),
+                                              Q_ARG(size_t, report.stuffedFcsSize),
+                                              Q_ARG(std::string, report.stuffedFrame));
+                },
+                [this](uint64_t messageId, bool success) {
+                    QMetaObject::invokeMethod(this, "onMessageCompleted", Qt::QueuedConnection,
+                                              Q_ARG(quint64, messageId), Q_ARG(bool, success));
+                });
+
             m_portOpened = true;
             logMessage("Порт " + portName + " открыт, скорость: " + QString::number(baudRate),false);
         } else {
@@ -107,178 +184,51 @@ void MainWindow::onSendData()
         return;
     }
 
-    ui->sendButton->setEnabled(false);
-    ui->sendLineEdit->setEnabled(false);
-
-    sendMessageInBackground(message);
-}
-
-void MainWindow::sendMessageInBackground(const QString& message) {
-    bool emulationEnabled = m_emulationEnabled;
-
-    m_sendThread = QThread::create([this, message, emulationEnabled]() {
-        std::vector<Frame> frames = m_frameManager.packMessage(message.toStdString());
-
-        QMetaObject::invokeMethod(this, "logMessage",
-                                  Qt::QueuedConnection,
-                                  Q_ARG(const QString&, "Сообщение:\n" + message + "\nбыло сегментировано на кадры"),
-                                  Q_ARG(bool, false));
-
-        std::vector<std::string> stuffedFrames = m_frameManager.byteStuff(frames);
-
-        for(int i = 0; i < stuffedFrames.size(); i++) {
-            bool success;
-
-            if (emulationEnabled) {
-                success = transmitWithCSMACD(stuffedFrames[i], i + 1);
-            } else {
-                success = m_comPort.writeData(stuffedFrames[i]);
-            }
-
-            if (success) {
-                QMetaObject::invokeMethod(this, "onFrameSent",
-                                          Qt::QueuedConnection,
-                                          Q_ARG(int, i + 1),
-                                          Q_ARG(int, frames[i].getTotal()),
-                                          Q_ARG(size_t, m_frameManager.getStuffedFcsSize(frames[i].getFcs())),
-                                          Q_ARG(std::string, stuffedFrames[i]));
-
-                QMetaObject::invokeMethod(this, "logMessage",
-                                          Qt::QueuedConnection,
-                                          Q_ARG(const QString&, "Кадр " + QString::number(i + 1) + " успешно передан"),
-                                          Q_ARG(bool, false));
-            } else {
-                QString errorMsg = emulationEnabled ?
-                                       "Ошибка: не удалось передать кадр " + QString::number(i + 1) + " после всех попыток" :
-                                       "Ошибка передачи кадра " + QString::number(i + 1);
-
-                QMetaObject::invokeMethod(this, "logMessage",
-                                          Qt::QueuedConnection,
-                                          Q_ARG(const QString&, errorMsg),
-                                          Q_ARG(bool, false));
-            }
-
-            QThread::msleep(10);
-        }
-
-        QMetaObject::invokeMethod(this, "onSendCompleted", Qt::QueuedConnection);
-    });
+    uint64_t messageId = m_transmitWorker->submit(message.toStdString());
+    if (messageId == 0) {
+        QMessageBox::warning(this, "Ошибка", "Очередь передачи заполнена, повторите попытку позже");
+        return;
+    }
 
-    connect(m_sendThread, &QThread::finished, m_sendThread, &QObject::deleteLater);
-    m_sendThread->start();
+    ui->sendLineEdit->clear();
+    updateQueueStatus();
 }
 
-size_t MainWindow::findCompleteFrame(const std::string& data)
+void MainWindow::onReceiveResults()
 {
-    if (data.length() < HEADER_SIZE + 1 + 1 + TRAILER_SIZE) {
-        return 0;
-    }
+    TRACE_SCOPE("onReceiveResults");
+    m_receivePipeline->takeResults(m_receiveResults);
 
-    size_t startPos = data.find(static_cast<char>(START_FLAG_BYTE));
-    if (startPos == std::string::npos) {
-        return 0;
+    for (const DecodedFrame& frame : m_receiveResults.frames) {
+        m_frameInfoDialog->addReceivedFrame(frame.sequence, frame.total, frame.fcsSize, frame.stuffedFcsSize,
+                                            frame.correctionResult, frame.stuffedFrame);
     }
 
-    while (startPos < data.length() && data[startPos] == static_cast<char>(START_FLAG_BYTE)) {
-        startPos++;
-    }
-    if (startPos > 0) startPos--;
-
-    for (size_t i = startPos + 1; i < data.length(); i++) {
-        if (static_cast<uint8_t>(data[i]) == END_FLAG_BYTE) {
-            size_t frameLength = i - startPos + 1;
-
-            std::string potentialFrame = data.substr(startPos, frameLength);
-            if (FrameManager::isValidFrame(potentialFrame)) {
-                return startPos + frameLength;
-            }
-        }
+    for (const std::string& message : m_receiveResults.messages) {
+        displayReceivedData(QString::fromStdString(message) + "\n");
     }
-
-    return 0;
 }
 
-void MainWindow::onDataReceived(const std::string& data)
+void MainWindow::displayReceivedData(const QString &data)
 {
-    if (!data.empty()) {
-        if (static_cast<uint8_t>(data[0]) == START_FLAG_BYTE && !m_receivedBytes.empty()) {
-            m_receivedBytes.clear();
-        }
-
-        std::string jamPattern(4, '\xFF');
-        size_t jamPos = data.find(jamPattern);
-
-        if (jamPos != std::string::npos) {
-            logMessage("Обнаружен JAM-сигнал", true);
-
-            if (jamPos > 0) {
-                std::string beforeJam = data.substr(0, jamPos);
-                m_receivedBytes.append(beforeJam);
-            }
-
-            size_t afterJamPos = jamPos + jamPattern.length();
-            if (afterJamPos < data.length()) {
-                std::string afterJam = data.substr(afterJamPos);
-                m_receivedBytes.append(afterJam);
-            }
-
-        } else {
-            m_receivedBytes.append(data);
-        }
-
-        while (true) {
-            size_t frameLength = findCompleteFrame(m_receivedBytes);
-            if (frameLength == 0) {
-                break;
-            }
-
-            std::string receivedFrame = m_receivedBytes.substr(0, frameLength);
-            m_receivedBytes = m_receivedBytes.substr(frameLength);
-
-            Frame unstaffedFrame = m_frameManager.byteUnstuff(receivedFrame);
-
-            unstaffedFrame.simulateErrors();
-
-            QString corruptedReceivedMessage = QString::fromStdString(m_frameManager.unpackMessage(unstaffedFrame));
-
-            if(corruptedReceivedMessage != "\n") {
-                logMessage("Получен кадр " + QString::number(unstaffedFrame.getSequence()) +
-                               " из " + QString::number(unstaffedFrame.getTotal()) +
-                               " с данными: " + corruptedReceivedMessage, true);
-            }
-
-            //logMessage("Сгенерировано ошибок в " + QString::number(unstaffedFrame.simulateErrors()) + " битах", true);
-
-            switch(unstaffedFrame.correctErrors()) {
-            case 0:
-                logMessage("Ошибок обнаружено не было", true);
-                break;
-            case 1:
-                logMessage("Исправлена одиночная ошибка", true);
-                break;
-            case 2:
-                logMessage("Обнаружена двойная ошибка", true);
-                break;
-            default:
-                logMessage("Были переданы пустые данные", true);
-            }
-
-            QString receivedMessage = QString::fromStdString(m_frameManager.unpackMessage(unstaffedFrame));
-            displayReceivedData(receivedMessage);
-
-            if(unstaffedFrame.getSequence() == unstaffedFrame.getTotal()) {
-                displayReceivedData("\n");
-            }
-        }
-    }
+    m_receiveStaging += data;
 }
 
-void MainWindow::displayReceivedData(const QString &data)
+void MainWindow::onFlushReceivedData()
 {
+    if (m_receiveStaging.isEmpty()) {
+        return;
+    }
+
+    TRACE_SCOPE_ARG("displayReceived", m_receiveStaging.size());
+
     QScrollBar *scrollBar = ui->receiveTextEdit->verticalScrollBar();
     bool atBottom = scrollBar->value() == scrollBar->maximum();
 
-    ui->receiveTextEdit->insertPlainText(data);
+    QTextCursor cursor(ui->receiveTextEdit->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(m_receiveStaging);
+    m_receiveStaging.clear();
 
     if (atBottom) {
         scrollBar->setValue(scrollBar->maximum());
@@ -292,6 +242,7 @@ void MainWindow::onClearLog()
 
 void MainWindow::onClearReceive()
 {
+    m_receiveStaging.clear();
     ui->receiveTextEdit->clear();
 }
 
@@ -340,23 +291,7 @@ void MainWindow::updatePortStatus()
 
 void MainWindow::logMessage(const QString &message, bool isIncoming)
 {
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
-    QString formattedMessage;
-
-    if (isIncoming) {
-        formattedMessage = QString("[%1] ← %2").arg(timestamp, message);
-    } else {
-        formattedMessage = QString("[%1] → %2").arg(timestamp, message);
-    }
-
-    QScrollBar *scrollBar = ui->logTextEdit->verticalScrollBar();
-    bool atBottom = scrollBar->value() == scrollBar->maximum();
-
-    ui->logTextEdit->append(formattedMessage);
-
-    if (atBottom) {
-        scrollBar->setValue(scrollBar->maximum());
-    }
+    m_logSink->post(message, isIncoming);
 }
 
 void MainWindow::onShowFrameInfo()
@@ -366,113 +301,155 @@ void MainWindow::onShowFrameInfo()
     m_frameInfoDialog->activateWindow();
 }
 
-void MainWindow::onFrameSent(int current, int total, size_t stuffedFcsSize, const std::string& stuffedFrame)
+void MainWindow::onShowStatistics()
 {
-    logMessage("Отправлен кадр " + QString::number(current) + " из " + QString::number(total), false);
-    m_frameInfoDialog->addTransmittedFrame(current, total, stuffedFcsSize, stuffedFrame);
+    m_statisticsDialog->show();
+    m_statisticsDialog->raise();
+    m_statisticsDialog->activateWindow();
 }
 
-void MainWindow::onSendCompleted()
+void MainWindow::onFrameSent(int current, int total, size_t fcsSize, size_t stuffedFcsSize, const std::string& stuffedFrame)
 {
-    ui->sendLineEdit->clear();
-    ui->sendButton->setEnabled(true);
-    ui->sendLineEdit->setEnabled(true);
+    TRACE_SCOPE_ARG("onFrameSent", current);
+    m_logSink->queue().push(LogEvent::FrameSent, false, current, total);
+    m_frameInfoDialog->addTransmittedFrame(current, total, fcsSize, stuffedFcsSize, stuffedFrame);
+    updateChannelStatistics();
+}
 
-    if (m_sendThread) {
-        m_sendThread->quit();
-        m_sendThread->wait();
-        m_sendThread = nullptr;
-    }
+void MainWindow::onMessageCompleted(quint64 messageId, bool success)
+{
+    Q_UNUSED(messageId)
+    Q_UNUSED(success)
+    updateChannelStatistics();
+    updateQueueStatus();
 }
 
-// Основной метод передачи с CSMA/CD
-bool MainWindow::transmitWithCSMACD(const std::string& frameData, int frameNumber) {
+void MainWindow::updateChannelStatistics()
+{
     ChannelManager& channel = ChannelManager::getInstance();
-    int attempt = 0;
-    const int maxAttempts = channel.getMaxAttempts();
-    const double slotTime = channel.getSlotTime();
-
-    size_t bytesSent = 0;
-
-    while (attempt < maxAttempts) {
-        if (channel.isChannelBusy()) {
-            int backoffSlots = channel.calculateBackoffDelay(attempt);
-            int backoffMs = static_cast<int>(backoffSlots * slotTime);
-
-            QMetaObject::invokeMethod(this, "logMessage",
-                                      Qt::QueuedConnection,
-                                      Q_ARG(const QString&,
-                                            QString("Канал занят, попытка %1. Задержка: %2 слотов (%3 мс)")
-                                                .arg(attempt + 1).arg(backoffSlots).arg(backoffMs)),
-                                      Q_ARG(bool, false));
-
-            QThread::msleep(backoffMs);
-            attempt++;
-            continue;
-        }
+    m_totalCollisions = channel.getCollisionCount();
+    m_currentBackoff = m_transmitWorker->getCurrentBackoffUs();
+    m_jamActive = channel.getJamSignal();
+}
 
-        bool collisionDetected = false;
+void MainWindow::updateQueueStatus()
+{
+    size_t queued = m_transmitWorker->queuedCount();
 
-        for (size_t i = bytesSent; i < frameData.length(); i++) {
-            if (channel.isCollisionOccurred()) {
-                collisionDetected = true;
-                break;
-            }
+    QStringList parts;
+    if (queued > 0) {
+        parts << "Сообщений в очереди на передачу: " + QString::number(queued);
+    }
+    if (m_emulationEnabled && m_totalCollisions > 0) {
+        parts << "коллизий: " + QString::number(m_totalCollisions) +
+                     ", последняя задержка: " + QString::number(m_currentBackoff) + " мкс";
+    }
 
-            std::string byteData(1, frameData[i]);
-            if (!m_comPort.writeData(byteData)) {
-                collisionDetected = true;
-                break;
-            }
+    if (!parts.isEmpty()) {
+        statusBar()->showMessage(parts.join("; "));
+    } else {
+        statusBar()->clearMessage();
+    }
+}
 
-            QThread::msleep(static_cast<int>(slotTime / frameData.length()));
-        }
+void MainWindow::onEmulationToggled(bool checked) {
+    m_emulationEnabled = checked;
+    m_transmitWorker->setEmulationEnabled(checked);
+    ChannelManager::getInstance().setEmulationEnabled(checked);
 
-        if (collisionDetected) {
-            // Коллизия обнаружена на одном из байтов - отправляем jam-сигнал
-            sendJamSignal();
+    if (checked) {
+        logMessage("Эмуляция CSMA/CD включена", false);
+    } else {
+        logMessage("Эмуляция CSMA/CD выключена", false);
+    }
+}
 
-            int backoffSlots = channel.calculateBackoffDelay(attempt);
-            int backoffMs = static_cast<int>(backoffSlots * slotTime);
+void MainWindow::onCompressionToggled(bool checked)
+{
+    m_transmitWorker->setCompressionEnabled(checked);
 
-            QMetaObject::invokeMethod(this, "logMessage",
-                                      Qt::QueuedConnection,
-                                      Q_ARG(const QString&,
-                                            QString("Коллизия на байте! Задержка: %1 слотов (%2 мс)")
-                                                .arg(backoffSlots).arg(backoffMs)),
-                                      Q_ARG(bool, false));
+    if (checked) {
+        logMessage("Сжатие сообщений включено", false);
+    } else {
+        logMessage("Сжатие сообщений выключено", false);
+    }
+}
 
-            QThread::msleep(backoffMs);
-            attempt++;
-        } else {
-            // Успешная передача всего кадра без коллизий
-            return true;
+void MainWindow::onCaptureToggled(bool checked)
+{
+    if (checked) {
+        QString fileName = QFileDialog::getSaveFileName(this, "Файл записи трафика", QString(),
+                                                        "Запись трафика (*.slcap)");
+        if (fileName.isEmpty() || !m_captureWriter.open(fileName.toLocal8Bit().toStdString())) {
+            QSignalBlocker blocker(ui->captureButton);
+            ui->captureButton->setChecked(false);
+            return;
         }
-    }
 
-    return false;
+        m_comPort.setCaptureWriter(&m_captureWriter);
+        logMessage("Запись трафика в файл " + fileName, false);
+    } else {
+        m_comPort.setCaptureWriter(nullptr);
+        uint64_t dropped = m_captureWriter.getDroppedBytes();
+        m_captureWriter.close();
+
+        logMessage("Запись трафика остановлена" +
+                       (dropped > 0 ? ", потеряно байт: " + QString::number(dropped) : QString()), false);
+    }
 }
 
-void MainWindow::sendJamSignal() {
-    // 32 бита jam-сигнала (4 байта)
-    std::vector<uint8_t> jamSignal(JAM_SIGNAL_SIZE / 8, 0xFF);
-    std::string jamStr(jamSignal.begin(), jamSignal.end());
+void MainWindow::onSessionLogToggled(bool checked)
+{
+    if (checked) {
+        QString fileName = QFileDialog::getSaveFileName(this, "Файл журнала сеанса", "session.ndjson",
+                                                        "Журнал сеанса (*.ndjson)");
+        if (fileName.isEmpty() || !m_sessionLog.open(fileName.toLocal8Bit().toStdString())) {
+            QSignalBlocker blocker(ui->sessionLogButton);
+            ui->sessionLogButton->setChecked(false);
+            return;
+        }
 
-    m_comPort.writeData(jamStr);
+        m_logSink->setSessionLog(&m_sessionLog);
+        logMessage("Журнал сеанса записывается в файл " + fileName, false);
+    } else {
+        logMessage("Запись журнала сеанса остановлена", false);
+        m_logSink->setSessionLog(nullptr);
+        uint64_t dropped = m_sessionLog.getDroppedCount();
+        m_sessionLog.close();
 
-    QMetaObject::invokeMethod(this, "logMessage",
-                              Qt::QueuedConnection,
-                              Q_ARG(const QString&, "Отправлен JAM-сигнал"),
-                              Q_ARG(bool, false));
+        if (dropped > 0) {
+            logMessage("Пропущено записей журнала сеанса: " + QString::number(dropped), false);
+        }
+    }
 }
 
-void MainWindow::onEmulationToggled(bool checked) {
-    m_emulationEnabled = checked;
-    ChannelManager::getInstance().setEmulationEnabled(checked);
+void MainWindow::onTraceToggled(bool checked)
+{
+    Tracer& tracer = Tracer::getInstance();
 
     if (checked) {
-        logMessage("Эмуляция CSMA/CD включена", false);
-    } else {
-        logMessage("Эмуляция CSMA/CD выключена", false);
+        tracer.start();
+        logMessage("Трассировка включена", false);
+        return;
+    }
+
+    tracer.stop();
+
+    QString fileName = QFileDialog::getSaveFileName(this, "Сохранить трассу", "trace.json",
+                                                    "Chrome trace-event (*.json)");
+    if (fileName.isEmpty()) {
+        logMessage("Трассировка выключена, трасса не сохранена", false);
+        return;
+    }
+
+    if (!tracer.writeJson(fileName.toLocal8Bit().toStdString())) {
+        QMessageBox::warning(this, "Ошибка", "Не удалось записать трассу в файл " + fileName);
+        return;
+    }
+
+    QString message = "Трасса сохранена в " + fileName + ", событий: " + QString::number(tracer.getEventCount());
+    if (tracer.getDroppedCount() > 0) {
+        message += ", пропущено: " + QString::number(tracer.getDroppedCount());
     }
+    logMessage(message, false);
 }
@@ -1,9 +1,22 @@
 #pragma once
 
 #include <QMainWindow>
+#include <QTimer>
+#include <memory>
 #include "ComPort.h"
+#include "CaptureWriter.h"
+#include "PortDiscovery.h"
 #include "FrameManager.h"
+#include "ReceivePipeline.h"
+#include "SessionLog.h"
+#include "ThreadPool.h"
+#include "TransmitWorker.h"
 #include "FrameInfo.h"
+#include "StatisticsDialog.h"
+#include "LogSink.h"
+
+#define RECEIVE_FLUSH_INTERVAL_MS 50
+#define RECEIVE_MAX_LINES 2000
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -19,39 +32,51 @@ public:
 
 private slots:
     void onRefreshPorts();
+    void onPortsChanged(const QStringList &added, const QStringList &removed);
     void onOpenClose();
     void onSendData();
     void onClearLog();
     void onClearReceive();
     void onShowFrameInfo();
+    void onShowStatistics();
 
     void onPortChanged(int index);
     void onBaudRateChanged(int index);
 
-    void onDataReceived(const std::string& data);
+    void onReceiveResults();
 
-    void onFrameSent(int current, int total, size_t stuffedFcsSize, const std::string& stuffedFrame);
-    void onSendCompleted();
+    void onFrameSent(int current, int total, size_t fcsSize, size_t stuffedFcsSize, const std::string& stuffedFrame);
+    void onMessageCompleted(quint64 messageId, bool success);
+    void onFlushReceivedData();
 
-    void logMessage(const QString &message, bool isIncoming);
     void onEmulationToggled(bool enabled);
+    void onCompressionToggled(bool enabled);
+    void onCaptureToggled(bool checked);
+    void onSessionLogToggled(bool checked);
+    void onTraceToggled(bool checked);
 private:
+    void logMessage(const QString &message, bool isIncoming);
     void updatePortStatus();
     void displayReceivedData(const QString &data);
-    void sendMessageInBackground(const QString& message);
-    size_t findCompleteFrame(const std::string& data);
-
-    // CSMA/CD методы
-    bool transmitWithCSMACD(const std::string& frameData, int frameNumber);
-    void sendJamSignal();
+    void updateQueueStatus();
+    void updateChannelStatistics();
 
     Ui::MainWindow *ui;
     ComPort m_comPort;
-    FrameManager m_frameManager;
-    std::string m_receivedBytes;
+    PortDiscovery m_portDiscovery;
+    CaptureWriter m_captureWriter;
+    SessionLog m_sessionLog;
+    bool m_portsDiscovered = false;
+    ThreadPool m_threadPool;
+    std::unique_ptr<ReceivePipeline> m_receivePipeline;
+    std::unique_ptr<TransmitWorker> m_transmitWorker;
+    ReceiveResults m_receiveResults;
+    QString m_receiveStaging;
+    QTimer m_receiveFlushTimer;
     FrameInfoDialog *m_frameInfoDialog;
+    StatisticsDialog *m_statisticsDialog;
+    LogSink *m_logSink;
     bool m_portOpened = false;
-    QThread* m_sendThread = nullptr;
     bool m_emulationEnabled = false;
 
     // CSMA/CD статистика
@@ -0,0 +1,101 @@
+#include "CobsStuffer.h"
+#include "FrameManager.h"
+#include "TestCheck.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+// данные, где Delimiter встречается с заданной частотой (в процентах), чтобы попадать
+// и на короткие участки, и на полные по MAX_RUN байт
+template <uint8_t Delimiter>
+std::vector<uint8_t> makeInput(std::mt19937& random, size_t length, unsigned density) {
+    std::vector<uint8_t> data(length);
+    for (uint8_t& byte : data) {
+        byte = random() % 100 < density ? Delimiter : static_cast<uint8_t>(Delimiter ^ (1 + random() % 255));
+    }
+    return data;
+}
+
+template <uint8_t Delimiter>
+bool roundTrips(const std::vector<uint8_t>& data) {
+    using Cobs = CobsStuffer<Delimiter>;
+
+    std::vector<char> stuffed(Cobs::maxStuffedSize(data.size()));
+    size_t stuffedLength = Cobs::stuff(data.data(), data.size(), stuffed.data());
+    if (stuffedLength != Cobs::stuffedSize(data.data(), data.size()) || stuffedLength > stuffed.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < stuffedLength; i++) {
+        if (static_cast<uint8_t>(stuffed[i]) == Delimiter) {
+            return false;
+        }
+    }
+
+    std::vector<uint8_t> restored(stuffedLength);
+    size_t written = 0;
+    if (!Cobs::unstuff(stuffed.data(), stuffedLength, restored.data(), written)) {
+        return false;
+    }
+    restored.resize(written);
+    return restored == data;
+}
+
+template <uint8_t Delimiter>
+void checkDelimiter() {
+    using Cobs = CobsStuffer<Delimiter>;
+    std::mt19937 random(Delimiter);
+
+    // все длины вокруг границ участка (254, 255, 508...) при разной плотности разделителя
+    for (size_t length = 0; length <= 600; length++) {
+        for (unsigned density : {0u, 1u, 10u, 50u, 100u}) {
+            CHECK(roundTrips<Delimiter>(makeInput<Delimiter>(random, length, density)));
+        }
+    }
+
+    // разделитель сразу после полного участка и в самом конце
+    for (size_t run : {Cobs::MAX_RUN - 1, Cobs::MAX_RUN, Cobs::MAX_RUN + 1}) {
+        std::vector<uint8_t> data = makeInput<Delimiter>(random, run, 0);
+        data.push_back(Delimiter);
+        CHECK(roundTrips<Delimiter>(data));
+        data.insert(data.end(), data.begin(), data.end());
+        CHECK(roundTrips<Delimiter>(data));
+    }
+
+    // без разделителей накладные расходы - ровно байт на участок
+    std::vector<uint8_t> plain = makeInput<Delimiter>(random, 10 * Cobs::MAX_RUN, 0);
+    CHECK(Cobs::stuffedSize(plain.data(), plain.size()) == plain.size() + 11);
+    CHECK(Cobs::stuffedSize(plain.data(), plain.size()) == Cobs::maxStuffedSize(plain.size()));
+
+    // поиск по словам находит разделитель в любой позиции и при любом выравнивании
+    std::vector<uint8_t> buffer = makeInput<Delimiter>(random, 40, 0);
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t position = offset; position < buffer.size(); position++) {
+            buffer[position] = Delimiter;
+            CHECK(Cobs::findDelimiter(buffer.data() + offset, buffer.size() - offset) == position - offset);
+            buffer[position] = static_cast<uint8_t>(Delimiter ^ 0x5A);
+        }
+        CHECK(Cobs::findDelimiter(buffer.data() + offset, buffer.size() - offset) == buffer.size() - offset);
+    }
+
+    // повреждённый вход: код, равный Delimiter, или участок за концом
+    uint8_t out[16];
+    size_t written = 0;
+    CHECK(Cobs::unstuff("", 0, out, written) && written == 0);
+    const char zeroCode[] = {static_cast<char>(Delimiter), 'a'};
+    CHECK(!Cobs::unstuff(zeroCode, sizeof(zeroCode), out, written));
+    const char overrun[] = {static_cast<char>(5 ^ Delimiter), 'a', 'b'};
+    CHECK(!Cobs::unstuff(overrun, sizeof(overrun), out, written));
+    const char exact[] = {static_cast<char>(3 ^ Delimiter), 'a', 'b'};
+    CHECK(Cobs::unstuff(exact, sizeof(exact), out, written) && written == 2);
+}
+
+} // namespace
+
+int main() {
+    checkDelimiter<COBS_DELIMITER>();
+    checkDelimiter<0x00>();  // классический COBS
+    checkDelimiter<0x7E>();
+    return TEST_RESULT();
+}
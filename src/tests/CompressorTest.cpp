@@ -0,0 +1,141 @@
+#include "Compressor.h"
+#include "TestCheck.h"
+
+#include <random>
+#include <string>
+
+namespace {
+
+// сжатое (если сжалось) распаковывается ровно в исходное
+bool roundTrips(const std::string& input, bool expectCompressed) {
+    std::string compressed;
+    bool shrunk = Compressor::compress(input, compressed);
+    if (shrunk != expectCompressed) {
+        return false;
+    }
+    if (!shrunk) {
+        return true;
+    }
+
+    std::string restored;
+    return compressed.size() < input.size() && Compressor::decompress(compressed, restored) && restored == input;
+}
+
+void testShortAndIncompressible() {
+    CHECK(roundTrips("", false));
+    CHECK(roundTrips(std::string(COMPRESSION_MIN_SIZE - 1, 'a'), false));
+
+    std::mt19937 random(1);
+    std::string noise(4096, '\0');
+    for (char& c : noise) {
+        c = static_cast<char>(random());
+    }
+    CHECK(roundTrips(noise, false));
+}
+
+void testEachMethod() {
+    // серии - RLE, повторы на расстоянии - LZ77, короткая телеметрия - LZ77 со словарём
+    CHECK(roundTrips(std::string(COMPRESSION_MIN_SIZE, 'a'), true));
+    CHECK(roundTrips(std::string(1000, '\0') + std::string(1000, '\xFF'), true));
+    std::string repeated;
+    for (int i = 0; i < 50; i++) {
+        repeated += "abcdefghijklmnopqrstuvwxyz" + std::to_string(i % 7);
+    }
+    CHECK(roundTrips(repeated, true));
+    CHECK(roundTrips("status: OK temperature=21.5 voltage=3.30 current=0.12", true));
+
+    // первый байт блока - один из известных методов
+    std::string compressed;
+    CHECK(Compressor::compress(std::string(500, 'z'), compressed));
+    uint8_t method = static_cast<uint8_t>(compressed[0]);
+    CHECK(method >= static_cast<uint8_t>(CompressionMethod::Lz77) && method <= static_cast<uint8_t>(CompressionMethod::Rle));
+}
+
+// длины серий и совпадений на границах кодирования
+void testBoundaries() {
+    for (size_t run = 1; run <= 300; run++) {
+        std::string input = "xy" + std::string(run, 'r') + "zw" + std::string(run, 's') + "0123456789";
+        std::string compressed;
+        if (Compressor::compress(input, compressed)) {
+            std::string restored;
+            CHECK(Compressor::decompress(compressed, restored) && restored == input);
+        }
+    }
+
+    // совпадения дальше и ближе предельного смещения LZ77 (65535)
+    std::mt19937 random(2);
+    std::string block(1000, '\0');
+    for (char& c : block) {
+        c = static_cast<char>(random());
+    }
+    std::string filler(70000, '\0');
+    for (char& c : filler) {
+        c = static_cast<char>('a' + random() % 26);
+    }
+    CHECK(roundTrips(block + filler + block + block, true));
+}
+
+void testMixedRandom() {
+    std::mt19937 random(3);
+    for (int i = 0; i < 500; i++) {
+        std::string input;
+        size_t pieces = random() % 20 + 1;
+        for (size_t p = 0; p < pieces; p++) {
+            switch (random() % 3) {
+            case 0: input.append(random() % 100, static_cast<char>(random())); break;
+            case 1: input += input.substr(0, random() % (input.size() + 1)); break;
+            default:
+                for (size_t k = random() % 50; k > 0; k--) {
+                    input.push_back(static_cast<char>(random()));
+                }
+            }
+        }
+        std::string compressed;
+        if (Compressor::compress(input, compressed)) {
+            std::string restored;
+            CHECK(Compressor::decompress(compressed, restored) && restored == input);
+        }
+    }
+}
+
+// повреждённые блоки отвергаются, а не распаковываются во что-то другое
+void testCorruptInput() {
+    std::string restored = "unchanged";
+    CHECK(!Compressor::decompress("", restored));
+    CHECK(!Compressor::decompress(std::string(1, '\x7F') + "\x05" "abcde", restored));
+    // исходная длина больше COMPRESSION_MAX_OUTPUT
+    CHECK(!Compressor::decompress(std::string("\x01\xFF\xFF\xFF\x7F", 5), restored));
+    CHECK(restored == "unchanged");
+
+    std::string input;
+    for (int i = 0; i < 40; i++) {
+        input += "temperature=" + std::to_string(i) + " ";
+    }
+    std::string compressed;
+    CHECK(Compressor::compress(input, compressed));
+    for (size_t length = 0; length < compressed.size(); length++) {
+        CHECK(!Compressor::decompress(compressed.substr(0, length), restored));
+    }
+
+    // искажённые байты: распаковка либо отказывает, либо даёт данные заявленной длины
+    std::mt19937 random(4);
+    for (int i = 0; i < 2000; i++) {
+        std::string damaged = compressed;
+        damaged[random() % damaged.size()] ^= static_cast<char>(1 << (random() % 8));
+        std::string output;
+        if (Compressor::decompress(damaged, output)) {
+            CHECK(output.size() <= COMPRESSION_MAX_OUTPUT);
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    testShortAndIncompressible();
+    testEachMethod();
+    testBoundaries();
+    testMixedRandom();
+    testCorruptInput();
+    return TEST_RESULT();
+}
@@ -0,0 +1,122 @@
+#include "HammingBatch.h"
+#include "HammingKernel.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+using FrameKernel = HammingKernel<HAMMING_BATCH_FRAME_SIZE>;
+
+// кадры лежат в отдельных буферах, как в очереди передачи, а не подряд
+struct Frames {
+    std::vector<std::vector<uint8_t>> data;
+    std::vector<std::vector<uint8_t>> fcs;
+    std::vector<const uint8_t*> dataPointers;
+    std::vector<uint8_t*> fcsPointers;
+
+    Frames(std::mt19937& random, size_t count) : data(count), fcs(count) {
+        for (size_t f = 0; f < count; f++) {
+            data[f].resize(HAMMING_BATCH_FRAME_SIZE);
+            for (uint8_t& byte : data[f]) {
+                // часть кадров - крайние случаи: нули, единицы, один установленный бит
+                switch (f % 8) {
+                case 0: byte = 0; break;
+                case 1: byte = 0xFF; break;
+                default: byte = static_cast<uint8_t>(random());
+                }
+            }
+            if (f % 8 == 2) {
+                std::fill(data[f].begin(), data[f].end(), 0);
+                data[f][random() % HAMMING_BATCH_FRAME_SIZE] = static_cast<uint8_t>(1 << (random() % 8));
+            }
+            fcs[f].assign(HAMMING_BATCH_FCS_SIZE, 0xAA);
+            dataPointers.push_back(data[f].data());
+            fcsPointers.push_back(fcs[f].data());
+        }
+    }
+
+    const uint8_t* const* fcsView() const { return fcsPointers.data(); }
+};
+
+// число кадров вокруг границ группы HAMMING_BATCH_GROUP
+const size_t COUNTS[] = {0, 1, 2, HAMMING_BATCH_GROUP - 1, HAMMING_BATCH_GROUP, HAMMING_BATCH_GROUP + 1,
+                         2 * HAMMING_BATCH_GROUP + 5, 500};
+
+void checkEncodeMatchesKernel() {
+    std::mt19937 random(1);
+    for (size_t count : COUNTS) {
+        Frames frames(random, count);
+        HammingBatch::encode(frames.dataPointers.data(), frames.fcsPointers.data(), count);
+
+        bool same = true;
+        for (size_t f = 0; f < count; f++) {
+            uint8_t expected[FrameKernel::FCS_SIZE];
+            FrameKernel::encode(frames.data[f].data(), expected);
+            same = same && std::equal(expected, expected + FrameKernel::FCS_SIZE, frames.fcs[f].begin());
+        }
+        CHECK(same);
+    }
+}
+
+void checkVerifyFindsMismatches() {
+    std::mt19937 random(2);
+    for (size_t count : COUNTS) {
+        Frames frames(random, count);
+        HammingBatch::encode(frames.dataPointers.data(), frames.fcsPointers.data(), count);
+
+        std::vector<uint8_t> mismatch(count + 1, 0x55);
+        CHECK(HammingBatch::verify(frames.dataPointers.data(), frames.fcsView(), count, mismatch.data()) == 0);
+        bool clean = true;
+        for (size_t f = 0; f < count; f++) {
+            clean = clean && mismatch[f] == 0;
+        }
+        CHECK(clean);
+        CHECK(mismatch[count] == 0x55);
+
+        // искажается каждый третий кадр: бит данных или бит fcs
+        std::vector<uint8_t> expected(count, 0);
+        size_t damaged = 0;
+        for (size_t f = 0; f < count; f += 3) {
+            if (f % 2 == 0) {
+                frames.data[f][random() % HAMMING_BATCH_FRAME_SIZE] ^= static_cast<uint8_t>(1 << (random() % 8));
+            } else {
+                frames.fcs[f][random() % HAMMING_BATCH_FCS_SIZE] ^= static_cast<uint8_t>(1 << (random() % 8));
+            }
+            expected[f] = 1;
+            damaged++;
+        }
+
+        CHECK(HammingBatch::verify(frames.dataPointers.data(), frames.fcsView(), count, mismatch.data()) == damaged);
+        mismatch.resize(count);
+        CHECK(mismatch == expected);
+
+        // кадры с искажённым битом данных исправляются по fcs, рассчитанному пакетом
+        bool corrected = true;
+        for (size_t f = 0; f < count; f += 6) {
+            corrected = corrected && FrameKernel::correct(frames.data[f].data(), frames.fcs[f].data()) == 1;
+        }
+        CHECK(corrected);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cerr << "пакетное ядро: " << HammingBatch::implementationName() << std::endl;
+    checkEncodeMatchesKernel();
+    checkVerifyFindsMismatches();
+
+    // вариант без AVX2 проверяется всегда, даже если процессор поддерживает AVX2
+    bool accelerated = HammingBatch::isAccelerated();
+    HammingBatch::setAccelerationEnabled(false);
+    CHECK(!HammingBatch::isAccelerated());
+    checkEncodeMatchesKernel();
+    checkVerifyFindsMismatches();
+    HammingBatch::setAccelerationEnabled(true);
+    CHECK(HammingBatch::isAccelerated() == accelerated);
+
+    return TEST_RESULT();
+}
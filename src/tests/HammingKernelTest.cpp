@@ -0,0 +1,171 @@
+#include "ByteStuffer.h"
+#include "ChannelManager.h"
+#include "Frame.h"
+#include "HammingEncoder.h"
+#include "HammingKernel.h"
+#include "TestCheck.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+using FrameStuffer = ByteStuffer<START_FLAG_BYTE, END_FLAG_BYTE, ESCAPE_BYTE, XOR_MASK, JAM_SIGNAL_BYTE>;
+
+// эталон по определению: XOR позиций единичных битов и общая чётность, побитово
+std::vector<uint8_t> referenceFcs(const uint8_t* data, size_t length) {
+    uint32_t positions = 0;
+    uint32_t ones = 0;
+    for (size_t bit = 0; bit < length * 8; bit++) {
+        if (data[bit / 8] & (0x80 >> (bit % 8))) {
+            positions ^= static_cast<uint32_t>(bit + 1);
+            ones ^= 1;
+        }
+    }
+
+    size_t controlBitCount = hammingControlBitCount(length);
+    std::vector<uint8_t> fcs(hammingFcsSize(length));
+    hammingPackFcs(positions, ones ^ hammingParity64(positions), controlBitCount, fcs.data(), fcs.size());
+    return fcs;
+}
+
+std::vector<uint8_t> randomBytes(std::mt19937& random, size_t length) {
+    std::vector<uint8_t> data(length);
+    for (uint8_t& byte : data) {
+        byte = static_cast<uint8_t>(random());
+    }
+    return data;
+}
+
+// ядро для длины N совпадает с эталоном и общим путём HammingEncoder, исправляет
+// любую одиночную ошибку в данных и обнаруживает двойную
+template <size_t N>
+void checkKernel(std::mt19937& random) {
+    using Kernel = HammingKernel<N>;
+    CHECK(Kernel::FCS_SIZE == HammingEncoder::fcsSize(N));
+
+    for (int round = 0; round < 20; round++) {
+        std::vector<uint8_t> data = randomBytes(random, N);
+        if (round == 0) {
+            std::fill(data.begin(), data.end(), 0);
+        } else if (round == 1) {
+            std::fill(data.begin(), data.end(), 0xFF);
+        }
+
+        uint8_t fcs[Kernel::FCS_SIZE];
+        Kernel::encode(data.data(), fcs);
+        CHECK(std::vector<uint8_t>(fcs, fcs + Kernel::FCS_SIZE) == referenceFcs(data.data(), N));
+        CHECK(HammingEncoder::calculateControlBits(data) == referenceFcs(data.data(), N));
+
+        std::vector<uint8_t> damaged = data;
+        CHECK(Kernel::correct(damaged.data(), fcs) == 0 && damaged == data);
+
+        for (size_t bit = 0; bit < N * 8; bit++) {
+            damaged[bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+            std::vector<uint8_t> viaEncoder = damaged;
+            CHECK(HammingEncoder::correctErrors(viaEncoder, referenceFcs(data.data(), N)) == 1 && viaEncoder == data);
+            CHECK(Kernel::correct(damaged.data(), fcs) == 1 && damaged == data);
+        }
+
+        if (N * 8 >= 2) {
+            size_t first = random() % (N * 8);
+            size_t second = (first + 1 + random() % (N * 8 - 1)) % (N * 8);
+            damaged[first / 8] ^= static_cast<uint8_t>(0x80 >> (first % 8));
+            damaged[second / 8] ^= static_cast<uint8_t>(0x80 >> (second % 8));
+            CHECK(Kernel::correct(damaged.data(), fcs) == 2);
+        }
+    }
+}
+
+void testKernels() {
+    std::mt19937 random(1);
+    checkKernel<1>(random);
+    checkKernel<2>(random);
+    checkKernel<7>(random);
+    checkKernel<8>(random);
+    checkKernel<9>(random);
+    checkKernel<31>(random);
+    checkKernel<FRAME_DATA_SIZE - 1>(random);
+    checkKernel<FRAME_DATA_SIZE>(random);
+    checkKernel<FRAME_DATA_SIZE + 1>(random);
+}
+
+// общий путь для всех длин последнего кадра
+void testEncoderLengths() {
+    std::mt19937 random(2);
+    for (size_t length = 1; length <= 2 * FRAME_DATA_SIZE; length++) {
+        std::vector<uint8_t> data = randomBytes(random, length);
+        std::vector<uint8_t> fcs = HammingEncoder::calculateControlBits(data);
+        CHECK(fcs == referenceFcs(data.data(), length));
+        CHECK(HammingEncoder::verifyDataWithControlBits(data, fcs));
+
+        std::vector<uint8_t> damaged = data;
+        size_t bit = random() % (length * 8);
+        damaged[bit / 8] ^= static_cast<uint8_t>(0x80 >> (bit % 8));
+        CHECK(!HammingEncoder::verifyDataWithControlBits(damaged, fcs));
+        CHECK(HammingEncoder::correctErrors(damaged, fcs) == 1 && damaged == data);
+    }
+
+    std::vector<uint8_t> empty;
+    CHECK(HammingEncoder::correctErrors(empty, {}) == -1);
+}
+
+void testStuffer() {
+    const uint8_t special[] = {START_FLAG_BYTE, END_FLAG_BYTE, ESCAPE_BYTE, JAM_SIGNAL_BYTE};
+    for (int byte = 0; byte < 256; byte++) {
+        bool expected = std::memchr(special, byte, sizeof(special)) != nullptr;
+        CHECK(FrameStuffer::needsEscape(static_cast<uint8_t>(byte)) == expected);
+    }
+
+    std::mt19937 random(3);
+    for (size_t length = 0; length <= 300; length++) {
+        std::vector<uint8_t> data = randomBytes(random, length);
+        // половина байтов - служебные, чтобы экранирование шло подряд
+        for (size_t i = 0; i < length; i += 2) {
+            data[i] = special[random() % sizeof(special)];
+        }
+
+        std::vector<char> stuffed(FrameStuffer::maxStuffedSize(length));
+        size_t stuffedLength = FrameStuffer::stuff(data.data(), length, stuffed.data());
+        CHECK(stuffedLength == FrameStuffer::stuffedSize(data.data(), length));
+        CHECK(stuffedLength <= FrameStuffer::maxStuffedSize(length));
+
+        // после стаффинга в кадре нет флагов и байтов jam-сигнала
+        bool clean = true;
+        for (size_t i = 0; i < stuffedLength; i++) {
+            uint8_t byte = static_cast<uint8_t>(stuffed[i]);
+            clean = clean && byte != START_FLAG_BYTE && byte != END_FLAG_BYTE && byte != JAM_SIGNAL_BYTE;
+        }
+        CHECK(clean);
+
+        std::vector<uint8_t> restored(stuffedLength);
+        size_t restoredLength = FrameStuffer::unstuff(stuffed.data(), stuffedLength, restored.data());
+        restored.resize(restoredLength);
+        CHECK(restored == data);
+    }
+
+    // развёрнутый вариант для полного кадра пишет то же самое
+    std::vector<uint8_t> frame = randomBytes(random, FRAME_DATA_SIZE);
+    frame[0] = ESCAPE_BYTE;
+    frame[FRAME_DATA_SIZE - 1] = END_FLAG_BYTE;
+    std::vector<char> loop(FrameStuffer::maxStuffedSize(FRAME_DATA_SIZE));
+    std::vector<char> unrolled(FrameStuffer::maxStuffedSize(FRAME_DATA_SIZE));
+    size_t loopLength = FrameStuffer::stuff(frame.data(), FRAME_DATA_SIZE, loop.data());
+    CHECK(FrameStuffer::stuffFixed<FRAME_DATA_SIZE>(frame.data(), unrolled.data()) == loopLength);
+    CHECK(std::memcmp(loop.data(), unrolled.data(), loopLength) == 0);
+
+    // висящий в конце ESCAPE отбрасывается
+    const char truncated[] = {'a', static_cast<char>(ESCAPE_BYTE)};
+    uint8_t out[2];
+    CHECK(FrameStuffer::unstuff(truncated, 2, out) == 1 && out[0] == 'a');
+}
+
+} // namespace
+
+int main() {
+    testKernels();
+    testEncoderLengths();
+    testStuffer();
+    return TEST_RESULT();
+}
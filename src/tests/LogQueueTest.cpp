@@ -0,0 +1,132 @@
+#include "LogQueue.h"
+#include "TestCheck.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void testOrderAndFields() {
+    LogQueue queue;
+    CHECK(queue.push(LogEvent::FrameSent, false, 1, 2, 3));
+    CHECK(queue.push(LogEvent::Text, true, "abc", 3));
+
+    LogRecord record;
+    CHECK(queue.pop(record));
+    CHECK(record.event == LogEvent::FrameSent);
+    CHECK(!record.isIncoming);
+    CHECK(record.args[0] == 1 && record.args[1] == 2 && record.args[2] == 3);
+    CHECK(record.textLength == 0);
+
+    CHECK(queue.pop(record));
+    CHECK(record.event == LogEvent::Text);
+    CHECK(record.isIncoming);
+    CHECK(std::string(record.text, record.textLength) == "abc");
+    CHECK(!record.isTruncated);
+
+    CHECK(!queue.pop(record));
+}
+
+void testTruncation() {
+    LogQueue queue;
+    LogRecord record;
+
+    std::string exact(LOG_TEXT_SIZE, 'x');
+    CHECK(queue.push(LogEvent::Text, false, exact.data(), exact.size()));
+    CHECK(queue.pop(record));
+    CHECK(record.textLength == LOG_TEXT_SIZE && !record.isTruncated);
+
+    // длинный текст обрезается, но не посреди символа UTF-8 ("ж" - два байта)
+    std::string utf8 = std::string(LOG_TEXT_SIZE - 1, 'x') + "жжж";
+    CHECK(queue.push(LogEvent::Text, false, utf8.data(), utf8.size()));
+    CHECK(queue.pop(record));
+    CHECK(record.isTruncated);
+    CHECK(record.textLength == LOG_TEXT_SIZE - 1);
+
+    // данные кадров однобайтовые (Windows-1251) - режутся ровно по LOG_TEXT_SIZE
+    CHECK(queue.push(LogEvent::FrameReceived, true, utf8.data(), utf8.size()));
+    CHECK(queue.pop(record));
+    CHECK(record.isTruncated);
+    CHECK(record.textLength == LOG_TEXT_SIZE);
+}
+
+void testOverflowAndWraparound() {
+    LogQueue queue;
+    LogRecord record;
+
+    for (int i = 0; i < LOG_QUEUE_CAPACITY; i++) {
+        CHECK(queue.push(LogEvent::FrameSent, false, i));
+    }
+    CHECK(!queue.push(LogEvent::FrameSent, false, -1));
+    CHECK(!queue.push(LogEvent::FrameSent, false, -1));
+    CHECK(queue.takeDroppedCount() == 2);
+    CHECK(queue.takeDroppedCount() == 0);
+
+    for (int i = 0; i < LOG_QUEUE_CAPACITY; i++) {
+        CHECK(queue.pop(record) && record.args[0] == i);
+    }
+    CHECK(!queue.pop(record));
+
+    // несколько оборотов кольца по одной записи
+    for (int i = 0; i < 3 * LOG_QUEUE_CAPACITY; i++) {
+        CHECK(queue.push(LogEvent::FrameSent, false, i));
+        CHECK(queue.pop(record) && record.args[0] == i);
+    }
+}
+
+// несколько производителей и один потребитель: каждая запись либо принята ровно один раз,
+// либо учтена как отброшенная, а записи одного производителя приходят в порядке отправки
+void testManyProducers() {
+    const int producers = 4;
+    const int perProducer = 50000;
+
+    LogQueue queue;
+    std::atomic<int> finished{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, &finished, p]() {
+            for (int i = 0; i < perProducer; i++) {
+                queue.push(LogEvent::FrameSent, false, p, i);
+            }
+            finished++;
+        });
+    }
+
+    std::vector<int> last(producers, -1);
+    uint64_t popped = 0;
+    bool ordered = true;
+    LogRecord record;
+    auto drain = [&]() {
+        while (queue.pop(record)) {
+            int p = record.args[0];
+            ordered = ordered && p >= 0 && p < producers && record.args[1] > last[p];
+            if (p >= 0 && p < producers) {
+                last[p] = record.args[1];
+            }
+            popped++;
+        }
+    };
+
+    while (finished < producers) {
+        drain();
+    }
+    drain();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(ordered);
+    CHECK(popped + queue.takeDroppedCount() == static_cast<uint64_t>(producers) * perProducer);
+}
+
+} // namespace
+
+int main() {
+    testOrderAndFields();
+    testTruncation();
+    testOverflowAndWraparound();
+    testManyProducers();
+    return TEST_RESULT();
+}
@@ -0,0 +1,98 @@
+#include "ChannelManager.h"
+#include "TestCheck.h"
+
+#include <string>
+
+namespace {
+
+bool sameProfile(const MacProfile& a, const MacProfile& b) {
+    return a.persistence == b.persistence && a.probability == b.probability && a.backoff == b.backoff &&
+           a.backoffLimit == b.backoffLimit && a.slotTimeBits == b.slotTimeBits && a.maxAttempts == b.maxAttempts &&
+           a.collisionProbability == b.collisionProbability;
+}
+
+// имя разбирается обратно в тот же профиль
+bool roundTrips(const MacProfile& profile) {
+    MacProfile parsed;
+    return MacProfile::parse(profile.name(), parsed) && sameProfile(parsed, profile);
+}
+
+void checkDefaults() {
+    MacProfile profile;
+    profile.probability = 0.0;
+    CHECK(MacProfile::parse("1-persistent", profile));
+    CHECK(sameProfile(profile, MacProfile()));
+    CHECK(profile.name() == "1-persistent");
+
+    CHECK(MacProfile::parse("p-persistent", profile));
+    CHECK(profile.persistence == PersistenceMode::PPersistent && profile.probability == 0.5);
+    CHECK(profile.name() == "p-persistent:0.5");
+}
+
+void checkOptions() {
+    MacProfile profile;
+    CHECK(MacProfile::parse("non-persistent,slot:128,attempts:5,limit:4", profile));
+    CHECK(profile.persistence == PersistenceMode::NonPersistent);
+    CHECK(profile.slotTimeBits == 128);
+    CHECK(profile.maxAttempts == 5);
+    CHECK(profile.backoffLimit == 4);
+    CHECK(profile.backoff == BackoffPolicy::BinaryExponential);
+    CHECK(profile.name() == "non-persistent,slot:128,attempts:5,limit:4");
+
+    // порядок опций не важен, имя - в одном виде
+    CHECK(MacProfile::parse("p-persistent:0.25,limit:0,collision:0.1,linear,attempts:1", profile));
+    CHECK(profile.probability == 0.25 && profile.backoff == BackoffPolicy::Linear);
+    CHECK(profile.backoffLimit == 0 && profile.maxAttempts == 1 && profile.collisionProbability == 0.1);
+    CHECK(profile.name() == "p-persistent:0.25,linear,collision:0.1,attempts:1,limit:0");
+
+    // значения по умолчанию в имя не попадают
+    CHECK(MacProfile::parse("1-persistent,slot:" + std::to_string(SLOT_TIME_BITS) + ",constant", profile));
+    CHECK(profile.name() == "1-persistent,constant");
+}
+
+void checkRoundTrips() {
+    MacProfile profile;
+    CHECK(roundTrips(profile));
+    profile.persistence = PersistenceMode::PPersistent;
+    profile.probability = 0.125;
+    CHECK(roundTrips(profile));
+    profile.backoff = BackoffPolicy::Constant;
+    profile.slotTimeBits = 1;
+    CHECK(roundTrips(profile));
+    profile.maxAttempts = MAC_MAX_ATTEMPTS;
+    profile.backoffLimit = MAC_MAX_BACKOFF_LIMIT;
+    CHECK(roundTrips(profile));
+    profile.collisionProbability = 0.0;
+    profile.slotTimeBits = MAC_MAX_SLOT_TIME_BITS;
+    CHECK(roundTrips(profile));
+}
+
+void checkInvalid() {
+    // неверное имя или параметр не меняют профиль
+    MacProfile profile;
+    CHECK(MacProfile::parse("non-persistent,slot:64", profile));
+    const char* invalid[] = {
+        "", "2-persistent", "p-persistent:0", "p-persistent:1.5",
+        "1-persistent,slot:", "1-persistent,slot:0", "1-persistent,slot:-5", "1-persistent,slot:12x",
+        "1-persistent,attempts:0", "1-persistent,limit:-1", "1-persistent,limit:31",
+        "1-persistent,slot:99999999999999999999", "1-persistent,collision:1", "1-persistent,slots:10",
+    };
+    for (const char* text : invalid) {
+        bool parsed = MacProfile::parse(text, profile);
+        if (parsed) {
+            std::cerr << "разобрано неверное имя: \"" << text << "\"" << std::endl;
+        }
+        CHECK(!parsed);
+    }
+    CHECK(profile.persistence == PersistenceMode::NonPersistent && profile.slotTimeBits == 64);
+}
+
+} // namespace
+
+int main() {
+    checkDefaults();
+    checkOptions();
+    checkRoundTrips();
+    checkInvalid();
+    return TEST_RESULT();
+}
@@ -0,0 +1,237 @@
+#include "Frame.h"
+#include "MessageReassembler.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = MessageReassembler::Clock;
+
+std::string makeMessage(std::mt19937& random, size_t length) {
+    std::string message(length, '\0');
+    for (char& c : message) {
+        c = static_cast<char>(random());
+    }
+    return message;
+}
+
+uint8_t frameCount(const std::string& message) {
+    return static_cast<uint8_t>((message.size() + FRAME_DATA_SIZE - 1) / FRAME_DATA_SIZE);
+}
+
+ReassemblyResult sendFrame(MessageReassembler& reassembler, const std::string& message, uint8_t sequence, uint8_t flags,
+                           Clock::time_point now, ReassembledMessage& completed) {
+    size_t offset = static_cast<size_t>(sequence - 1) * FRAME_DATA_SIZE;
+    size_t length = std::min<size_t>(FRAME_DATA_SIZE, message.size() - offset);
+    return reassembler.accept(sequence, frameCount(message), flags, message.data() + offset, length, now, completed);
+}
+
+// кадры в любом порядке собираются в исходное сообщение, включая неполный последний кадр
+void testAnyOrder() {
+    std::mt19937 random(1);
+    MessageReassembler reassembler;
+    Clock::time_point now = Clock::now();
+
+    for (int round = 0; round < 300; round++) {
+        std::string message = makeMessage(random, 1 + random() % (20 * FRAME_DATA_SIZE));
+        uint8_t total = frameCount(message);
+        uint8_t flags = static_cast<uint8_t>(random());
+
+        std::vector<uint8_t> order(total);
+        std::iota(order.begin(), order.end(), 1);
+        std::shuffle(order.begin(), order.end(), random);
+
+        ReassembledMessage completed;
+        bool ok = true;
+        for (size_t i = 0; i < order.size(); i++) {
+            ReassemblyResult result = sendFrame(reassembler, message, order[i], flags, now, completed);
+            ok = ok && result == (i + 1 < order.size() ? ReassemblyResult::Accepted : ReassemblyResult::Completed);
+        }
+        CHECK(ok);
+        CHECK(completed.data == message);
+        CHECK(completed.flags == flags && completed.total == total);
+        CHECK(reassembler.activeCount() == 0 && reassembler.memoryUsed() == 0);
+
+        reassembler.recycle(std::move(completed.data));
+    }
+    CHECK(reassembler.takeEvictedCount() == 0);
+}
+
+// сообщения с разными флагами (метка, канал) собираются независимо, вперемешку
+void testInterleaved() {
+    std::mt19937 random(2);
+    MessageReassembler reassembler;
+    Clock::time_point now = Clock::now();
+
+    std::string first = makeMessage(random, 5 * FRAME_DATA_SIZE);
+    std::string second = makeMessage(random, 3 * FRAME_DATA_SIZE + 7);
+    ReassembledMessage completed;
+    for (uint8_t sequence = 1; sequence <= 3; sequence++) {
+        CHECK(sendFrame(reassembler, first, sequence, 0x12, now, completed) == ReassemblyResult::Accepted);
+        CHECK(sendFrame(reassembler, second, sequence, 0x14, now, completed) == ReassemblyResult::Accepted);
+    }
+    CHECK(reassembler.activeCount() == 2);
+    CHECK(sendFrame(reassembler, second, 4, 0x14, now, completed) == ReassemblyResult::Completed);
+    CHECK(completed.data == second);
+    CHECK(sendFrame(reassembler, first, 4, 0x12, now, completed) == ReassemblyResult::Accepted);
+    CHECK(sendFrame(reassembler, first, 5, 0x12, now, completed) == ReassemblyResult::Completed);
+    CHECK(completed.data == first);
+}
+
+void testDuplicateAndInvalid() {
+    std::mt19937 random(3);
+    MessageReassembler reassembler;
+    Clock::time_point now = Clock::now();
+    ReassembledMessage completed;
+    const char frame[FRAME_DATA_SIZE] = {};
+
+    CHECK(reassembler.accept(1, 0, 0, frame, 1, now, completed) == ReassemblyResult::Invalid);
+    CHECK(reassembler.accept(0, 2, 0, frame, FRAME_DATA_SIZE, now, completed) == ReassemblyResult::Invalid);
+    CHECK(reassembler.accept(3, 2, 0, frame, 1, now, completed) == ReassemblyResult::Invalid);
+    CHECK(reassembler.accept(1, 1, 0, frame, FRAME_DATA_SIZE + 1, now, completed) == ReassemblyResult::Invalid);
+    CHECK(reassembler.accept(1, 2, 0, frame, FRAME_DATA_SIZE - 1, now, completed) == ReassemblyResult::Invalid);
+    CHECK(reassembler.accept(2, 2, 0, frame, 0, now, completed) == ReassemblyResult::Invalid);
+    CHECK(reassembler.activeCount() == 0);
+
+    std::string message = makeMessage(random, 3 * FRAME_DATA_SIZE);
+    CHECK(sendFrame(reassembler, message, 2, 0, now, completed) == ReassemblyResult::Accepted);
+    CHECK(sendFrame(reassembler, message, 2, 0, now, completed) == ReassemblyResult::Duplicate);
+    CHECK(sendFrame(reassembler, message, 1, 0, now, completed) == ReassemblyResult::Accepted);
+
+    // первый кадр ещё раз - новое сообщение с той же меткой, прежнее вытесняется
+    CHECK(sendFrame(reassembler, message, 1, 0, now, completed) == ReassemblyResult::Accepted);
+    CHECK(reassembler.takeEvictedCount() == 1);
+    CHECK(sendFrame(reassembler, message, 3, 0, now, completed) == ReassemblyResult::Accepted);
+    CHECK(sendFrame(reassembler, message, 2, 0, now, completed) == ReassemblyResult::Completed);
+    CHECK(completed.data == message);
+}
+
+void testTimeout() {
+    std::mt19937 random(4);
+    MessageReassembler reassembler;
+    Clock::time_point start = Clock::now();
+    ReassembledMessage completed;
+
+    std::string message = makeMessage(random, 2 * FRAME_DATA_SIZE);
+    CHECK(sendFrame(reassembler, message, 1, 0, start, completed) == ReassemblyResult::Accepted);
+
+    reassembler.expire(start + std::chrono::milliseconds(REASSEMBLY_TIMEOUT_MS));
+    CHECK(reassembler.activeCount() == 1);
+
+    // повторный первый кадр начинает сообщение заново, отсчёт таймаута - от него
+    Clock::time_point later = start + std::chrono::milliseconds(REASSEMBLY_TIMEOUT_MS);
+    CHECK(sendFrame(reassembler, message, 1, 0, later, completed) == ReassemblyResult::Accepted);
+    CHECK(reassembler.takeEvictedCount() == 1);
+    reassembler.expire(later + std::chrono::milliseconds(REASSEMBLY_TIMEOUT_MS));
+    CHECK(reassembler.activeCount() == 1);
+
+    reassembler.expire(later + std::chrono::milliseconds(REASSEMBLY_TIMEOUT_MS + 1));
+    CHECK(reassembler.activeCount() == 0 && reassembler.memoryUsed() == 0);
+    CHECK(reassembler.takeEvictedCount() == 1);
+
+    // опоздавший кадр начинает сборку заново и уже не завершает сообщение
+    CHECK(sendFrame(reassembler, message, 2, 0, later + std::chrono::seconds(10), completed) == ReassemblyResult::Accepted);
+}
+
+// при нехватке слотов или памяти вытесняется сообщение, дольше всех не получавшее кадров
+void testEviction() {
+    std::mt19937 random(5);
+    MessageReassembler reassembler;
+    Clock::time_point now = Clock::now();
+    ReassembledMessage completed;
+
+    std::vector<std::string> messages;
+    for (int i = 0; i <= REASSEMBLY_MAX_MESSAGES; i++) {
+        messages.push_back(makeMessage(random, 2 * FRAME_DATA_SIZE));
+        CHECK(sendFrame(reassembler, messages.back(), 1, static_cast<uint8_t>(i), now + std::chrono::milliseconds(i), completed)
+              == ReassemblyResult::Accepted);
+    }
+    CHECK(reassembler.activeCount() == REASSEMBLY_MAX_MESSAGES);
+    CHECK(reassembler.takeEvictedCount() == 1);
+
+    Clock::time_point later = now + std::chrono::milliseconds(100);
+    CHECK(sendFrame(reassembler, messages[1], 2, 1, later, completed) == ReassemblyResult::Completed);
+    CHECK(completed.data == messages[1]);
+    CHECK(sendFrame(reassembler, messages[0], 2, 0, later, completed) == ReassemblyResult::Accepted);
+
+    // крупные сообщения: суммарный объём буферов не выходит за лимит
+    reassembler.clear();
+    CHECK(reassembler.activeCount() == 0 && reassembler.memoryUsed() == 0);
+    CHECK(reassembler.takeEvictedCount() == 0);
+
+    const uint8_t total = 255;
+    const char frame[FRAME_DATA_SIZE] = {};
+    bool withinLimit = true;
+    for (int i = 0; i < 3 * REASSEMBLY_MAX_MESSAGES; i++) {
+        reassembler.accept(1, total, static_cast<uint8_t>(i), frame, FRAME_DATA_SIZE, now + std::chrono::milliseconds(i), completed);
+        withinLimit = withinLimit && reassembler.memoryUsed() <= REASSEMBLY_MEMORY_LIMIT;
+    }
+    CHECK(withinLimit);
+    CHECK(reassembler.activeCount() * total * FRAME_DATA_SIZE <= REASSEMBLY_MEMORY_LIMIT);
+    CHECK(reassembler.takeEvictedCount() == 3 * REASSEMBLY_MAX_MESSAGES - reassembler.activeCount());
+
+    reassembler.clear();
+    CHECK(reassembler.memoryUsed() == 0);
+}
+
+// буферы из пула (в том числе отданные получателем, любой ёмкости) учитываются по фактической
+// ёмкости, и лимит памяти соблюдается, даже если короткому сообщению достался бы крупный буфер
+void testPooledBuffers() {
+    std::mt19937 random(6);
+    MessageReassembler reassembler;
+    Clock::time_point now = Clock::now();
+    ReassembledMessage completed;
+    const char frame[FRAME_DATA_SIZE] = {};
+
+    for (size_t capacity : {size_t(REASSEMBLY_MAX_BUFFER_SIZE), size_t(4 * FRAME_DATA_SIZE), size_t(2 * REASSEMBLY_MEMORY_LIMIT)}) {
+        std::string buffer;
+        buffer.reserve(capacity);
+        reassembler.recycle(std::move(buffer));
+    }
+    // из пула берётся самый маленький подходящий буфер
+    CHECK(reassembler.accept(1, 2, 0, frame, FRAME_DATA_SIZE, now, completed) == ReassemblyResult::Accepted);
+    CHECK(reassembler.memoryUsed() >= 2 * FRAME_DATA_SIZE && reassembler.memoryUsed() < REASSEMBLY_MAX_BUFFER_SIZE);
+    reassembler.clear();
+
+    // сообщения разной длины начинаются, завершаются и вытесняются вперемешку; получатель
+    // возвращает в пул и собранные сообщения, и посторонние буферы
+    bool withinLimit = true;
+    bool accounted = true;
+    for (int round = 0; round < 5000; round++) {
+        uint8_t total = static_cast<uint8_t>(1 + random() % 255);
+        uint8_t sequence = static_cast<uint8_t>(1 + random() % total);
+        size_t length = sequence < total ? FRAME_DATA_SIZE : 1 + random() % FRAME_DATA_SIZE;
+        uint8_t flags = static_cast<uint8_t>(random() % 64);
+        now += std::chrono::milliseconds(1);
+
+        if (reassembler.accept(sequence, total, flags, frame, length, now, completed) == ReassemblyResult::Completed) {
+            reassembler.recycle(std::move(completed.data));
+        }
+        if (round % 7 == 0) {
+            std::string foreign;
+            foreign.reserve(random() % (REASSEMBLY_MEMORY_LIMIT / 2));
+            reassembler.recycle(std::move(foreign));
+        }
+        withinLimit = withinLimit && reassembler.memoryUsed() <= REASSEMBLY_MEMORY_LIMIT;
+        accounted = accounted && (reassembler.activeCount() > 0 || reassembler.memoryUsed() == 0);
+    }
+    CHECK(withinLimit);
+    CHECK(accounted);
+}
+
+} // namespace
+
+int main() {
+    testAnyOrder();
+    testInterleaved();
+    testDuplicateAndInvalid();
+    testTimeout();
+    testEviction();
+    testPooledBuffers();
+    return TEST_RESULT();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <iostream>
+
+// Проверки для ctest без сторонних библиотек: CHECK сообщает о невыполненном условии
+// и продолжает, main возвращает TEST_RESULT() - 0, если все проверки прошли.
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+} // namespace test
+
+#define CHECK(condition)                                                                          \
+    do {                                                                                          \
+        if (!(condition)) {                                                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": не выполнено: " #condition << std::endl; \
+            test::failures()++;                                                                   \
+        }                                                                                         \
+    } while (0)
+
+#define TEST_RESULT() (test::failures() == 0 ? 0 : 1)
@@ -0,0 +1,155 @@
+#include "ReceivePipeline.h"
+#include "TestCheck.h"
+#include "ThreadPool.h"
+#include "TransmitWorker.h"
+#include "VirtualSerialPort.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#define TEST_WAIT_MS 10000 // дольше этого сообщения не ждём - проверка провалена
+
+namespace {
+
+// передатчик на конце A виртуального кабеля без задержек, приёмник - на конце B
+class Link {
+public:
+    explicit Link(bool compress) : m_transmitter(m_modem.endpointA(), m_pool), m_receiver(m_pool) {
+        m_modem.endpointA().open("VCOM-A", 115200);
+        m_modem.endpointB().open("VCOM-B", 115200);
+        m_transmitter.setCompressionEnabled(compress);
+        m_receiver.setErrorSimulation(false);
+
+        VirtualSerialPort& portB = m_modem.endpointB();
+        m_receiver.start([&portB](std::string& out) { return portB.readReceived(out); },
+                         [this]() {
+                             std::lock_guard<std::mutex> lock(m_mutex);
+                             m_resultsReady = true;
+                             m_condition.notify_all();
+                         });
+        portB.startAsyncReading([this]() { m_receiver.notifyDataAvailable(); });
+        m_transmitter.start(nullptr, [this](uint64_t messageId, bool success) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_completed[messageId] = success;
+            m_condition.notify_all();
+        });
+    }
+
+    ~Link() {
+        m_transmitter.stop();
+        m_modem.endpointB().stopAsyncReading();
+        m_receiver.stop();
+    }
+
+    uint64_t submit(const std::string& message) { return m_transmitter.submit(message); }
+
+    // результат передачи сообщения; false и при таймауте
+    bool waitCompleted(uint64_t messageId) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bool done = m_condition.wait_for(lock, std::chrono::milliseconds(TEST_WAIT_MS),
+                                         [&]() { return m_completed.count(messageId) > 0; });
+        return done && m_completed[messageId];
+    }
+
+    // собирает принятые сообщения, пока их не станет count (или до таймаута)
+    std::vector<std::string> receive(size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TEST_WAIT_MS);
+        ReceiveResults results;
+        while (m_received.size() < count && std::chrono::steady_clock::now() < deadline) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait_until(lock, deadline, [&]() { return m_resultsReady; });
+                m_resultsReady = false;
+            }
+            m_receiver.takeResults(results);
+            m_received.insert(m_received.end(), results.messages.begin(), results.messages.end());
+        }
+        return m_received;
+    }
+
+private:
+    VirtualNullModem m_modem{false};
+    ThreadPool m_pool{2};
+    TransmitWorker m_transmitter;
+    ReceivePipeline m_receiver;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_resultsReady = false;
+    std::map<uint64_t, bool> m_completed;
+    std::vector<std::string> m_received;
+};
+
+std::string asciiText(size_t length) {
+    std::string text;
+    while (text.size() < length) {
+        text += "telemetry " + std::to_string(text.size() * 7919 % 100000) + "; ";
+    }
+    text.resize(length);
+    return text;
+}
+
+// Число и номер кадра - по байту: сообщение больше FRAME_MAX_COUNT кадров не передаётся
+// и сообщается как не переданное, а не уходит на линию с повторяющимися номерами
+void testFrameLimit() {
+    Link link(false);
+
+    const size_t limit = static_cast<size_t>(FRAME_MAX_COUNT) * FRAME_DATA_SIZE;
+    std::string tooLong = asciiText(limit + 1);
+    std::string longest = asciiText(limit);
+    std::string huge = asciiText(20000);
+    // 2 байта UTF-8 на символ, но один байт Windows-1251: помещается
+    std::string cyrillic;
+    while (cyrillic.size() < 2 * limit) {
+        cyrillic += "ж";
+    }
+
+    uint64_t tooLongId = link.submit(tooLong);
+    uint64_t longestId = link.submit(longest);
+    uint64_t hugeId = link.submit(huge);
+    uint64_t cyrillicId = link.submit(cyrillic);
+
+    CHECK(!link.waitCompleted(tooLongId));
+    CHECK(link.waitCompleted(longestId));
+    CHECK(!link.waitCompleted(hugeId));
+    CHECK(link.waitCompleted(cyrillicId));
+
+    std::vector<std::string> received = link.receive(2);
+    CHECK(received.size() == 2);
+    CHECK(received.size() >= 1 && received[0] == longest);
+    CHECK(received.size() >= 2 && received[1] == cyrillic);
+}
+
+// со сжатием предел проверяется после сжатия: длинное, но сжимаемое сообщение проходит,
+// а шум, который и сжатым не помещается в FRAME_MAX_COUNT кадров, - нет
+void testFrameLimitCompressed() {
+    Link link(true);
+
+    std::string huge = asciiText(20000);
+    std::mt19937 random(1);
+    std::string noise(30000, '\0');
+    for (char& c : noise) {
+        c = static_cast<char>('!' + random() % 90);
+    }
+
+    uint64_t hugeId = link.submit(huge);
+    uint64_t noiseId = link.submit(noise);
+    CHECK(link.waitCompleted(hugeId));
+    CHECK(!link.waitCompleted(noiseId));
+
+    std::vector<std::string> received = link.receive(1);
+    CHECK(received.size() == 1 && received[0] == huge);
+}
+
+} // namespace
+
+int main() {
+    testFrameLimit();
+    testFrameLimitCompressed();
+    return TEST_RESULT();
+}